@@ -1,4 +1,6 @@
 #!/bin/bash
+# Runs <count> trials of an experiment and writes one CSV row per trial.
+# Thin wrapper around the parallel trial runner (see README).
 count=10;
 outfile="log.csv";
 while getopts n:c:o: flag
@@ -13,11 +15,4 @@ done
 echo "count: $count";
 echo "filename: $filename";
 
-rm $outfile;
-
-for i in $(seq $count); do
-    output=$(argos3 -z -n -c $filename | tail -1);
-    output2=`expr match "$output" '^\([0-9]*\)'`
-    echo $output2;
-    echo $output2 >> $outfile;
-done
\ No newline at end of file
+build/embedding/trial_runner/trial_runner -c $filename -n $count -o $outfile
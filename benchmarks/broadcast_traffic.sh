@@ -0,0 +1,52 @@
+#!/bin/bash
+# Radio traffic and time to target with and without the broadcast scheduler.
+#
+# Derives two experiments from each maze experiment: "every_tick" keeps
+# the default broadcast_keepalive="1", which broadcasts the nav table on
+# every tick, and "scheduled" sets broadcast_keepalive (-k, default 10)
+# so that the table only goes out on news and keepalives (see
+# controllers/nav_common/nav_broadcast.h). Both are run
+# with the trial runner, then the mean ticks, messages per tick and wall
+# time of every experiment are printed. The derived files go to a
+# temporary directory.
+#
+# Usage: benchmarks/broadcast_traffic.sh [-n trials] [-k keepalive] [-o output.csv] [experiment.argos ...]
+count=20;
+keepalive=10;
+outfile="broadcast_traffic.csv";
+while getopts n:k:o: flag
+do
+    case "${flag}" in
+        n) count=${OPTARG};;
+        k) keepalive=${OPTARG};;
+        o) outfile=${OPTARG};;
+    esac
+done
+shift $((OPTIND - 1))
+bases=${@:-experiments/maze_*.argos}
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+experiments=()
+for base in $bases; do
+    name=$(basename "$base" .argos)
+    cp "$base" "$workdir/${name}_every_tick.argos"
+    sed -e "s/comm_range=\"\([^\"]*\)\"/comm_range=\"\1\" broadcast_keepalive=\"$keepalive\"/" \
+        "$base" > "$workdir/${name}_scheduled.argos"
+    experiments+=(-c "$workdir/${name}_every_tick.argos" -c "$workdir/${name}_scheduled.argos")
+done
+
+build/embedding/trial_runner/trial_runner "${experiments[@]}" -n $count -o $outfile || exit 1
+
+awk -F, 'NR > 1 && $12 == "ok" {
+             n[$1]++; ticks[$1] += $4; mpt[$1] += $8 / ($4 > 0 ? $4 : 1); wall[$1] += $10
+         }
+         END {
+             printf "%-45s %8s %12s %16s %10s\n", "experiment", "trials", "mean ticks", "messages/tick", "wall s"
+             fflush()
+             for(e in n) {
+                 m = split(e, p, "/")
+                 printf "%-45s %8d %12.1f %16.2f %10.2f\n", p[m], n[e], ticks[e] / n[e], mpt[e] / n[e], wall[e] / n[e] | "sort"
+             }
+         }' $outfile
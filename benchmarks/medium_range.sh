@@ -0,0 +1,62 @@
+#!/bin/bash
+# Simulation cost of enforcing comm_range in the medium or in the controllers.
+#
+# Runs a maze experiment at several swarm sizes with a short comm_range,
+# once with medium_range="false" (the RAB medium delivers every packet
+# within the physical RAB range and the controllers discard those from
+# beyond comm_range) and once with medium_range="true" (the foot-bots'
+# RAB range is cut to comm_range, so the medium never delivers them; see
+# loop_functions/nav_loop_functions/nav_loop_functions.h). Every trial is
+# stopped after the same number of ticks, then the mean wall time per
+# tick of every configuration is printed. The derived files go to a
+# temporary directory.
+#
+# Usage: benchmarks/medium_range.sh [-c base.argos] [-n trials] [-r comm_range] [-t ticks] [-o output.csv] [swarm size ...]
+base="experiments/maze_4Ls.argos";
+count=5;
+range=100;
+ticks=2000;
+outfile="medium_range.csv";
+while getopts c:n:r:t:o: flag
+do
+    case "${flag}" in
+        c) base=${OPTARG};;
+        n) count=${OPTARG};;
+        r) range=${OPTARG};;
+        t) ticks=${OPTARG};;
+        o) outfile=${OPTARG};;
+    esac
+done
+shift $((OPTIND - 1))
+sizes=${@:-"10 20 40 80 160"}
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+sweeps=()
+for mode in controller medium; do
+    if [ "$mode" = "medium" ]; then flag="true"; else flag="false"; fi
+    sed -e "s/label=\"nav_loop_functions\"/label=\"nav_loop_functions\" medium_range=\"$flag\"/" \
+        "$base" > "$workdir/${mode}_base.argos"
+    cat > "$workdir/$mode.xml" <<EOF
+<sweep base="$workdir/${mode}_base.argos">
+  <layout name="arena" arena="$workdir/${mode}_base.argos" min="-4,-4,0" max="4,4,0" />
+  <quantity values="$sizes" />
+  <parameter name="comm_range" values="$range" />
+</sweep>
+EOF
+    sweeps+=(-x "$workdir/$mode.xml")
+done
+
+build/embedding/trial_runner/trial_runner "${sweeps[@]}" -n $count -T $ticks -o $outfile || exit 1
+
+awk -F, 'NR > 1 && $12 == "ok" && $4 > 0 {
+             n[$1]++; us[$1] += 1e6 * $10 / $4
+         }
+         END {
+             printf "%-55s %8s %14s\n", "experiment", "trials", "us per tick"
+             fflush()
+             for(e in n) {
+                 printf "%-55s %8d %14.1f\n", e, n[e], us[e] / n[e] | "sort"
+             }
+         }' $outfile
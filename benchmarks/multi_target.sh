@@ -0,0 +1,65 @@
+#!/bin/bash
+# Propagation delay of the nav info of many targets, with the entries of
+# the broadcasts picked by priority or round-robin.
+#
+# Derives experiments from experiments/multi_target.argos for every
+# number of targets, with the scheduler defaults ("priority") and with
+# broadcast_priority="false" ("round_robin"); see
+# controllers/nav_common/nav_broadcast.h. All are run with the trial
+# runner, each recording the propagation of its targets, then the mean
+# ticks until a target is known to half, 90% and all of the robots are
+# printed for every experiment, with the number of targets that did not
+# reach every robot before the run ended. The derived files and the
+# propagation files go to a temporary directory.
+#
+# Usage: benchmarks/multi_target.sh [-n trials] [-o output.csv] [targets ...]
+count=10;
+outfile="multi_target.csv";
+while getopts n:o: flag
+do
+    case "${flag}" in
+        n) count=${OPTARG};;
+        o) outfile=${OPTARG};;
+    esac
+done
+shift $((OPTIND - 1))
+targets=${@:-8 24 48}
+base=experiments/multi_target.argos
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+experiments=()
+for n in $targets; do
+    for selection in priority round_robin; do
+        name="${n}_targets_${selection}"
+        extra=""
+        if [ "$selection" = "round_robin" ]; then
+            extra=" broadcast_priority=\"false\""
+        fi
+        sed -e "s/quantity=\"24\"/quantity=\"$n\"/" \
+            -e "s/comm_range=\"\([^\"]*\)\"/comm_range=\"\1\"$extra/" \
+            -e "s|propagation=\"[^\"]*\"|propagation=\"$workdir/$name.csv\"|" \
+            "$base" > "$workdir/$name.argos"
+        experiments+=(-c "$workdir/$name.argos")
+    done
+done
+
+build/embedding/trial_runner/trial_runner "${experiments[@]}" -n $count -o $outfile || exit 1
+
+# The runner suffixes every propagation file with the seed of its trial
+for n in $targets; do
+    for selection in priority round_robin; do
+        name="${n}_targets_${selection}"
+        awk -F, -v name="$name" 'FNR > 1 {
+                 n++
+                 if($4 >= 0) { half += $4; nhalf++ }
+                 if($5 >= 0) { most += $5; nmost++ }
+                 if($6 >= 0) { all += $6; nall++ } else { missing++ }
+             }
+             END {
+                 printf "%-28s %8d %12.1f %12.1f %12.1f %10d\n", name, n,
+                        nhalf ? half / nhalf : -1, nmost ? most / nmost : -1, nall ? all / nall : -1, missing
+             }' "$workdir/${name}"_*.csv
+    done
+done | (printf "%-28s %8s %12s %12s %12s %10s\n" "experiment" "samples" "half" "90%" "all" "not all"; cat)
@@ -0,0 +1,202 @@
+/*
+ * How fast the nav info of many targets spreads when the nav table does
+ * not fit in a payload, with the entries picked by priority or
+ * round-robin (see nav_broadcast.h).
+ *
+ * Robots stand on a line, each hearing its neighbours within a few
+ * places; targets are spread along the line. Every tick, each robot
+ * asks its scheduler whether to broadcast and which entries, and the
+ * neighbours merge the records as the controllers do. Reported per
+ * selection: the mean and largest number of ticks until a target is
+ * known to every robot, the mean number of ticks between a refresh of a
+ * target and the time its far end hears of it, and ns per Select().
+ *
+ * nav_broadcast_check checks what Select() picks.
+ * Usage: nav_broadcast_benchmark [robots] [targets] [slots] [ticks]
+ */
+
+#include <controllers/nav_common/nav_broadcast.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock TClock;
+
+/* Distance between neighbouring robots, in cm */
+static const Real SPACING = 30.0;
+
+/* Robots on each side a robot hears */
+static const size_t HEARING = 3;
+
+/* Priorities, as the controllers default them */
+static const Real FRESHNESS = 100.0;
+static const Real IMPROVEMENT = 1.0;
+static const Real AGE = 10.0;
+
+/* A record on the air */
+struct SRecord {
+   UInt8 Target;
+   UInt32 SequenceNumber;
+   float Distance;
+};
+
+/* Results of a run */
+struct SResult {
+   Real MeanKnownByAll;
+   UInt32 MaxKnownByAll;
+   Real MeanRefreshDelay;
+   Real SelectNs;
+   size_t Unknown;
+};
+
+/****************************************/
+/****************************************/
+
+/* Runs the line of robots; targets are the robots at evenly spaced places */
+static SResult RunLine(size_t un_robots,
+                       size_t un_targets,
+                       size_t un_slots,
+                       UInt32 un_ticks,
+                       bool b_priority) {
+   std::vector<CNavTable> vecTables(un_robots);
+   std::vector<CBroadcastScheduler> vecSchedulers(un_robots);
+   std::vector<SInt32> vecTargetOf(un_robots, -1);
+   for(size_t i = 0; i < un_robots; ++i) {
+      vecSchedulers[i].Init(1, 10, 1.0);
+      vecSchedulers[i].SetPriorities(b_priority, FRESHNESS, IMPROVEMENT, AGE);
+   }
+   for(size_t t = 0; t < un_targets; ++t) {
+      size_t unRobot = (t * un_robots) / un_targets + un_robots / (2 * un_targets);
+      vecTargetOf[unRobot] = t;
+      NavTableEntry sEntry = { 0, 0.0f, 0.0f };
+      vecTables[unRobot].Insert(t, sEntry);
+   }
+   std::vector<std::vector<SRecord> > vecOnAir(un_robots);
+   std::vector<size_t> vecEntries(CNavTable::CAPACITY);
+   std::vector<UInt32> vecKnownByAll(un_targets, 0);
+   /* Tick each sequence number of each target was issued at, to time refreshes */
+   std::vector<std::vector<UInt32> > vecIssued(un_targets, std::vector<UInt32>(1, 0));
+   /* Sequence number of each target last seen at the two ends of the line */
+   std::vector<UInt32> vecSeenFirst(un_targets, 0), vecSeenLast(un_targets, 0);
+   Real fRefreshDelay = 0.0;
+   size_t unRefreshes = 0;
+   std::chrono::duration<double, std::nano> tSelect(0);
+   size_t unSelects = 0;
+   for(UInt32 unTick = 1; unTick <= un_ticks; ++unTick) {
+      /* Broadcast */
+      for(size_t i = 0; i < un_robots; ++i) {
+         vecOnAir[i].clear();
+         CNavTable& cTable = vecTables[i];
+         CBroadcastScheduler& cScheduler = vecSchedulers[i];
+         if(!cScheduler.Tick(cTable.Size() > un_slots)) continue;
+         if(vecTargetOf[i] >= 0) {
+            cTable.IncrementSequenceNumber(vecTargetOf[i]);
+            vecIssued[vecTargetOf[i]].push_back(unTick);
+         }
+         if(cTable.Empty()) continue;
+         TClock::time_point tStart = TClock::now();
+         size_t unCount = cScheduler.Select(cTable, un_slots, &vecEntries[0]);
+         tSelect += TClock::now() - tStart;
+         ++unSelects;
+         for(size_t j = 0; j < unCount; ++j) {
+            NavTableEntry sEntry = cTable.GetEntry(vecEntries[j]);
+            SRecord sRecord = { cTable.GetTarget(vecEntries[j]), sEntry.sequence_number, sEntry.distance };
+            vecOnAir[i].push_back(sRecord);
+         }
+         cScheduler.OnSent(cTable, &vecEntries[0], unCount);
+      }
+      /* Receive, merging as CNavigationController::ReceiveNavInfo() does */
+      for(size_t i = 0; i < un_robots; ++i) {
+         size_t unFrom = (i > HEARING) ? i - HEARING : 0;
+         size_t unTo = std::min(un_robots - 1, i + HEARING);
+         for(size_t j = unFrom; j <= unTo; ++j) {
+            if(j == i) continue;
+            Real fRange = SPACING * ((j > i) ? j - i : i - j);
+            for(size_t k = 0; k < vecOnAir[j].size(); ++k) {
+               const SRecord& sRecord = vecOnAir[j][k];
+               float fComputed = fRange + sRecord.Distance;
+               NavTableEntry sKnown;
+               bool bKnown = vecTables[i].Find(sRecord.Target, sKnown);
+               if(!bKnown || (fComputed < sKnown.distance && sRecord.SequenceNumber >= sKnown.sequence_number)) {
+                  if(bKnown) {
+                     vecSchedulers[i].OnImprovement(sKnown.distance - fComputed);
+                  }
+                  else {
+                     vecSchedulers[i].OnNewTarget();
+                  }
+                  NavTableEntry sEntry = { sRecord.SequenceNumber, fComputed, 0.0f };
+                  vecTables[i].Insert(sRecord.Target, sEntry);
+               }
+            }
+         }
+      }
+      /* Propagation */
+      for(size_t t = 0; t < un_targets; ++t) {
+         if(vecKnownByAll[t] == 0) {
+            size_t unKnown = 0;
+            for(size_t i = 0; i < un_robots; ++i) {
+               unKnown += vecTables[i].Contains(t);
+            }
+            if(unKnown == un_robots) {
+               vecKnownByAll[t] = unTick;
+            }
+         }
+         /* Fresher sequence numbers reaching the ends of the line */
+         NavTableEntry sEntry;
+         UInt32* punSeen[2] = { &vecSeenFirst[t], &vecSeenLast[t] };
+         const CNavTable* pcEnds[2] = { &vecTables[0], &vecTables[un_robots - 1] };
+         for(size_t e = 0; e < 2; ++e) {
+            if(pcEnds[e]->Find(t, sEntry) && sEntry.sequence_number > *punSeen[e]) {
+               *punSeen[e] = sEntry.sequence_number;
+               fRefreshDelay += unTick - vecIssued[t][sEntry.sequence_number];
+               ++unRefreshes;
+            }
+         }
+      }
+   }
+   SResult sResult = { 0.0, 0, 0.0, 0.0, 0 };
+   for(size_t t = 0; t < un_targets; ++t) {
+      if(vecKnownByAll[t] == 0) {
+         ++sResult.Unknown;
+         continue;
+      }
+      sResult.MeanKnownByAll += vecKnownByAll[t];
+      sResult.MaxKnownByAll = std::max(sResult.MaxKnownByAll, vecKnownByAll[t]);
+   }
+   if(sResult.Unknown < un_targets) {
+      sResult.MeanKnownByAll /= un_targets - sResult.Unknown;
+   }
+   sResult.MeanRefreshDelay = (unRefreshes > 0) ? fRefreshDelay / unRefreshes : 0.0;
+   sResult.SelectNs = (unSelects > 0) ? tSelect.count() / unSelects : 0.0;
+   return sResult;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   size_t unRobots = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 200;
+   size_t unTargets = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 48;
+   size_t unSlots = (argc > 3) ? std::strtoul(argv[3], NULL, 10) : 10;
+   UInt32 unTicks = (argc > 4) ? std::strtoul(argv[4], NULL, 10) : 1000;
+   if(unTargets == 0 || unTargets > CNavTable::CAPACITY || unRobots < unTargets || unSlots < 2 || unTicks == 0) {
+      std::printf("need 1 <= targets <= %zu, robots >= targets, slots >= 2 and ticks > 0\n", CNavTable::CAPACITY);
+      return 1;
+   }
+   std::printf("%zu robots on a line, %zu targets, %zu records per payload, %u ticks\n",
+               unRobots, unTargets, unSlots, unTicks);
+   std::printf("%-12s %16s %15s %15s %12s\n", "selection", "known by all", "slowest target", "refresh delay", "ns/select");
+   for(int nPriority = 1; nPriority >= 0; --nPriority) {
+      SResult sResult = RunLine(unRobots, unTargets, unSlots, unTicks, nPriority != 0);
+      std::printf("%-12s %16.1f %15u %15.1f %12.1f\n",
+                  nPriority ? "priority" : "round-robin",
+                  sResult.MeanKnownByAll, sResult.MaxKnownByAll,
+                  sResult.MeanRefreshDelay, sResult.SelectNs);
+      if(sResult.Unknown > 0) {
+         std::printf("%zu targets never reached every robot\n", sResult.Unknown);
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,200 @@
+/*
+ * Regression check of the entries the broadcast scheduler picks (see
+ * nav_broadcast.h), for a few payload sizes: a table that fits goes out
+ * whole; otherwise Select() picks as many distinct entries as there are
+ * slots, in target order, ties going to the lowest target id; with some
+ * entries always fresh, the others must still go out every few ticks,
+ * by priority and round-robin. A broadcast_budget smaller than a record
+ * must be refused. Exits with 1 on a mismatch, so that ctest can run it.
+ * Usage: nav_broadcast_check
+ */
+
+#include <controllers/nav_common/nav_broadcast.h>
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <cstdio>
+#include <vector>
+
+/* Records per payload the checks run with */
+static const size_t CHECK_SLOTS[] = { 2, 5, 10 };
+
+/* Priorities, as the controllers default them */
+static const Real FRESHNESS = 100.0;
+static const Real IMPROVEMENT = 1.0;
+static const Real AGE = 10.0;
+
+/****************************************/
+/****************************************/
+
+/* A table that fits goes out whole, in target order; returns the number of failed checks */
+static size_t CheckWhole(size_t un_slots) {
+   std::vector<size_t> vecEntries(CNavTable::CAPACITY);
+   CNavTable cTable;
+   CBroadcastScheduler cScheduler;
+   for(size_t t = 0; t < un_slots; ++t) {
+      NavTableEntry sEntry = { 1, 10.0f * t, 0.0f };
+      cTable.Insert(200 - 3 * t, sEntry);
+   }
+   cScheduler.Tick(false);
+   size_t unCount = cScheduler.Select(cTable, un_slots, &vecEntries[0]);
+   bool bOk = (unCount == un_slots);
+   for(size_t i = 0; bOk && i < unCount; ++i) {
+      bOk = (vecEntries[i] == i);
+   }
+   if(!bOk) {
+      std::printf("%zu slots: a table that fits did not go out whole\n", un_slots);
+      return 1;
+   }
+   return 0;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * A table that does not fit: distinct entries, in target order, and
+ * entries always fresh don't starve the others. Returns the number of
+ * failed checks.
+ */
+static size_t CheckRotation(size_t un_slots) {
+   size_t unFailures = 0;
+   std::vector<size_t> vecEntries(CNavTable::CAPACITY);
+   for(int nPriority = 0; nPriority < 2; ++nPriority) {
+      size_t unEntries = 6 * un_slots + 1;
+      size_t unFresh = std::max<size_t>(un_slots / 2, 1);
+      CNavTable cTable;
+      CBroadcastScheduler cScheduler;
+      cScheduler.SetPriorities(nPriority != 0, FRESHNESS, IMPROVEMENT, AGE);
+      for(size_t t = 0; t < unEntries; ++t) {
+         NavTableEntry sEntry = { 1, 100.0f + t, 0.0f };
+         cTable.Insert(t, sEntry);
+      }
+      std::vector<UInt32> vecLastSent(unEntries, 0);
+      UInt32 unMaxGap = 0;
+      bool bOk = true;
+      for(UInt32 unTick = 1; unTick <= 1000; ++unTick) {
+         for(size_t t = 0; t < unFresh; ++t) {
+            cTable.IncrementSequenceNumber(t);
+         }
+         cScheduler.Tick(true);
+         size_t unCount = cScheduler.Select(cTable, un_slots, &vecEntries[0]);
+         bOk &= (unCount == un_slots);
+         for(size_t i = 0; i < unCount; ++i) {
+            bOk &= (vecEntries[i] < unEntries) && (i == 0 || vecEntries[i - 1] < vecEntries[i]);
+            UInt8 unTarget = cTable.GetTarget(vecEntries[i]);
+            unMaxGap = std::max(unMaxGap, unTick - vecLastSent[unTarget]);
+            vecLastSent[unTarget] = unTick;
+         }
+         cScheduler.OnSent(cTable, &vecEntries[0], unCount);
+      }
+      for(size_t t = 0; t < unEntries; ++t) {
+         unMaxGap = std::max<UInt32>(unMaxGap, 1001 - vecLastSent[t]);
+      }
+      /*
+       * The fresh entries take their slots, the others share the rest in
+       * turn; an entry stale for FRESHNESS / AGE ticks outranks a fresh one
+       */
+      UInt32 unShared = (unEntries - unFresh + un_slots - unFresh - 1) / (un_slots - unFresh);
+      UInt32 unBound = std::max<UInt32>(unShared, FRESHNESS / AGE + (unEntries + un_slots - 1) / un_slots) + 1;
+      if(!bOk || unMaxGap > unBound) {
+         std::printf("%zu slots (%s): %s, an entry waited %u ticks, at most %u expected\n",
+                     un_slots, nPriority ? "priority" : "round-robin",
+                     bOk ? "entries picked right" : "wrong entries picked",
+                     unMaxGap, unBound);
+         ++unFailures;
+      }
+   }
+   return unFailures;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Entries of equal score go to the lowest target ids: in a table never
+ * sent, the first broadcast takes the lowest targets, the second the
+ * next ones. Returns the number of failed checks.
+ */
+static size_t CheckTies(size_t un_slots) {
+   std::vector<size_t> vecEntries(CNavTable::CAPACITY);
+   CNavTable cTable;
+   CBroadcastScheduler cScheduler;
+   for(size_t t = 0; t < 3 * un_slots; ++t) {
+      NavTableEntry sEntry = { 1, 50.0f, 0.0f };
+      cTable.Insert(240 - 5 * t, sEntry);
+   }
+   bool bOk = true;
+   for(size_t unRound = 0; unRound < 2; ++unRound) {
+      cScheduler.Tick(true);
+      size_t unCount = cScheduler.Select(cTable, un_slots, &vecEntries[0]);
+      bOk &= (unCount == un_slots);
+      for(size_t i = 0; bOk && i < unCount; ++i) {
+         bOk = (vecEntries[i] == unRound * un_slots + i);
+      }
+      cScheduler.OnSent(cTable, &vecEntries[0], unCount);
+   }
+   if(!bOk) {
+      std::printf("%zu slots: ties did not go to the lowest target ids\n", un_slots);
+      return 1;
+   }
+   return 0;
+}
+
+/****************************************/
+/****************************************/
+
+/* Whether Init() accepts a broadcast_budget */
+static bool AcceptsBudget(UInt32 un_budget) {
+   TConfigurationNode tParams("params");
+   SetNodeAttribute(tParams, "broadcast_budget", un_budget);
+   CBroadcastScheduler cScheduler;
+   try {
+      cScheduler.Init(tParams);
+   }
+   catch(CARGoSException&) {
+      return false;
+   }
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+/* A budget must be 0, for the whole payload, or room for a record; returns the number of failed checks */
+static size_t CheckBudget() {
+   size_t unFailures = 0;
+   UInt32 punRefused[] = { 1, CNavCodec::RECORD_SIZE - 1 };
+   UInt32 punAccepted[] = { 0, CNavCodec::RECORD_SIZE, 10 * CNavCodec::RECORD_SIZE };
+   for(size_t i = 0; i < sizeof(punRefused) / sizeof(punRefused[0]); ++i) {
+      if(AcceptsBudget(punRefused[i])) {
+         std::printf("a budget of %u bytes was accepted\n", punRefused[i]);
+         ++unFailures;
+      }
+   }
+   for(size_t i = 0; i < sizeof(punAccepted) / sizeof(punAccepted[0]); ++i) {
+      if(!AcceptsBudget(punAccepted[i])) {
+         std::printf("a budget of %u bytes was refused\n", punAccepted[i]);
+         ++unFailures;
+      }
+   }
+   return unFailures;
+}
+
+/****************************************/
+/****************************************/
+
+int main() {
+   size_t unFailures = CheckBudget();
+   for(size_t i = 0; i < sizeof(CHECK_SLOTS) / sizeof(CHECK_SLOTS[0]); ++i) {
+      unFailures += CheckWhole(CHECK_SLOTS[i]);
+      unFailures += CheckRotation(CHECK_SLOTS[i]);
+      unFailures += CheckTies(CHECK_SLOTS[i]);
+   }
+   if(unFailures > 0) {
+      std::printf("%zu failed checks\n", unFailures);
+      return 1;
+   }
+   std::printf("Select() picks the expected entries, the budget guard holds\n");
+   return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Cost of simulating channel noise at the receivers.
+ *
+ * Runs payloads through CNoiseChannel at several bit error rates and
+ * reports the cost per payload byte and the observed error rates. The
+ * baseline is the noise model of footbot_diffusion(noise).cpp, which
+ * created a std::random_device and a std::mt19937 for every message.
+ * Usage: nav_channel_benchmark [payloads]
+ */
+
+#include <controllers/nav_common/nav_channel.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/* Keeps the compiler from dropping the work */
+static volatile UInt64 g_unSink;
+
+typedef std::chrono::steady_clock TClock;
+
+/****************************************/
+/****************************************/
+
+static void RunBaseline(size_t un_payloads,
+                        size_t un_payload_size) {
+   std::vector<UInt8> vecPayload(un_payload_size, 0x55);
+   UInt64 unSum = 0;
+   TClock::time_point tStart = TClock::now();
+   for(size_t i = 0; i < un_payloads; ++i) {
+      std::random_device rd;
+      std::mt19937 gen(rd());
+      std::uniform_real_distribution<> disturb(0.0, 1.0);
+      if(disturb(gen) < 0.2) {
+         vecPayload[0] ^= 1;
+      }
+      unSum += vecPayload[0];
+   }
+   std::chrono::duration<Real, std::nano> tElapsed = TClock::now() - tStart;
+   g_unSink = unSum;
+   std::printf("%-16s %8zu %10s %12.2f %12s %10s\n",
+               "random_device", un_payload_size, "-",
+               tElapsed.count() / (un_payloads * un_payload_size), "-", "-");
+}
+
+/****************************************/
+/****************************************/
+
+static void RunChannel(size_t un_payloads,
+                       size_t un_payload_size,
+                       Real f_bit_error_rate,
+                       Real f_burst_probability,
+                       Real f_drop_probability) {
+   CNoiseChannel cChannel;
+   cChannel.Init(f_bit_error_rate, f_burst_probability, 16, f_drop_probability, 12345);
+   std::vector<UInt8> vecPayload(un_payload_size, 0x55);
+   UInt64 unFlipped = 0;
+   UInt64 unDropped = 0;
+   TClock::time_point tStart = TClock::now();
+   for(size_t i = 0; i < un_payloads; ++i) {
+      const UInt8* punReceived = cChannel.Receive(&vecPayload[0], un_payload_size);
+      if(punReceived == NULL) {
+         ++unDropped;
+      }
+      else if(punReceived != &vecPayload[0]) {
+         for(size_t j = 0; j < un_payload_size; ++j) {
+            unFlipped += __builtin_popcount(punReceived[j] ^ vecPayload[j]);
+         }
+      }
+   }
+   std::chrono::duration<Real, std::nano> tElapsed = TClock::now() - tStart;
+   g_unSink = unFlipped;
+   std::printf("%-16s %8zu %10g %12.2f %12.2e %10.4f\n",
+               (f_burst_probability > 0.0) ? "noise+burst" : "noise", un_payload_size, f_bit_error_rate,
+               tElapsed.count() / (un_payloads * un_payload_size),
+               static_cast<Real>(unFlipped) / (un_payloads * un_payload_size * 8.0),
+               static_cast<Real>(unDropped) / un_payloads);
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   size_t unPayloads = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+   std::printf("%-16s %8s %10s %12s %12s %10s\n",
+               "channel", "payload", "ber", "ns/byte", "flipped", "dropped");
+   RunBaseline(unPayloads / 100, 10);
+   Real pfRates[] = { 0.0, 1e-4, 1e-3, 1e-2 };
+   size_t punSizes[] = { 10, 100 };
+   for(size_t s = 0; s < sizeof(punSizes) / sizeof(punSizes[0]); ++s) {
+      for(size_t r = 0; r < sizeof(pfRates) / sizeof(pfRates[0]); ++r) {
+         RunChannel(unPayloads, punSizes[s], pfRates[r], 0.0, 0.0);
+      }
+      RunChannel(unPayloads, punSizes[s], 1e-3, 0.01, 0.05);
+   }
+   return 0;
+}
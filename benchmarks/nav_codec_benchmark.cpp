@@ -0,0 +1,147 @@
+/*
+ * Throughput of the nav message codec.
+ *
+ * Compares encoding and decoding nav info records with CNavCodec against
+ * the CByteArray operator<< / PopFront sequences the controllers used
+ * before. Usage: nav_codec_benchmark [records]
+ */
+
+#include <controllers/nav_common/nav_codec.h>
+
+#include <argos3/core/utility/datatypes/byte_array.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/* Keeps the compiler from dropping the work */
+static volatile Real g_fSink;
+
+typedef std::chrono::steady_clock TClock;
+
+/****************************************/
+/****************************************/
+
+static Real ElapsedNs(TClock::time_point t_start,
+                      size_t un_records) {
+   std::chrono::duration<Real, std::nano> tElapsed = TClock::now() - t_start;
+   return tElapsed.count() / un_records;
+}
+
+/****************************************/
+/****************************************/
+
+static void RunByteArray(size_t un_records,
+                         Real& f_encode_ns,
+                         Real& f_decode_ns) {
+   /* Encode, as the old broadcast loop did */
+   std::vector<CByteArray> vecMessages(un_records);
+   TClock::time_point tStart = TClock::now();
+   for(size_t i = 0; i < un_records; ++i) {
+      CByteArray message = CByteArray();
+      UInt8 magic = 77;
+      message << magic;
+      UInt8 id = i;
+      message << id;
+      UInt32 sequence_num = i;
+      message << sequence_num;
+      float distance = i * 0.5f;
+      UInt32 dist_cursed;
+      std::memcpy(&dist_cursed, &distance, sizeof(dist_cursed));
+      message << dist_cursed;
+      vecMessages[i] = message;
+   }
+   f_encode_ns = ElapsedNs(tStart, un_records);
+   /* Decode, as the old receive loop did (copy, then PopFront) */
+   Real fSum = 0.0;
+   tStart = TClock::now();
+   for(size_t i = 0; i < un_records; ++i) {
+      CByteArray data = vecMessages[i];
+      UInt8 magic = data.PopFront<UInt8>();
+      UInt8 target_id = data.PopFront<UInt8>();
+      UInt32 reported_sequence_num = data.PopFront<UInt32>();
+      UInt32 cursed = data.PopFront<UInt32>();
+      float reported_distance;
+      std::memcpy(&reported_distance, &cursed, sizeof(reported_distance));
+      fSum += magic + target_id + reported_sequence_num + reported_distance;
+   }
+   f_decode_ns = ElapsedNs(tStart, un_records);
+   g_fSink = fSum;
+}
+
+/****************************************/
+/****************************************/
+
+static void RunCodec(size_t un_records,
+                     Real& f_encode_ns,
+                     Real& f_decode_ns) {
+   std::vector<UInt8> vecBuffer(un_records * CNavCodec::RECORD_SIZE);
+   /* Encode in place */
+   TClock::time_point tStart = TClock::now();
+   CNavCodec::SNavInfo sInfo;
+   for(size_t i = 0; i < un_records; ++i) {
+      sInfo.Target = i;
+      sInfo.SequenceNumber = i;
+      sInfo.Distance = i * 0.5f;
+      CNavCodec::Encode(sInfo, &vecBuffer[i * CNavCodec::RECORD_SIZE]);
+   }
+   f_encode_ns = ElapsedNs(tStart, un_records);
+   /* Decode in place */
+   Real fSum = 0.0;
+   tStart = TClock::now();
+   for(size_t i = 0; i < un_records; ++i) {
+      const UInt8* punRecord = &vecBuffer[i * CNavCodec::RECORD_SIZE];
+      CNavCodec::Decode(punRecord, sInfo);
+      fSum += CNavCodec::GetType(punRecord) + sInfo.Target + sInfo.SequenceNumber + sInfo.Distance;
+   }
+   f_decode_ns = ElapsedNs(tStart, un_records);
+   g_fSink = fSum;
+}
+
+/****************************************/
+/****************************************/
+
+static void RunTable(size_t un_entries,
+                     size_t un_payload_size,
+                     size_t un_ticks) {
+   CNavTable cTable;
+   for(size_t i = 0; i < un_entries; ++i) {
+      cTable.Insert(i, {static_cast<UInt32>(i), i * 0.5f, 0.0});
+   }
+   std::vector<UInt8> vecPayload(un_payload_size);
+   size_t unCursor = 0;
+   size_t unRecords = 0;
+   TClock::time_point tStart = TClock::now();
+   for(size_t t = 0; t < un_ticks; ++t) {
+      unRecords += CNavCodec::EncodeTable(cTable, unCursor, &vecPayload[0], vecPayload.size());
+   }
+   Real fNs = ElapsedNs(tStart, un_ticks);
+   g_fSink = unRecords;
+   size_t unPerTick = CNavCodec::GetCapacity(un_payload_size);
+   std::printf("%8zu %10zu %12.1f %14zu\n",
+               un_entries, un_payload_size, fNs, (un_entries + unPerTick - 1) / unPerTick);
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   size_t unRecords = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+   Real fEncode, fDecode;
+   std::printf("%-12s %12s %12s\n", "codec", "encode ns", "decode ns");
+   RunByteArray(unRecords, fEncode, fDecode);
+   std::printf("%-12s %12.1f %12.1f\n", "CByteArray", fEncode, fDecode);
+   RunCodec(unRecords, fEncode, fDecode);
+   std::printf("%-12s %12.1f %12.1f\n", "CNavCodec", fEncode, fDecode);
+   std::printf("\nTable broadcast (per tick)\n");
+   std::printf("%8s %10s %12s %14s\n", "entries", "payload", "ns/tick", "ticks/table");
+   size_t punPayloads[] = { 10, 50, 100 };
+   for(size_t p = 0; p < sizeof(punPayloads) / sizeof(punPayloads[0]); ++p) {
+      for(size_t unEntries = 1; unEntries <= CNavTable::CAPACITY; unEntries *= 4) {
+         RunTable(unEntries, punPayloads[p], 100000);
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Cost and robustness of the payload codecs under channel noise.
+ *
+ * Every codec carries one nav info record in the smallest payload that
+ * fits it. The payloads go through CNoiseChannel at several bit error
+ * rates, and each received payload is decoded the way the controller
+ * does it. Reported per codec and error rate:
+ * - decode: time to check/correct and decode a payload, in ns;
+ * - ok:     payloads delivered with the record intact;
+ * - lost:   payloads dropped because they failed the check;
+ * - bad:    payloads delivered with a corrupted record (undetected).
+ * Time to target under noise is measured with noise_time_to_target.sh.
+ * Usage: nav_integrity_benchmark [payloads]
+ */
+
+#include <controllers/nav_common/nav_codec.h>
+#include <controllers/nav_common/nav_channel.h>
+#include <controllers/nav_common/nav_payload_codec.h>
+
+#include <argos3/core/utility/datatypes/byte_array.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/* Keeps the compiler from dropping the work */
+static volatile UInt64 g_unSink;
+
+typedef std::chrono::steady_clock TClock;
+
+/****************************************/
+/****************************************/
+
+template<class CODEC>
+static void Run(const char* pch_name,
+                size_t un_payload_size,
+                size_t un_payloads,
+                Real f_bit_error_rate) {
+   /* Sender side */
+   CODEC cSender;
+   CByteArray cPayload(un_payload_size);
+   size_t unRecordsSize;
+   UInt8* punRecords = cSender.Init(cPayload, unRecordsSize);
+   CNavCodec::SNavInfo sSent = { 3, 123456, 321.5f };
+   CNavCodec::EncodePayload(sSent, punRecords, unRecordsSize);
+   cSender.Encode(cPayload);
+   /* What the receiver hears */
+   CNoiseChannel cChannel;
+   cChannel.Init(f_bit_error_rate, 0.0, 0, 0.0, 12345);
+   std::vector<UInt8> vecReceived(un_payloads * un_payload_size);
+   for(size_t i = 0; i < un_payloads; ++i) {
+      const UInt8* punPayload = cChannel.Receive(cPayload.ToCArray(), un_payload_size);
+      ::memcpy(&vecReceived[i * un_payload_size], punPayload, un_payload_size);
+   }
+   /* Receiver side */
+   CODEC cReceiver;
+   CByteArray cScratch(un_payload_size);
+   size_t unScratchSize;
+   cReceiver.Init(cScratch, unScratchSize);
+   std::vector<CNavCodec::SNavInfo> vecDecoded(un_payloads);
+   std::vector<SInt8> vecStatus(un_payloads);
+   TClock::time_point tStart = TClock::now();
+   for(size_t i = 0; i < un_payloads; ++i) {
+      size_t unSize = un_payload_size;
+      const UInt8* punPayload = cReceiver.Decode(&vecReceived[i * un_payload_size], unSize);
+      if(punPayload == NULL) {
+         vecStatus[i] = -1;
+      }
+      else if(unSize >= CNavCodec::RECORD_SIZE &&
+              CNavCodec::GetType(punPayload) == CNavCodec::TYPE_NAV_INFO) {
+         CNavCodec::Decode(punPayload, vecDecoded[i]);
+         vecStatus[i] = 1;
+      }
+      else {
+         vecStatus[i] = 0;
+      }
+   }
+   std::chrono::duration<Real, std::nano> tDecode = TClock::now() - tStart;
+   /* Classify */
+   UInt64 unOk = 0, unLost = 0, unBad = 0, unSum = 0;
+   for(size_t i = 0; i < un_payloads; ++i) {
+      unSum += vecDecoded[i].SequenceNumber;
+      if(vecStatus[i] < 0) {
+         ++unLost;
+      }
+      else if(vecStatus[i] > 0 &&
+              vecDecoded[i].Target == sSent.Target &&
+              vecDecoded[i].SequenceNumber == sSent.SequenceNumber &&
+              vecDecoded[i].Distance == sSent.Distance) {
+         ++unOk;
+      }
+      else {
+         ++unBad;
+      }
+   }
+   g_unSink = unSum;
+   std::printf("%-8s %8zu %10g %10.1f %10.5f %10.5f %10.5f\n",
+               pch_name, un_payload_size, f_bit_error_rate,
+               tDecode.count() / un_payloads,
+               static_cast<Real>(unOk) / un_payloads,
+               static_cast<Real>(unLost) / un_payloads,
+               static_cast<Real>(unBad) / un_payloads);
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   size_t unPayloads = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+   std::printf("%-8s %8s %10s %10s %10s %10s %10s\n",
+               "codec", "payload", "ber", "decode ns", "ok", "lost", "bad");
+   Real pfRates[] = { 0.0, 1e-3, 1e-2, 5e-2 };
+   for(size_t r = 0; r < sizeof(pfRates) / sizeof(pfRates[0]); ++r) {
+      Run<CPlainPayloadCodec> ("plain",  CNavCodec::RECORD_SIZE,                  unPayloads, pfRates[r]);
+      Run<CCrc8PayloadCodec>  ("crc8",   CNavCodec::RECORD_SIZE + CCrc8::SIZE,    unPayloads, pfRates[r]);
+      Run<CCrc16PayloadCodec> ("crc16",  CNavCodec::RECORD_SIZE + CCrc16::SIZE,   unPayloads, pfRates[r]);
+      Run<CSecdedPayloadCodec>("secded", CNavCodec::RECORD_SIZE * 2,              unPayloads, pfRates[r]);
+   }
+   return 0;
+}
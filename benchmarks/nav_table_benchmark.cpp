@@ -0,0 +1,139 @@
+/*
+ * Per-tick cost of the navigation table as the number of known targets grows.
+ *
+ * A simulated tick does what ControlStep does with the table:
+ * - apply odometry to every entry;
+ * - merge a handful of received nav messages (lookup + conditional update);
+ * - walk the table to serialize the broadcast.
+ *
+ * The baseline is the std::map<int, NavTableEntry> the controllers used
+ * before, accessed the same way they accessed it (operator[] inside the
+ * iteration).
+ *
+ * nav_table_check checks that the table gives the same entries as the
+ * eager reference the controllers used to be.
+ * Usage: nav_table_benchmark [ticks]
+ */
+
+#include <controllers/nav_common/nav_table.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+/* Messages received per tick */
+static const size_t PACKETS_PER_TICK = 8;
+
+/* A received nav message */
+struct SPacket {
+   UInt8 Target;
+   UInt32 SequenceNumber;
+   float Distance;
+};
+
+/* Keeps the compiler from dropping the work */
+static volatile Real g_fSink;
+
+/****************************************/
+/****************************************/
+
+static std::vector<SPacket> MakePackets(size_t un_targets,
+                                        size_t un_count) {
+   std::vector<SPacket> vecPackets(un_count);
+   UInt32 unState = 12345;
+   for(size_t i = 0; i < un_count; ++i) {
+      unState = unState * 1664525 + 1013904223;
+      vecPackets[i].Target = (unState >> 8) % un_targets;
+      vecPackets[i].SequenceNumber = i;
+      vecPackets[i].Distance = (unState >> 16) % 1000;
+   }
+   return vecPackets;
+}
+
+/****************************************/
+/****************************************/
+
+static Real RunMap(size_t un_targets,
+                   const std::vector<SPacket>& vec_packets,
+                   size_t un_ticks) {
+   std::map<int, NavTableEntry> navTable;
+   for(size_t i = 0; i < un_targets; ++i) {
+      navTable[i] = {0, 1000.0f, 0.0};
+   }
+   Real fSum = 0.0;
+   size_t unPacket = 0;
+   std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+   for(size_t t = 0; t < un_ticks; ++t) {
+      for(auto i = navTable.begin(); i != navTable.end(); ++i) {
+         navTable[i->first].distance += 0.25;
+         navTable[i->first].heading -= 0.01;
+      }
+      for(size_t p = 0; p < PACKETS_PER_TICK; ++p) {
+         const SPacket& sPacket = vec_packets[unPacket];
+         unPacket = (unPacket + 1) % vec_packets.size();
+         if(navTable.find(sPacket.Target) == navTable.end() ||
+            (sPacket.Distance < navTable[sPacket.Target].distance &&
+             sPacket.SequenceNumber >= navTable[sPacket.Target].sequence_number)) {
+            navTable[sPacket.Target] = {sPacket.SequenceNumber, sPacket.Distance, 0.5};
+         }
+      }
+      for(auto i = navTable.begin(); i != navTable.end(); ++i) {
+         fSum += navTable[i->first].sequence_number + navTable[i->first].distance;
+      }
+   }
+   std::chrono::duration<Real, std::nano> tElapsed = std::chrono::steady_clock::now() - tStart;
+   g_fSink = fSum;
+   return tElapsed.count() / un_ticks;
+}
+
+/****************************************/
+/****************************************/
+
+static Real RunFlat(size_t un_targets,
+                    const std::vector<SPacket>& vec_packets,
+                    size_t un_ticks) {
+   CNavTable navTable;
+   for(size_t i = 0; i < un_targets; ++i) {
+      navTable.Insert(i, {0, 1000.0f, 0.0});
+   }
+   Real fSum = 0.0;
+   size_t unPacket = 0;
+   std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+   for(size_t t = 0; t < un_ticks; ++t) {
+      navTable.Move(0.25, 0.01);
+      for(size_t p = 0; p < PACKETS_PER_TICK; ++p) {
+         const SPacket& sPacket = vec_packets[unPacket];
+         unPacket = (unPacket + 1) % vec_packets.size();
+         NavTableEntry sEntry;
+         if(!navTable.Find(sPacket.Target, sEntry) ||
+            (sPacket.Distance < sEntry.distance &&
+             sPacket.SequenceNumber >= sEntry.sequence_number)) {
+            navTable.Insert(sPacket.Target, {sPacket.SequenceNumber, sPacket.Distance, 0.5});
+         }
+      }
+      for(size_t i = 0; i < navTable.Size(); ++i) {
+         NavTableEntry sEntry = navTable.GetEntry(i);
+         fSum += sEntry.sequence_number + sEntry.distance;
+      }
+   }
+   std::chrono::duration<Real, std::nano> tElapsed = std::chrono::steady_clock::now() - tStart;
+   g_fSink = fSum;
+   return tElapsed.count() / un_ticks;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   size_t unTicks = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 200000;
+   std::printf("%8s %14s %14s %8s\n", "targets", "map ns/tick", "flat ns/tick", "speedup");
+   for(size_t unTargets = 1; unTargets <= CNavTable::CAPACITY; unTargets *= 2) {
+      std::vector<SPacket> vecPackets = MakePackets(unTargets, 4096);
+      Real fMap = RunMap(unTargets, vecPackets, unTicks);
+      Real fFlat = RunFlat(unTargets, vecPackets, unTicks);
+      std::printf("%8zu %14.1f %14.1f %7.1fx\n", unTargets, fMap, fFlat, fMap / fFlat);
+   }
+   return 0;
+}
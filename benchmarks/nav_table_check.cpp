@@ -0,0 +1,101 @@
+/*
+ * Regression check of the navigation table against an eager reference.
+ *
+ * The table applies odometry lazily, materializing an entry only when it
+ * is read. The check replays random moves, merges, sequence number
+ * increments and clears on the table and on a std::map that applies
+ * odometry to every entry, as the controllers used to, and fails if the
+ * entries drift from it. It exits with 1 on a mismatch, so that ctest
+ * can run it.
+ * Usage: nav_table_check [ticks]
+ */
+
+#include <controllers/nav_common/nav_table.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+/* Messages received per tick */
+static const size_t PACKETS_PER_TICK = 8;
+
+/****************************************/
+/****************************************/
+
+/*
+ * Replays random moves, merges and clears on the table and on an eager
+ * reference in double precision, and compares every entry after each tick.
+ * Returns the number of mismatches.
+ */
+static size_t CheckAgainstEager(size_t un_ticks) {
+   struct SReference {
+      UInt32 SequenceNumber;
+      Real Distance;
+      Real Heading;
+   };
+   std::map<UInt8, SReference> mapReference;
+   CNavTable navTable;
+   UInt32 unState = 54321;
+   size_t unMismatches = 0;
+   for(size_t t = 0; t < un_ticks; ++t) {
+      unState = unState * 1664525 + 1013904223;
+      Real fDistance = (unState >> 20) * 0.001;
+      Real fRotation = (static_cast<SInt32>(unState >> 16) % 200 - 100) * 0.001;
+      navTable.Move(fDistance, fRotation);
+      for(auto i = mapReference.begin(); i != mapReference.end(); ++i) {
+         i->second.Distance += fDistance;
+         i->second.Heading -= fRotation;
+      }
+      for(size_t p = 0; p < PACKETS_PER_TICK; ++p) {
+         unState = unState * 1664525 + 1013904223;
+         UInt8 unTarget = unState >> 24;
+         NavTableEntry sEntry = { static_cast<UInt32>(t), static_cast<float>((unState >> 8) % 1000), (unState % 628) * 0.01 };
+         navTable.Insert(unTarget, sEntry);
+         mapReference[unTarget] = { sEntry.sequence_number, sEntry.distance, sEntry.heading };
+         if(p == 0) {
+            navTable.IncrementSequenceNumber(unTarget);
+            ++mapReference[unTarget].SequenceNumber;
+         }
+      }
+      if(t % 1000 == 999) {
+         navTable.Clear();
+         mapReference.clear();
+      }
+      /* Same targets, same order, same values */
+      if(navTable.Size() != mapReference.size()) {
+         ++unMismatches;
+         continue;
+      }
+      size_t unIndex = 0;
+      for(auto i = mapReference.begin(); i != mapReference.end(); ++i, ++unIndex) {
+         NavTableEntry sDense = navTable.GetEntry(unIndex);
+         NavTableEntry sFound;
+         if(navTable.GetTarget(unIndex) != i->first ||
+            !navTable.Find(i->first, sFound) ||
+            sFound.sequence_number != i->second.SequenceNumber ||
+            sDense.sequence_number != i->second.SequenceNumber ||
+            std::fabs(sFound.distance - i->second.Distance) > 1e-3 * (1.0 + i->second.Distance) ||
+            std::fabs(sFound.heading - i->second.Heading) > 1e-9 * (1.0 + std::fabs(i->second.Heading)) ||
+            sDense.distance != sFound.distance ||
+            sDense.heading != sFound.heading) {
+            ++unMismatches;
+         }
+      }
+   }
+   return unMismatches;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   size_t unTicks = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 10000;
+   size_t unMismatches = CheckAgainstEager(unTicks);
+   if(unMismatches > 0) {
+      std::fprintf(stderr, "nav table diverged from the eager reference: %zu mismatches\n", unMismatches);
+      return 1;
+   }
+   std::printf("nav table matches the eager reference over %zu ticks\n", unTicks);
+   return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * Cost of tracing the navigation controllers.
+ *
+ * Records events for robots x ticks, a few per robot and tick, the way
+ * the controllers do with NAV_TRACE_LEVEL set, and drains the rings as
+ * the nav_loop_functions do, once half full. For comparison, the same
+ * events are formatted as text lines into a stream of every robot, and
+ * into a single stream behind a mutex, as writing to LOG from parallel
+ * control steps would. Reported per writer: ns per event.
+ * nav_trace_check checks the drained events against what was recorded.
+ * Usage: nav_trace_benchmark [ticks] [robots] [events per robot and tick]
+ */
+
+#include <controllers/nav_common/nav_trace.h>
+
+#include "nav_trace_events.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+typedef std::chrono::steady_clock TClock;
+
+/****************************************/
+/****************************************/
+
+/* Records and drains the events, returns ns per event; counts the events lost */
+static double RunTrace(UInt32 un_ticks,
+                       UInt32 un_robots,
+                       UInt32 un_events,
+                       size_t un_capacity,
+                       UInt64& un_lost) {
+   std::vector<CNavTrace> vecTraces(un_robots);
+   for(UInt32 r = 0; r < un_robots; ++r) {
+      vecTraces[r].SetCapacity(un_capacity);
+   }
+   std::vector<SNavTraceEvent> vecChunk;
+   un_lost = 0;
+   TClock::time_point tStart = TClock::now();
+   for(UInt32 t = 0; t <= un_ticks; ++t) {
+      bool bLast = (t == un_ticks);
+      for(UInt32 r = 0; r < un_robots && !bLast; ++r) {
+         CNavTrace& cTrace = vecTraces[r];
+         cTrace.SetTick(t);
+         for(UInt32 e = 0; e < un_events; ++e) {
+            UInt16 unType, unTarget;
+            Real fValue0, fValue1;
+            MakeEvent(t, r, e, unType, unTarget, fValue0, fValue1);
+            cTrace.Record(unType, unTarget, fValue0, fValue1);
+         }
+      }
+      /* Drain as the loop functions do after every step, everything after the last one */
+      for(UInt32 r = 0; r < un_robots; ++r) {
+         CNavTrace& cTrace = vecTraces[r];
+         if(cTrace.GetPending() == 0 || (!bLast && cTrace.GetPending() < cTrace.GetCapacity() / 2)) continue;
+         vecChunk.clear();
+         un_lost += cTrace.Drain([&vecChunk](const SNavTraceEvent* ps_events, size_t un_count) {
+            vecChunk.insert(vecChunk.end(), ps_events, ps_events + un_count);
+         });
+      }
+   }
+   std::chrono::duration<double, std::nano> tElapsed = TClock::now() - tStart;
+   return tElapsed.count() / (static_cast<double>(un_ticks) * un_robots * un_events);
+}
+
+/****************************************/
+/****************************************/
+
+/* Formats the events as text, into a stream per robot or a shared one; returns ns per event */
+static double RunText(UInt32 un_ticks,
+                      UInt32 un_robots,
+                      UInt32 un_events,
+                      bool b_shared) {
+   std::vector<std::ostringstream> vecStreams(b_shared ? 1 : un_robots);
+   std::mutex cMutex;
+   TClock::time_point tStart = TClock::now();
+   for(UInt32 t = 0; t < un_ticks; ++t) {
+      for(UInt32 r = 0; r < un_robots; ++r) {
+         for(UInt32 e = 0; e < un_events; ++e) {
+            UInt16 unType, unTarget;
+            Real fValue0, fValue1;
+            MakeEvent(t, r, e, unType, unTarget, fValue0, fValue1);
+            if(b_shared) {
+               std::lock_guard<std::mutex> cLock(cMutex);
+               vecStreams[0] << r << " " << CNavTrace::GetEventName(unType) << " "
+                             << unTarget << " " << fValue0 << " @ " << fValue1 << "\n";
+            }
+            else {
+               vecStreams[r] << CNavTrace::GetEventName(unType) << " "
+                             << unTarget << " " << fValue0 << " @ " << fValue1 << "\n";
+            }
+         }
+      }
+      /* Empty the streams after every step, as if copied to LOG */
+      for(size_t i = 0; i < vecStreams.size(); ++i) {
+         vecStreams[i].str(std::string());
+      }
+   }
+   std::chrono::duration<double, std::nano> tElapsed = TClock::now() - tStart;
+   return tElapsed.count() / (static_cast<double>(un_ticks) * un_robots * un_events);
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unTicks = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000;
+   UInt32 unRobots = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 1000;
+   UInt32 unEvents = (argc > 3) ? std::strtoul(argv[3], NULL, 10) : 4;
+   if(unTicks == 0 || unRobots == 0 || unEvents == 0) {
+      std::printf("ticks, robots and events must be positive\n");
+      return 1;
+   }
+   std::printf("%u ticks x %u robots x %u events\n", unTicks, unRobots, unEvents);
+   std::printf("%-14s %12s\n", "writer", "ns/event");
+   std::printf("%-14s %12.1f\n", "shared text", RunText(unTicks, unRobots, unEvents, true));
+   std::printf("%-14s %12.1f\n", "robot text", RunText(unTicks, unRobots, unEvents, false));
+   UInt64 unLost;
+   std::printf("%-14s %12.1f\n", "trace", RunTrace(unTicks, unRobots, unEvents,
+                                                    CNavTrace::DEFAULT_CAPACITY, unLost));
+   if(unLost > 0) {
+      std::printf("trace: %llu events lost\n", static_cast<unsigned long long>(unLost));
+   }
+   return 0;
+}
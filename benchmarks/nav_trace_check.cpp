@@ -0,0 +1,114 @@
+/*
+ * Regression check of the trace rings of the navigation controllers:
+ * records events for a few robots and ticks, drains the rings as the
+ * nav_loop_functions do, once half full, and compares every drained
+ * event with what was recorded. A ring large enough must lose nothing,
+ * and a ring smaller than the events of a tick must report the events it
+ * lost and still deliver the others intact. Exits with 1 on a mismatch,
+ * so that ctest can run it.
+ * Usage: nav_trace_check
+ */
+
+#include <controllers/nav_common/nav_trace.h>
+
+#include "nav_trace_events.h"
+
+#include <cstdio>
+#include <vector>
+
+/* Size of the runs */
+static const UInt32 CHECK_TICKS = 100;
+static const UInt32 CHECK_ROBOTS = 10;
+static const UInt32 CHECK_EVENTS = 4;
+
+/****************************************/
+/****************************************/
+
+/*
+ * Records and drains the events. Counts the drained events that differ
+ * from the recorded ones, and those lost.
+ */
+static void RunTrace(UInt32 un_ticks,
+                     UInt32 un_robots,
+                     UInt32 un_events,
+                     size_t un_capacity,
+                     size_t& un_mismatches,
+                     UInt64& un_lost) {
+   std::vector<CNavTrace> vecTraces(un_robots);
+   for(UInt32 r = 0; r < un_robots; ++r) {
+      vecTraces[r].SetCapacity(un_capacity);
+   }
+   /* Next event expected from each robot, as a running index */
+   std::vector<UInt64> vecExpected(un_robots, 0);
+   std::vector<SNavTraceEvent> vecChunk;
+   un_mismatches = 0;
+   un_lost = 0;
+   for(UInt32 t = 0; t <= un_ticks; ++t) {
+      bool bLast = (t == un_ticks);
+      for(UInt32 r = 0; r < un_robots && !bLast; ++r) {
+         CNavTrace& cTrace = vecTraces[r];
+         cTrace.SetTick(t);
+         for(UInt32 e = 0; e < un_events; ++e) {
+            UInt16 unType, unTarget;
+            Real fValue0, fValue1;
+            MakeEvent(t, r, e, unType, unTarget, fValue0, fValue1);
+            cTrace.Record(unType, unTarget, fValue0, fValue1);
+         }
+      }
+      /* Drain as the loop functions do after every step, everything after the last one */
+      for(UInt32 r = 0; r < un_robots; ++r) {
+         CNavTrace& cTrace = vecTraces[r];
+         if(cTrace.GetPending() == 0 || (!bLast && cTrace.GetPending() < cTrace.GetCapacity() / 2)) continue;
+         vecChunk.clear();
+         UInt64 unLost = cTrace.Drain([&vecChunk](const SNavTraceEvent* ps_events, size_t un_count) {
+            vecChunk.insert(vecChunk.end(), ps_events, ps_events + un_count);
+         });
+         un_lost += unLost;
+         vecExpected[r] += unLost;
+         for(size_t i = 0; i < vecChunk.size(); ++i, ++vecExpected[r]) {
+            UInt32 unTick = vecExpected[r] / un_events;
+            UInt32 unEvent = vecExpected[r] % un_events;
+            UInt16 unType, unTarget;
+            Real fValue0, fValue1;
+            MakeEvent(unTick, r, unEvent, unType, unTarget, fValue0, fValue1);
+            const SNavTraceEvent& s = vecChunk[i];
+            if(s.Tick != unTick || s.Type != unType || s.Target != unTarget ||
+               s.Values[0] != static_cast<float>(fValue0) || s.Values[1] != static_cast<float>(fValue1)) {
+               ++un_mismatches;
+            }
+         }
+      }
+   }
+   /* Every event must be accounted for */
+   for(UInt32 r = 0; r < un_robots; ++r) {
+      if(vecExpected[r] != static_cast<UInt64>(un_ticks) * un_events) {
+         ++un_mismatches;
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+int main() {
+   int nStatus = 0;
+   size_t unMismatches;
+   UInt64 unLost;
+   RunTrace(CHECK_TICKS, CHECK_ROBOTS, CHECK_EVENTS, CNavTrace::DEFAULT_CAPACITY, unMismatches, unLost);
+   if(unMismatches > 0 || unLost > 0) {
+      std::printf("default ring: %zu events differ from what was recorded, %llu lost\n",
+                  unMismatches, static_cast<unsigned long long>(unLost));
+      nStatus = 1;
+   }
+   /* A ring smaller than the events of a tick must lose some, and say how many */
+   RunTrace(CHECK_TICKS, CHECK_ROBOTS, CHECK_EVENTS * 4, CHECK_EVENTS, unMismatches, unLost);
+   if(unMismatches > 0 || unLost == 0) {
+      std::printf("small ring: %zu events differ from what was recorded, %llu lost\n",
+                  unMismatches, static_cast<unsigned long long>(unLost));
+      nStatus = 1;
+   }
+   if(nStatus == 0) {
+      std::printf("drained events match what was recorded, lost events are reported\n");
+   }
+   return nStatus;
+}
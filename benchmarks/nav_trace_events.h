@@ -0,0 +1,26 @@
+/*
+ * Events of the nav trace benchmark and check: a few per robot and tick,
+ * each a function of the tick, the robot and its index in the tick, so
+ * that the drained events can be compared with what was recorded.
+ */
+
+#ifndef NAV_TRACE_EVENTS_H
+#define NAV_TRACE_EVENTS_H
+
+#include <controllers/nav_common/nav_trace.h>
+
+/* Event e of a robot on a tick */
+static void MakeEvent(UInt32 un_tick,
+                      UInt32 un_robot,
+                      UInt32 un_event,
+                      UInt16& un_type,
+                      UInt16& un_target,
+                      Real& f_value0,
+                      Real& f_value1) {
+   un_type = (un_robot + un_event) % NAV_TRACE_EVENT_COUNT;
+   un_target = un_event;
+   f_value0 = un_tick * 0.5 + un_robot;
+   f_value1 = un_event * 0.25 - 1.0;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#!/bin/bash
+# Time to target of NwD under channel noise, for each payload codec.
+#
+# Derives one experiment per codec and bit error rate from a base NwD
+# experiment (controller label, noise_ber and a rab_data_size that fits
+# one record with the codec overhead), then runs them all with the
+# trial runner. The derived files go to a temporary directory.
+#
+# Usage: benchmarks/noise_time_to_target.sh [-c base.argos] [-n trials] [-o output.csv] [ber ...]
+base="experiments/swarmnavigationdirection.argos";
+count=20;
+outfile="noise_time_to_target.csv";
+while getopts c:n:o: flag
+do
+    case "${flag}" in
+        c) base=${OPTARG};;
+        n) count=${OPTARG};;
+        o) outfile=${OPTARG};;
+    esac
+done
+shift $((OPTIND - 1))
+rates=${@:-"0 0.001 0.01"}
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+experiments=()
+for ber in $rates; do
+    for codec in plain:10 crc8:11 crc16:12 secded:20; do
+        name=${codec%%:*}
+        size=${codec##*:}
+        if [ "$name" = "plain" ]; then label="nwd_noisy_controller"; else label="nwd_${name}_noisy_controller"; fi
+        file="$workdir/${name}_ber${ber}.argos"
+        sed -e "s/nwd_controller/$label/g" \
+            -e "s/comm_range=\"\([^\"]*\)\"/comm_range=\"\1\" noise_ber=\"$ber\"/" \
+            -e "s/<foot-bot id=\"\([^\"]*\)\"/<foot-bot id=\"\1\" rab_data_size=\"$size\"/" \
+            "$base" > "$file"
+        experiments+=(-c "$file")
+    done
+done
+
+build/embedding/trial_runner/trial_runner "${experiments[@]}" -n $count -o $outfile
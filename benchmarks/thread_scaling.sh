@@ -0,0 +1,71 @@
+#!/bin/bash
+# Speed-up of the multi-threaded control step, and check that it does not
+# change the results.
+#
+# Runs the same trials (same seeds) of a large swarm with the threads
+# attribute of <system> set to every given count, 0 being ARGoS's
+# single-threaded loop. One trial runs at a time, so the threads are the
+# only parallelism. Every trial is stopped after the same number of
+# ticks. Prints the mean wall time per tick and the speed-up of every
+# thread count, and exits with 1 if a trial ends differently (ticks,
+# target found, path length, messages or hops) than with 0 threads. The
+# derived files go to a temporary directory.
+#
+# Usage: benchmarks/thread_scaling.sh [-c base.argos] [-q robots] [-n trials] [-t ticks] [-o output.csv] [threads ...]
+base="experiments/maze_4Ls.argos";
+robots=1000;
+count=3;
+ticks=500;
+outfile="thread_scaling.csv";
+while getopts c:q:n:t:o: flag
+do
+    case "${flag}" in
+        c) base=${OPTARG};;
+        q) robots=${OPTARG};;
+        n) count=${OPTARG};;
+        t) ticks=${OPTARG};;
+        o) outfile=${OPTARG};;
+    esac
+done
+shift $((OPTIND - 1))
+threads=${@:-"0 1 2 4 8 $(nproc)"}
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+sweeps=()
+for n in $threads; do
+    sed -e "s/<system threads=\"[0-9]*\"/<system threads=\"$n\"/" "$base" > "$workdir/threads_${n}_base.argos"
+    cat > "$workdir/threads_$n.xml" <<EOF
+<sweep base="$workdir/threads_${n}_base.argos">
+  <layout name="arena" arena="$workdir/threads_${n}_base.argos" min="-4.5,-4.5,0" max="4.5,4.5,0" />
+  <quantity values="$robots" />
+</sweep>
+EOF
+    sweeps+=(-x "$workdir/threads_$n.xml")
+done
+
+build/embedding/trial_runner/trial_runner "${sweeps[@]}" -n $count -j 1 -T $ticks -o $outfile || exit 1
+
+# Experiment names start with threads_<n>[
+awk -F, 'NR > 1 && $12 == "ok" && $4 > 0 {
+             n = substr($1, 9, index($1, "[") - 9)
+             trials[n]++; us[n] += 1e6 * $10 / $4
+             result[n, $2] = $4 "," $5 "," $7 "," $8 "," $9
+         }
+         END {
+             printf "%8s %8s %14s %10s\n", "threads", "trials", "us per tick", "speed-up"
+             status = 0
+             for(n in trials) {
+                 printf "%8d %8d %14.1f %10.2f\n", n, trials[n], us[n] / trials[n], (us[0] / trials[0]) / (us[n] / trials[n]) | "sort -n"
+             }
+             close("sort -n")
+             for(k in result) {
+                 split(k, key, SUBSEP)
+                 if(key[1] != 0 && result[k] != result[0, key[2]]) {
+                     printf "trial %s with %s threads: %s, with 0 threads: %s\n", key[2], key[1], result[k], result[0, key[2]]
+                     status = 1
+                 }
+             }
+             exit status
+         }' $outfile
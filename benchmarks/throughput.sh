@@ -0,0 +1,94 @@
+#!/bin/bash
+# Simulator throughput and memory of growing swarms, checked against a
+# baseline.
+#
+# Runs nav_throughput on arenas generated for every swarm size at the
+# same density, for the experiment of every navigation controller (one
+# process per size, as the peak RSS is that of the process). Prints the
+# ticks per second, time per ControlStep, peak RSS and controller bytes
+# per robot of every run.
+#
+# With a baseline file (a previous output.csv), exits with 1 if a run is
+# slower than the baseline by more than the tolerance, in ticks per
+# second or time per ControlStep, takes more RSS by more than the
+# tolerance, or if its controllers take more bytes than in the baseline
+# at all (they do not depend on the machine). Timings only compare on the
+# same machine and build type. -u writes the results to the baseline
+# file instead, e.g. after an intended change.
+#
+# Usage: benchmarks/throughput.sh [-q "robots ..."] [-d density] [-t ticks] [-w ticks] [-s seed]
+#                                 [-o output.csv] [-b baseline.csv [-r tolerance] [-u]] [experiment.argos ...]
+sizes="50 200 1000 5000 10000";
+density=1;
+ticks=200;
+warmup=50;
+seed=1;
+outfile="throughput.csv";
+baseline="";
+tolerance=0.2;
+update=0;
+while getopts q:d:t:w:s:o:b:r:u flag
+do
+    case "${flag}" in
+        q) sizes=${OPTARG};;
+        d) density=${OPTARG};;
+        t) ticks=${OPTARG};;
+        w) warmup=${OPTARG};;
+        s) seed=${OPTARG};;
+        o) outfile=${OPTARG};;
+        b) baseline=${OPTARG};;
+        r) tolerance=${OPTARG};;
+        u) update=1;;
+    esac
+done
+shift $((OPTIND - 1))
+experiments=${@:-"experiments/swarmnavigation.argos experiments/swarmnavigationdirection.argos"}
+
+rm -f $outfile
+for experiment in $experiments; do
+    for robots in $sizes; do
+        build/embedding/nav_throughput/nav_throughput -c $experiment -q $robots -d $density \
+            -t $ticks -w $warmup -s $seed -o $outfile > /dev/null || exit 1
+    done
+done
+
+awk -F, 'BEGIN {
+             printf "%-28s %8s %12s %14s %12s %12s %14s\n", "experiment", "robots", "ticks/s", "ns per step", "peak kB", "RSS/robot", "bytes/robot"
+         }
+         NR > 1 {
+             printf "%-28s %8d %12.1f %14.1f %12d %12d %14d\n", $1, $2, $5, $7, $8, $9, $10
+         }' $outfile
+
+if [ -z "$baseline" ]; then
+    exit 0
+fi
+if [ $update -eq 1 ]; then
+    cp $outfile $baseline
+    echo "Wrote the baseline $baseline"
+    exit 0
+fi
+if [ ! -f "$baseline" ]; then
+    echo "No baseline $baseline, write one with -u"
+    exit 1
+fi
+
+# Rows are matched by experiment and robots
+awk -F, -v tolerance=$tolerance \
+    'FNR == 1 { next }
+     NR == FNR { base[$1, $2] = $0; next }
+     ($1, $2) in base {
+         split(base[$1, $2], b, ",")
+         if($5 < b[5] * (1 - tolerance)) {
+             printf "%s, %d robots: %.1f ticks/s, baseline %.1f\n", $1, $2, $5, b[5]; status = 1
+         }
+         if($7 > b[7] * (1 + tolerance)) {
+             printf "%s, %d robots: %.1f ns per ControlStep, baseline %.1f\n", $1, $2, $7, b[7]; status = 1
+         }
+         if($8 > b[8] * (1 + tolerance)) {
+             printf "%s, %d robots: peak RSS %d kB, baseline %d kB\n", $1, $2, $8, b[8]; status = 1
+         }
+         if($10 > b[10]) {
+             printf "%s, %d robots: %d controller bytes per robot, baseline %d\n", $1, $2, $10, b[10]; status = 1
+         }
+     }
+     END { exit status }' $baseline $outfile
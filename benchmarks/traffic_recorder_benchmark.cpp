@@ -0,0 +1,117 @@
+/*
+ * Cost of recording the radio traffic of every robot on every tick.
+ *
+ * Writes ticks x robots per-robot rows with CTrafficRecorder, in CSV and
+ * in binary, and with a plain std::ofstream for comparison. Reported per
+ * writer: ns per row and size of the file. traffic_recorder_check checks
+ * that the files hold what was written.
+ * Usage: traffic_recorder_benchmark [ticks] [robots] [file]
+ */
+
+#include <loop_functions/nav_loop_functions/traffic_recorder.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+typedef std::chrono::steady_clock TClock;
+
+/****************************************/
+/****************************************/
+
+/* Traffic of a robot on a tick, varied so that the numbers have several digits */
+static CNavController::STraffic MakeTraffic(UInt32 un_tick,
+                                            UInt32 un_robot) {
+   CNavController::STraffic sTraffic;
+   UInt32 unX = un_tick * 2654435761u + un_robot * 40503u;
+   for(size_t i = 0; i < CNavController::MESSAGE_COUNT; ++i) {
+      sTraffic.Sent[i] = (unX >> (3 * i)) & 1;
+      sTraffic.Records[i] = (unX >> (5 * i)) & 63;
+   }
+   sTraffic.BytesOnAir = (unX & 1) ? 10 : 0;
+   sTraffic.Received = (unX >> 8) & 127;
+   sTraffic.OutOfRange = (unX >> 16) & 31;
+   sTraffic.Dropped = (unX >> 24) & 3;
+   return sTraffic;
+}
+
+/****************************************/
+/****************************************/
+
+static long FileSize(const char* pch_file) {
+   std::ifstream cFile(pch_file, std::ios::binary | std::ios::ate);
+   return cFile ? static_cast<long>(cFile.tellg()) : -1;
+}
+
+/****************************************/
+/****************************************/
+
+static void RunRecorder(const char* pch_name,
+                        CTrafficRecorder::EFormat e_format,
+                        UInt32 un_ticks,
+                        UInt32 un_robots,
+                        const char* pch_file) {
+   TClock::time_point tStart = TClock::now();
+   CTrafficRecorder cRecorder;
+   cRecorder.Open(pch_file, e_format, true);
+   for(UInt32 t = 0; t < un_ticks; ++t) {
+      for(UInt32 r = 0; r < un_robots; ++r) {
+         cRecorder.Write(t, r, MakeTraffic(t, r));
+      }
+   }
+   cRecorder.Close();
+   std::chrono::duration<double, std::nano> tElapsed = TClock::now() - tStart;
+   std::printf("%-10s %12.1f %12.1f\n", pch_name,
+               tElapsed.count() / (static_cast<double>(un_ticks) * un_robots),
+               FileSize(pch_file) / 1048576.0);
+}
+
+/****************************************/
+/****************************************/
+
+static void RunOfstream(UInt32 un_ticks,
+                        UInt32 un_robots,
+                        const char* pch_file) {
+   TClock::time_point tStart = TClock::now();
+   {
+      std::ofstream cOutput(pch_file);
+      for(UInt32 t = 0; t < un_ticks; ++t) {
+         for(UInt32 r = 0; r < un_robots; ++r) {
+            CNavController::STraffic sTraffic = MakeTraffic(t, r);
+            cOutput << t << "," << r;
+            for(size_t i = 0; i < CNavController::MESSAGE_COUNT; ++i) {
+               cOutput << "," << sTraffic.Sent[i];
+            }
+            cOutput << "," << sTraffic.BytesOnAir
+                    << "," << sTraffic.Received
+                    << "," << sTraffic.OutOfRange
+                    << "," << sTraffic.Dropped;
+            for(size_t i = 0; i < CNavController::MESSAGE_COUNT; ++i) {
+               cOutput << "," << sTraffic.Records[i];
+            }
+            cOutput << "\n";
+         }
+      }
+   }
+   std::chrono::duration<double, std::nano> tElapsed = TClock::now() - tStart;
+   std::printf("%-10s %12.1f %12.1f\n", "ofstream",
+               tElapsed.count() / (static_cast<double>(un_ticks) * un_robots),
+               FileSize(pch_file) / 1048576.0);
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unTicks = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 10000;
+   UInt32 unRobots = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 1000;
+   const char* pchFile = (argc > 3) ? argv[3] : "traffic_recorder_benchmark.tmp";
+   std::printf("%u ticks x %u robots, one row per robot and tick\n", unTicks, unRobots);
+   std::printf("%-10s %12s %12s\n", "writer", "ns/row", "MiB");
+   RunOfstream(unTicks, unRobots, pchFile);
+   RunRecorder("csv", CTrafficRecorder::FORMAT_CSV, unTicks, unRobots, pchFile);
+   RunRecorder("binary", CTrafficRecorder::FORMAT_BINARY, unTicks, unRobots, pchFile);
+   std::remove(pchFile);
+   return 0;
+}
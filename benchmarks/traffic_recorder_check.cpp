@@ -0,0 +1,179 @@
+/*
+ * Regression check of the traffic files: writes a few ticks of traffic
+ * with CTrafficRecorder in CSV and in binary, with and without
+ * traffic_per_robot, reads each file back and compares its header and
+ * every row with what was written. Exits with 1 on a mismatch, so that
+ * ctest can run it.
+ * Usage: traffic_recorder_check [file]
+ */
+
+#include <loop_functions/nav_loop_functions/traffic_recorder.h>
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Size of the files; rows per tick when per robot */
+static const UInt32 CHECK_TICKS = 50;
+static const UInt32 CHECK_ROBOTS = 7;
+
+static const char CSV_FIELDS[] =
+   "sent_nav_info,sent_request,sent_reply,bytes_on_air,"
+   "received,out_of_range,dropped,"
+   "records_nav_info,records_request,records_reply";
+
+/****************************************/
+/****************************************/
+
+/* Traffic of a robot on a tick, varied so that the numbers have several digits */
+static CNavController::STraffic MakeTraffic(UInt32 un_tick,
+                                            UInt32 un_robot) {
+   CNavController::STraffic sTraffic;
+   UInt32 unX = un_tick * 2654435761u + un_robot * 40503u;
+   for(size_t i = 0; i < CNavController::MESSAGE_COUNT; ++i) {
+      sTraffic.Sent[i] = (unX >> (3 * i)) & 1;
+      sTraffic.Records[i] = (unX >> (5 * i)) & 63;
+   }
+   sTraffic.BytesOnAir = (unX & 1) ? 10 : 0;
+   sTraffic.Received = (unX >> 8) & 127;
+   sTraffic.OutOfRange = (unX >> 16) & 31;
+   sTraffic.Dropped = unX >> 22;
+   return sTraffic;
+}
+
+/****************************************/
+/****************************************/
+
+/* Writes a file, and returns the rows it must hold */
+static std::vector<std::vector<UInt32> > WriteFile(const char* pch_file,
+                                                   CTrafficRecorder::EFormat e_format,
+                                                   bool b_per_robot) {
+   std::vector<std::vector<UInt32> > vecRows;
+   CTrafficRecorder cRecorder;
+   cRecorder.Open(pch_file, e_format, b_per_robot);
+   for(UInt32 t = 0; t < CHECK_TICKS; ++t) {
+      for(UInt32 r = 0; r < (b_per_robot ? CHECK_ROBOTS : 1); ++r) {
+         /* The robot index is ignored when the rows are not per robot */
+         CNavController::STraffic s = MakeTraffic(t, r);
+         cRecorder.Write(t, r, s);
+         std::vector<UInt32> vecRow(1, t);
+         if(b_per_robot) vecRow.push_back(r);
+         vecRow.insert(vecRow.end(), s.Sent, s.Sent + CNavController::MESSAGE_COUNT);
+         vecRow.push_back(s.BytesOnAir);
+         vecRow.push_back(s.Received);
+         vecRow.push_back(s.OutOfRange);
+         vecRow.push_back(s.Dropped);
+         vecRow.insert(vecRow.end(), s.Records, s.Records + CNavController::MESSAGE_COUNT);
+         vecRows.push_back(vecRow);
+      }
+   }
+   cRecorder.Close();
+   return vecRows;
+}
+
+/****************************************/
+/****************************************/
+
+/* Reads back a CSV file, returns the number of mismatches */
+static size_t CheckCSV(const char* pch_file,
+                       bool b_per_robot,
+                       const std::vector<std::vector<UInt32> >& vec_rows) {
+   std::ifstream cInput(pch_file);
+   std::string strLine;
+   size_t unMismatches = 0;
+   std::string strHeader = std::string(b_per_robot ? "tick,robot," : "tick,") + CSV_FIELDS;
+   if(!std::getline(cInput, strLine) || strLine != strHeader) {
+      std::printf("csv header \"%s\", expected \"%s\"\n", strLine.c_str(), strHeader.c_str());
+      ++unMismatches;
+   }
+   for(size_t i = 0; i < vec_rows.size(); ++i) {
+      if(!std::getline(cInput, strLine)) {
+         return unMismatches + vec_rows.size() - i;
+      }
+      std::istringstream cFields(strLine);
+      std::string strField;
+      std::vector<UInt32> vecRead;
+      while(std::getline(cFields, strField, ',')) {
+         vecRead.push_back(std::strtoul(strField.c_str(), NULL, 10));
+      }
+      if(vecRead != vec_rows[i]) {
+         std::printf("csv row %zu is \"%s\"\n", i, strLine.c_str());
+         ++unMismatches;
+      }
+   }
+   /* Nothing must follow the last row */
+   if(std::getline(cInput, strLine)) {
+      ++unMismatches;
+   }
+   return unMismatches;
+}
+
+/****************************************/
+/****************************************/
+
+/* Reads back a binary file, returns the number of mismatches */
+static size_t CheckBinary(const char* pch_file,
+                          bool b_per_robot,
+                          const std::vector<std::vector<UInt32> >& vec_rows) {
+   std::ifstream cInput(pch_file, std::ios::binary);
+   char pchMagic[8];
+   UInt32 unFields = 0;
+   UInt32 unExpectedFields = b_per_robot ? 12 : 11;
+   cInput.read(pchMagic, 8);
+   cInput.read(reinterpret_cast<char*>(&unFields), sizeof(unFields));
+   if(!cInput || std::memcmp(pchMagic, "NAVTRAF1", 8) != 0 || unFields != unExpectedFields) {
+      std::printf("binary header has %u fields, expected %u\n", unFields, unExpectedFields);
+      return vec_rows.size() + 1;
+   }
+   size_t unMismatches = 0;
+   std::vector<UInt32> vecRead(unFields);
+   for(size_t i = 0; i < vec_rows.size(); ++i) {
+      if(!cInput.read(reinterpret_cast<char*>(&vecRead[0]), unFields * sizeof(UInt32))) {
+         return unMismatches + vec_rows.size() - i;
+      }
+      if(vecRead != vec_rows[i]) {
+         std::printf("binary row %zu differs\n", i);
+         ++unMismatches;
+      }
+   }
+   /* Nothing must follow the last row */
+   if(cInput.peek() != std::ifstream::traits_type::eof()) {
+      ++unMismatches;
+   }
+   return unMismatches;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   const char* pchFile = (argc > 1) ? argv[1] : "traffic_recorder_check.tmp";
+   size_t unMismatches = 0;
+   try {
+      for(int nPerRobot = 0; nPerRobot < 2; ++nPerRobot) {
+         std::vector<std::vector<UInt32> > vecRows =
+            WriteFile(pchFile, CTrafficRecorder::FORMAT_CSV, nPerRobot != 0);
+         unMismatches += CheckCSV(pchFile, nPerRobot != 0, vecRows);
+         vecRows = WriteFile(pchFile, CTrafficRecorder::FORMAT_BINARY, nPerRobot != 0);
+         unMismatches += CheckBinary(pchFile, nPerRobot != 0, vecRows);
+      }
+   }
+   catch(CARGoSException& ex) {
+      std::printf("%s\n", ex.what());
+      std::remove(pchFile);
+      return 1;
+   }
+   std::remove(pchFile);
+   if(unMismatches > 0) {
+      std::printf("%zu mismatches\n", unMismatches);
+      return 1;
+   }
+   std::printf("traffic files read back in csv and binary, with and without per-robot rows\n");
+   return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * Cost and size of recording the trajectory of every robot on every tick,
+ * and speed of reading it back through the memory-mapped reader.
+ *
+ * Writes ticks x robots robot states with CTrajectoryRecorder, the robots
+ * driving around like foot-bots, then reads the file back in order (all
+ * columns, and one column) and at random frames. Reported: ns per robot
+ * and tick for writing and scanning, us per random frame, and the bytes
+ * per robot and tick, against 36 for the same values as raw floats.
+ * trajectory_check checks that what is read back is what was written.
+ * Usage: trajectory_benchmark [ticks] [robots] [file]
+ */
+
+#include <loop_functions/nav_loop_functions/trajectory_recorder.h>
+#include <tools/trajectory_reader.h>
+
+#include "trajectory_swarm.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock TClock;
+
+/****************************************/
+/****************************************/
+
+static long FileSize(const char* pch_file) {
+   std::ifstream cFile(pch_file, std::ios::binary | std::ios::ate);
+   return cFile ? static_cast<long>(cFile.tellg()) : -1;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unTicks = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 2000;
+   UInt32 unRobots = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 1000;
+   const char* pchFile = (argc > 3) ? argv[3] : "trajectory_benchmark.bin";
+   if(unTicks == 0 || unRobots == 0) {
+      std::fprintf(stderr, "Usage: %s [ticks] [robots] [file]\n", argv[0]);
+      return 1;
+   }
+   Real fRobotTicks = static_cast<Real>(unTicks) * unRobots;
+   size_t unFrameSize = static_cast<size_t>(TRAJECTORY_COLUMNS) * unRobots;
+   /* Simulate first, so that only the recorder is timed */
+   CSwarm cSwarm(unRobots);
+   std::vector<Real> vecWritten(unFrameSize * unTicks);
+   for(UInt32 t = 0; t < unTicks; ++t) {
+      cSwarm.Step();
+      std::copy(cSwarm.GetValues(), cSwarm.GetValues() + unFrameSize, &vecWritten[t * unFrameSize]);
+   }
+   std::vector<std::string> vecIds(unRobots);
+   std::vector<UInt32> vecRoles(unRobots, 0);
+   for(UInt32 r = 0; r < unRobots; ++r) {
+      vecIds[r] = "fb" + std::to_string(r);
+   }
+   std::printf("%u ticks of %u robots\n", unTicks, unRobots);
+   std::printf("%-22s %14s\n", "", "ns per robot");
+   try {
+      /* Write */
+      TClock::time_point tStart = TClock::now();
+      {
+         CTrajectoryRecorder cRecorder;
+         cRecorder.Open(pchFile, vecIds, vecRoles, 0);
+         for(UInt32 t = 0; t < unTicks; ++t) {
+            cRecorder.Write(t + 1, &vecWritten[t * unFrameSize]);
+         }
+         cRecorder.Close();
+      }
+      std::chrono::duration<double, std::nano> tElapsed = TClock::now() - tStart;
+      std::printf("%-22s %14.1f\n", "write", tElapsed.count() / fRobotTicks);
+      /* Sequential scans */
+      std::vector<Real> vecFrame(unFrameSize);
+      Real fSum = 0.0;
+      {
+         CTrajectoryReader cReader;
+         tStart = TClock::now();
+         cReader.Open(pchFile);
+         for(size_t i = 0; i < cReader.GetFrames(); ++i) {
+            cReader.ReadFrame(i, &vecFrame[0]);
+            fSum += vecFrame[0];
+         }
+         tElapsed = TClock::now() - tStart;
+         std::printf("%-22s %14.1f\n", "scan, all columns", tElapsed.count() / fRobotTicks);
+      }
+      {
+         CTrajectoryReader cReader;
+         tStart = TClock::now();
+         cReader.Open(pchFile);
+         for(size_t i = 0; i < cReader.GetFrames(); ++i) {
+            cReader.ReadColumn(i, TRAJECTORY_X, &vecFrame[0]);
+            fSum += vecFrame[0];
+         }
+         tElapsed = TClock::now() - tStart;
+         std::printf("%-22s %14.1f\n", "scan, one column", tElapsed.count() / fRobotTicks);
+      }
+      /* Random frames, decoded from their keyframe */
+      {
+         CTrajectoryReader cReader;
+         cReader.Open(pchFile);
+         std::mt19937 cRNG(7);
+         std::uniform_int_distribution<size_t> cFrame(0, cReader.GetFrames() - 1);
+         UInt32 unAccesses = 1000;
+         tStart = TClock::now();
+         for(UInt32 i = 0; i < unAccesses; ++i) {
+            cReader.ReadFrame(cFrame(cRNG), &vecFrame[0]);
+            fSum += vecFrame[0];
+         }
+         std::chrono::duration<double, std::micro> tMicro = TClock::now() - tStart;
+         std::printf("%-22s %14.1f us per frame\n", "random frame", tMicro.count() / unAccesses);
+      }
+      std::printf("%-22s %14.2f bytes per robot and tick, %.1f%% of raw floats (checksum %g)\n",
+                  "file", FileSize(pchFile) / fRobotTicks,
+                  100.0 * FileSize(pchFile) / (fRobotTicks * TRAJECTORY_COLUMNS * sizeof(float)), fSum);
+      std::remove(pchFile);
+   }
+   catch(CARGoSException& ex) {
+      std::printf("%s\n", ex.what());
+      return 1;
+   }
+   return 0;
+}
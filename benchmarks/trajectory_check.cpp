@@ -0,0 +1,149 @@
+/*
+ * Regression check of the trajectory format: writes a few hundred ticks
+ * of a small simulated swarm with CTrajectoryRecorder, reads every frame
+ * back with CTrajectoryReader and compares every value with what was
+ * written, within the quantisation step. Then it cuts the index and the
+ * footer off the file, as left by a run that crashed, and checks that
+ * the reader finds the same frames by scanning them. Exits with 1 on a
+ * mismatch, so that ctest can run it.
+ * Usage: trajectory_check [file]
+ */
+
+#include <loop_functions/nav_loop_functions/trajectory_recorder.h>
+#include <tools/trajectory_reader.h>
+
+#include "trajectory_swarm.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+/* Size of the swarm; the ticks span several keyframes */
+static const UInt32 CHECK_TICKS = 300;
+static const UInt32 CHECK_ROBOTS = 40;
+static const UInt32 CHECK_KEYFRAME = 64;
+
+/****************************************/
+/****************************************/
+
+static long FileSize(const char* pch_file) {
+   std::ifstream cFile(pch_file, std::ios::binary | std::ios::ate);
+   return cFile ? static_cast<long>(cFile.tellg()) : -1;
+}
+
+/****************************************/
+/****************************************/
+
+/* Returns true if a value read back is the one written, within the quantisation step */
+static bool Matches(UInt32 un_column,
+                    Real f_written,
+                    Real f_read) {
+   if(std::isnan(f_written) || std::isnan(f_read)) {
+      return std::isnan(f_written) && std::isnan(f_read);
+   }
+   Real fError = std::fabs(f_written - f_read);
+   if(un_column == TRAJECTORY_YAW) {
+      fError = std::fmod(fError, 2.0 * 3.14159265358979);
+      fError = std::min(fError, 2.0 * 3.14159265358979 - fError);
+   }
+   return fError <= 0.5 / GetTrajectoryScale(un_column) + 1e-9;
+}
+
+/****************************************/
+/****************************************/
+
+/* Reads every frame back and checks it; returns the number of mismatches */
+static UInt32 CheckFile(const char* pch_file,
+                        const std::vector<Real>& vec_written,
+                        UInt32 un_ticks,
+                        UInt32 un_robots,
+                        bool b_truncated) {
+   CTrajectoryReader cReader;
+   cReader.Open(pch_file);
+   UInt32 unErrors = 0;
+   if(cReader.GetFrames() != un_ticks || cReader.GetRobots() != un_robots || cReader.IsTruncated() != b_truncated) {
+      std::printf("read %zu frames of %u robots (truncated %d), wrote %u of %u (truncated %d)\n",
+                  cReader.GetFrames(), cReader.GetRobots(), cReader.IsTruncated(),
+                  un_ticks, un_robots, b_truncated);
+      return 1;
+   }
+   size_t unFrameSize = static_cast<size_t>(TRAJECTORY_COLUMNS) * un_robots;
+   std::vector<Real> vecFrame(unFrameSize);
+   for(UInt32 t = 0; t < un_ticks; ++t) {
+      if(cReader.GetTick(t) != t + 1 || cReader.FindFrame(t + 1) != t) {
+         std::printf("frame %u has tick %u\n", t, cReader.GetTick(t));
+         ++unErrors;
+      }
+      cReader.ReadFrame(t, &vecFrame[0]);
+      for(size_t i = 0; i < unFrameSize; ++i) {
+         UInt32 unColumn = i / un_robots;
+         if(!Matches(unColumn, vec_written[t * unFrameSize + i], vecFrame[i])) {
+            if(unErrors < 10) {
+               std::printf("tick %u, robot %zu, %s: wrote %g, read %g\n",
+                           t + 1, i % un_robots, GetTrajectoryColumnName(unColumn),
+                           vec_written[t * unFrameSize + i], vecFrame[i]);
+            }
+            ++unErrors;
+         }
+      }
+   }
+   return unErrors;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   const char* pchFile = (argc > 1) ? argv[1] : "trajectory_check.bin";
+   size_t unFrameSize = static_cast<size_t>(TRAJECTORY_COLUMNS) * CHECK_ROBOTS;
+   CSwarm cSwarm(CHECK_ROBOTS);
+   std::vector<Real> vecWritten(unFrameSize * CHECK_TICKS);
+   std::vector<std::string> vecIds(CHECK_ROBOTS);
+   std::vector<UInt32> vecRoles(CHECK_ROBOTS, 0);
+   for(UInt32 r = 0; r < CHECK_ROBOTS; ++r) {
+      vecIds[r] = "fb" + std::to_string(r);
+   }
+   try {
+      CTrajectoryRecorder cRecorder;
+      cRecorder.Open(pchFile, vecIds, vecRoles, 0, CHECK_KEYFRAME);
+      for(UInt32 t = 0; t < CHECK_TICKS; ++t) {
+         cSwarm.Step();
+         std::copy(cSwarm.GetValues(), cSwarm.GetValues() + unFrameSize, &vecWritten[t * unFrameSize]);
+         cRecorder.Write(t + 1, &vecWritten[t * unFrameSize]);
+      }
+      cRecorder.Close();
+      /* Read everything back, then the file without its index */
+      UInt32 unErrors = CheckFile(pchFile, vecWritten, CHECK_TICKS, CHECK_ROBOTS, false);
+      long nSize = FileSize(pchFile);
+      UInt64 unIndex = 0;
+      {
+         std::ifstream cFile(pchFile, std::ios::binary);
+         cFile.seekg(nSize - static_cast<long>(TRAJECTORY_FOOTER_SIZE));
+         cFile.read(reinterpret_cast<char*>(&unIndex), sizeof(unIndex));
+      }
+      if(::truncate(pchFile, unIndex) != 0) {
+         std::printf("cannot truncate %s\n", pchFile);
+         return 1;
+      }
+      unErrors += CheckFile(pchFile, vecWritten, CHECK_TICKS, CHECK_ROBOTS, true);
+      std::remove(pchFile);
+      if(unErrors > 0) {
+         std::printf("%u mismatches\n", unErrors);
+         return 1;
+      }
+   }
+   catch(CARGoSException& ex) {
+      std::printf("%s\n", ex.what());
+      return 1;
+   }
+   std::printf("trajectory of %u robots over %u ticks read back, with and without index\n",
+               CHECK_ROBOTS, CHECK_TICKS);
+   return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Simulated foot-bots for the trajectory benchmark and check: the state
+ * the nav_loop_functions record, column by column, for robots driving
+ * straight or turning on the spot.
+ */
+
+#ifndef TRAJECTORY_SWARM_H
+#define TRAJECTORY_SWARM_H
+
+#include <loop_functions/nav_loop_functions/trajectory_format.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+/* State of the simulated robots, column by column */
+class CSwarm {
+
+public:
+
+   CSwarm(UInt32 un_robots) :
+      m_unRobots(un_robots),
+      m_vecValues(static_cast<size_t>(TRAJECTORY_COLUMNS) * un_robots),
+      m_cRNG(42) {
+      std::uniform_real_distribution<Real> cPosition(-10.0, 10.0);
+      std::uniform_real_distribution<Real> cAngle(-3.14, 3.14);
+      for(UInt32 r = 0; r < m_unRobots; ++r) {
+         Value(TRAJECTORY_X, r) = cPosition(m_cRNG);
+         Value(TRAJECTORY_Y, r) = cPosition(m_cRNG);
+         Value(TRAJECTORY_YAW, r) = cAngle(m_cRNG);
+         Value(TRAJECTORY_BEST_NAV_DIST, r) = 0.0;
+         Value(TRAJECTORY_BEST_NAV_HEADING, r) = 0.0;
+         Value(TRAJECTORY_DISTANCE_STAR, r) = -1.0;
+         /* A third of the robots never hear of the target */
+         Value(TRAJECTORY_TARGET_DISTANCE, r) = (r % 3 == 0) ?
+            std::numeric_limits<Real>::quiet_NaN() : 20.0 * cPosition(m_cRNG) + 300.0;
+      }
+   }
+
+   /* Moves every robot by one tick of 0.1 s */
+   void Step() {
+      std::uniform_real_distribution<Real> cUniform(0.0, 1.0);
+      for(UInt32 r = 0; r < m_unRobots; ++r) {
+         /* Straight at 5 cm/s, or turning on the spot */
+         bool bTurn = cUniform(m_cRNG) < 0.2;
+         Real fLeft = 5.0, fRight = bTurn ? -5.0 : 5.0;
+         Value(TRAJECTORY_LEFT_WHEEL, r) = fLeft;
+         Value(TRAJECTORY_RIGHT_WHEEL, r) = fRight;
+         Real& fYaw = Value(TRAJECTORY_YAW, r);
+         if(bTurn) {
+            fYaw += 0.069;
+            if(fYaw >= 3.14159) fYaw -= 2.0 * 3.14159265358979;
+         }
+         else {
+            Value(TRAJECTORY_X, r) += 0.005 * std::cos(fYaw);
+            Value(TRAJECTORY_Y, r) += 0.005 * std::sin(fYaw);
+         }
+         Value(TRAJECTORY_BEST_NAV_DIST, r) = bTurn ? 40.0 * cUniform(m_cRNG) : Value(TRAJECTORY_BEST_NAV_DIST, r) - 0.5;
+         Value(TRAJECTORY_BEST_NAV_HEADING, r) = bTurn ? cUniform(m_cRNG) - 0.5 : Value(TRAJECTORY_BEST_NAV_HEADING, r);
+         if(bTurn) {
+            Value(TRAJECTORY_DISTANCE_STAR, r) = 500.0 * cUniform(m_cRNG);
+         }
+      }
+   }
+
+   inline Real& Value(UInt32 un_column,
+                      UInt32 un_robot) {
+      return m_vecValues[static_cast<size_t>(un_column) * m_unRobots + un_robot];
+   }
+
+   inline const Real* GetValues() const {
+      return &m_vecValues[0];
+   }
+
+private:
+
+   UInt32 m_unRobots;
+   std::vector<Real> m_vecValues;
+   std::mt19937 m_cRNG;
+
+};
+
+#endif
@@ -0,0 +1,228 @@
+/*
+ * Regression check of the statistics of the trial runner (see
+ * embedding/trial_runner/trial_statistics.h): the Student quantile
+ * against its tables, the order statistics the median interval picks,
+ * the relative width of an interval, and the Kaplan-Meier curve and
+ * restricted mean of censored trials. Exits with 1 on a mismatch, so
+ * that ctest can run it.
+ * Usage: trial_statistics_check
+ */
+
+#include <embedding/trial_runner/trial_statistics.h>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+/****************************************/
+/****************************************/
+
+/* Returns 0 if f_value is within f_tolerance of f_expected, prints it and returns 1 otherwise */
+static size_t Expect(const char* pch_what,
+                     Real f_value,
+                     Real f_expected,
+                     Real f_tolerance) {
+   if(std::fabs(f_value - f_expected) <= f_tolerance) {
+      return 0;
+   }
+   std::printf("%s is %g, expected %g\n", pch_what, f_value, f_expected);
+   return 1;
+}
+
+/****************************************/
+/****************************************/
+
+/* 97.5% quantile of the Student t distribution, against the tables */
+static size_t CheckStudentQuantile() {
+   size_t unFailures = 0;
+   unFailures += Expect("t quantile, 1 dof", CTrialStatistics::StudentQuantile(1), 12.706, 0.001);
+   /* From 5 dof up the quantile is an expansion, within 0.2% */
+   unFailures += Expect("t quantile, 5 dof", CTrialStatistics::StudentQuantile(5), 2.571, 0.002 * 2.571);
+   unFailures += Expect("t quantile, 30 dof", CTrialStatistics::StudentQuantile(30), 2.042, 0.002 * 2.042);
+   return unFailures;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * The median interval needs 8 samples; from there its bounds are the
+ * order statistics of ranks n/2 - 0.98 sqrt(n) rounded down and
+ * n/2 + 1 + 0.98 sqrt(n) rounded up. The samples are 1...n out of
+ * order, so each is its own rank.
+ */
+static size_t CheckMedianInterval() {
+   size_t unFailures = 0;
+   CTrialStatistics::SInterval sInterval;
+   for(size_t unN = 0; unN < 8; ++unN) {
+      std::vector<Real> vecSamples;
+      for(size_t i = 0; i < unN; ++i) {
+         vecSamples.push_back(i + 1);
+      }
+      if(CTrialStatistics::Compute(CTrialStatistics::STAT_MEDIAN, vecSamples, sInterval)) {
+         std::printf("median interval of %zu samples computed, needs 8\n", unN);
+         ++unFailures;
+      }
+   }
+   /* Samples, median and 1-based ranks of the bounds */
+   static const size_t punN[] = { 8, 9, 20, 100 };
+   static const Real pfMedian[] = { 4.5, 5.0, 10.5, 50.5 };
+   static const size_t punLower[] = { 1, 1, 5, 40 };
+   static const size_t punUpper[] = { 8, 9, 16, 61 };
+   for(size_t k = 0; k < sizeof(punN) / sizeof(punN[0]); ++k) {
+      std::vector<Real> vecSamples;
+      for(size_t i = 0; i < punN[k]; ++i) {
+         /* 7 is prime to every n above, so this visits 1...n once each */
+         vecSamples.push_back((i * 7) % punN[k] + 1);
+      }
+      if(!CTrialStatistics::Compute(CTrialStatistics::STAT_MEDIAN, vecSamples, sInterval) ||
+         sInterval.Estimate != pfMedian[k] ||
+         sInterval.Lower != punLower[k] ||
+         sInterval.Upper != punUpper[k]) {
+         std::printf("median interval of %zu samples is %g [%g, %g], expected %g [%zu, %zu]\n",
+                     punN[k], sInterval.Estimate, sInterval.Lower, sInterval.Upper,
+                     pfMedian[k], punLower[k], punUpper[k]);
+         ++unFailures;
+      }
+   }
+   return unFailures;
+}
+
+/****************************************/
+/****************************************/
+
+/* Width relative to the estimate, or the largest value if it has none */
+static size_t CheckRelativeWidth() {
+   size_t unFailures = 0;
+   CTrialStatistics::SInterval sInterval = { 10.0, 8.0, 13.0 };
+   unFailures += Expect("relative width of 10 [8, 13]", CTrialStatistics::RelativeWidth(sInterval), 0.5, 1e-12);
+   sInterval.Estimate = -10.0;
+   unFailures += Expect("relative width of -10 [8, 13]", CTrialStatistics::RelativeWidth(sInterval), 0.5, 1e-12);
+   sInterval.Estimate = 0.0;
+   unFailures += Expect("relative width of 0 [8, 13]", CTrialStatistics::RelativeWidth(sInterval),
+                        std::numeric_limits<Real>::max(), 0.0);
+   sInterval.Estimate = 10.0;
+   sInterval.Upper = std::numeric_limits<Real>::infinity();
+   unFailures += Expect("relative width of 10 [8, inf]", CTrialStatistics::RelativeWidth(sInterval),
+                        std::numeric_limits<Real>::max(), 0.0);
+   return unFailures;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Kaplan-Meier curve of the 6-MP arm of the leukaemia trial of Gehan
+ * (1965), as tabulated in the survival analysis textbooks: 21 patients,
+ * 9 relapses, the others censored.
+ */
+static size_t CheckKaplanMeier() {
+   size_t unFailures = 0;
+   static const Real pfEvents[] = { 6, 6, 6, 7, 10, 13, 16, 22, 23 };
+   static const Real pfCensored[] = { 6, 9, 10, 11, 17, 19, 20, 25, 32, 32, 34, 35 };
+   /* Survival after each time with relapses */
+   static const Real pfTimes[] = { 6, 7, 10, 13, 16, 22, 23 };
+   static const Real pfSurvival[] = { 0.857, 0.807, 0.753, 0.690, 0.627, 0.538, 0.448 };
+   std::vector<Real> vecTimes;
+   std::vector<bool> vecCensored;
+   /* Interleaved, as the trials come back */
+   for(size_t i = 0; i < 12; ++i) {
+      vecTimes.push_back(pfCensored[i]);
+      vecCensored.push_back(true);
+      if(i < 9) {
+         vecTimes.push_back(pfEvents[i]);
+         vecCensored.push_back(false);
+      }
+   }
+   std::vector<CTrialStatistics::SSurvivalStep> vecCurve;
+   CTrialStatistics::KaplanMeier(vecTimes, vecCensored, vecCurve);
+   size_t unStep = 0;
+   for(size_t i = 0; i < vecCurve.size(); ++i) {
+      if(vecCurve[i].Events == 0) continue;
+      if(unStep >= 7 || vecCurve[i].Time != pfTimes[unStep]) {
+         std::printf("Kaplan-Meier step with relapses at %g\n", vecCurve[i].Time);
+         return unFailures + 1;
+      }
+      char pchWhat[64];
+      std::snprintf(pchWhat, sizeof(pchWhat), "Kaplan-Meier survival at %g", vecCurve[i].Time);
+      unFailures += Expect(pchWhat, vecCurve[i].Survival, pfSurvival[unStep], 0.0005);
+      ++unStep;
+   }
+   if(unStep != 7) {
+      std::printf("Kaplan-Meier curve has %zu steps with relapses, expected 7\n", unStep);
+      ++unFailures;
+   }
+   /* At 6, the censored patient is still at risk: events come first */
+   if(vecCurve.empty() || vecCurve[0].AtRisk != 21 || vecCurve[0].Events != 3 || vecCurve[0].Censored != 1) {
+      std::printf("Kaplan-Meier first step is wrong\n");
+      ++unFailures;
+   }
+   unFailures += Expect("Kaplan-Meier median", CTrialStatistics::SurvivalMedian(vecCurve), 23.0, 0.0);
+   return unFailures;
+}
+
+/****************************************/
+/****************************************/
+
+/* Restricted mean without censoring, and with every trial censored */
+static size_t CheckRestrictedMean() {
+   size_t unFailures = 0;
+   std::vector<CTrialStatistics::SSurvivalStep> vecCurve;
+   /* Without censoring, the restricted mean is the mean */
+   std::vector<Real> vecTimes;
+   vecTimes.push_back(3.0);
+   vecTimes.push_back(1.0);
+   vecTimes.push_back(4.0);
+   vecTimes.push_back(2.0);
+   CTrialStatistics::KaplanMeier(vecTimes, std::vector<bool>(4, false), vecCurve);
+   unFailures += Expect("restricted mean of 1, 2, 3, 4", CTrialStatistics::RestrictedMean(vecCurve), 2.5, 1e-12);
+   unFailures += Expect("Kaplan-Meier median of 1, 2, 3, 4", CTrialStatistics::SurvivalMedian(vecCurve), 2.0, 0.0);
+   /*
+    * Every trial censored: nobody is known to have reached the target, the
+    * curve stays at 1, and the restricted mean is the longest trial
+    */
+   CTrialStatistics::KaplanMeier(vecTimes, std::vector<bool>(4, true), vecCurve);
+   bool bOk = (vecCurve.size() == 4);
+   for(size_t i = 0; bOk && i < vecCurve.size(); ++i) {
+      bOk = (vecCurve[i].Events == 0 && vecCurve[i].Censored == 1 && vecCurve[i].Survival == 1.0);
+   }
+   if(!bOk) {
+      std::printf("Kaplan-Meier curve of censored trials does not stay at 1\n");
+      ++unFailures;
+   }
+   unFailures += Expect("restricted mean of censored trials", CTrialStatistics::RestrictedMean(vecCurve), 4.0, 1e-12);
+   unFailures += Expect("Kaplan-Meier median of censored trials", CTrialStatistics::SurvivalMedian(vecCurve),
+                        std::numeric_limits<Real>::max(), 0.0);
+   /* Censored times count as infinite in the intervals: no mean, and no median above half of them */
+   std::vector<Real> vecSamples(20, std::numeric_limits<Real>::infinity());
+   CTrialStatistics::SInterval sInterval;
+   if(CTrialStatistics::Compute(CTrialStatistics::STAT_MEAN, vecSamples, sInterval)) {
+      std::printf("mean interval of censored trials computed\n");
+      ++unFailures;
+   }
+   if(CTrialStatistics::Compute(CTrialStatistics::STAT_MEDIAN, vecSamples, sInterval) &&
+      CTrialStatistics::RelativeWidth(sInterval) != std::numeric_limits<Real>::max()) {
+      std::printf("median interval of censored trials has a finite width\n");
+      ++unFailures;
+   }
+   return unFailures;
+}
+
+/****************************************/
+/****************************************/
+
+int main() {
+   size_t unFailures = 0;
+   unFailures += CheckStudentQuantile();
+   unFailures += CheckMedianInterval();
+   unFailures += CheckRelativeWidth();
+   unFailures += CheckKaplanMeier();
+   unFailures += CheckRestrictedMean();
+   if(unFailures > 0) {
+      std::printf("%zu failed checks\n", unFailures);
+      return 1;
+   }
+   std::printf("trial statistics match their tables\n");
+   return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * Arena of random walls for the wall index benchmark and check: an outer
+ * wall around a square, and inner walls of random position, length and
+ * rotation, mostly axis-aligned like those of the mazes.
+ */
+
+#ifndef WALL_ARENA_H
+#define WALL_ARENA_H
+
+#include <controllers/nav_common/wall_index.h>
+
+#include <random>
+
+/* Side of the arena, in m */
+static const Real ARENA_SIZE = 10.0;
+
+/* Largest distance between the points of a pair, in m */
+static const Real COMM_RANGE = 3.0;
+
+/* Height of the points, in m: below the walls */
+static const Real HEIGHT = 0.1;
+
+/****************************************/
+/****************************************/
+
+static void BuildArena(CWallIndex& c_walls,
+                       UInt32 un_walls,
+                       std::mt19937& c_rng) {
+   std::uniform_real_distribution<Real> cPosition(0.0, ARENA_SIZE);
+   std::uniform_real_distribution<Real> cLength(0.5, 2.5);
+   std::uniform_real_distribution<Real> cAngle(0.0, ARGOS_PI);
+   Real fHalf = ARENA_SIZE / 2.0;
+   c_walls.AddWall(CVector2(fHalf, 0.0), CVector2(ARENA_SIZE, 0.1), CRadians(0.0), 0.5);
+   c_walls.AddWall(CVector2(fHalf, ARENA_SIZE), CVector2(ARENA_SIZE, 0.1), CRadians(0.0), 0.5);
+   c_walls.AddWall(CVector2(0.0, fHalf), CVector2(0.1, ARENA_SIZE), CRadians(0.0), 0.5);
+   c_walls.AddWall(CVector2(ARENA_SIZE, fHalf), CVector2(0.1, ARENA_SIZE), CRadians(0.0), 0.5);
+   for(UInt32 i = 0; i < un_walls; ++i) {
+      /* Mostly axis-aligned, like the walls of the mazes */
+      Real fAngle = (i % 4 == 3) ? cAngle(c_rng) : (i % 2) * ARGOS_PI / 2.0;
+      c_walls.AddWall(CVector2(cPosition(c_rng), cPosition(c_rng)),
+                      CVector2(cLength(c_rng), 0.1),
+                      CRadians(fAngle),
+                      0.5);
+   }
+}
+
+#endif
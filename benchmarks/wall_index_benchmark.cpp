@@ -0,0 +1,65 @@
+/*
+ * Cost of the line-of-sight test of the nav_walls range-and-bearing
+ * sensor.
+ *
+ * Builds a square arena with an outer wall and a number of inner walls
+ * of random position, length and rotation, and tests pairs of points
+ * closer than the communication range, as robot pairs would be. Reported
+ * per test: ns against every wall and ns with the grid of CWallIndex.
+ * wall_index_check checks that the two agree.
+ * Usage: wall_index_benchmark [walls] [queries] [cell_size]
+ */
+
+#include <controllers/nav_common/wall_index.h>
+
+#include "wall_arena.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock TClock;
+
+int main(int argc, char** argv) {
+   UInt32 unWalls = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 40;
+   UInt32 unQueries = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 1000000;
+   Real fCellSize = (argc > 3) ? std::strtod(argv[3], NULL) : 0.25;
+   std::mt19937 cRNG(12345);
+   CWallIndex cWalls;
+   BuildArena(cWalls, unWalls, cRNG);
+   cWalls.Build(fCellSize);
+   /* Pairs of points within range */
+   std::uniform_real_distribution<Real> cPosition(0.0, ARENA_SIZE);
+   std::uniform_real_distribution<Real> cDistance(0.0, COMM_RANGE);
+   std::uniform_real_distribution<Real> cAngle(-ARGOS_PI, ARGOS_PI);
+   std::vector<CVector2> vecFrom(unQueries), vecTo(unQueries);
+   for(UInt32 i = 0; i < unQueries; ++i) {
+      vecFrom[i] = CVector2(cPosition(cRNG), cPosition(cRNG));
+      vecTo[i] = vecFrom[i];
+      vecTo[i] += CVector2(cDistance(cRNG), CRadians(cAngle(cRNG)));
+   }
+   std::vector<char> vecBruteForce(unQueries), vecIndexed(unQueries);
+   TClock::time_point tStart = TClock::now();
+   for(UInt32 i = 0; i < unQueries; ++i) {
+      vecBruteForce[i] = cWalls.IsOccludedBruteForce(vecFrom[i], vecTo[i], HEIGHT);
+   }
+   std::chrono::duration<double, std::nano> tBruteForce = TClock::now() - tStart;
+   tStart = TClock::now();
+   for(UInt32 i = 0; i < unQueries; ++i) {
+      vecIndexed[i] = cWalls.IsOccluded(vecFrom[i], vecTo[i], HEIGHT);
+   }
+   std::chrono::duration<double, std::nano> tIndexed = TClock::now() - tStart;
+   size_t unOccluded = 0;
+   for(UInt32 i = 0; i < unQueries; ++i) {
+      unOccluded += vecBruteForce[i];
+   }
+   std::printf("%zu walls, %u pairs within %.1f m, %.1f%% occluded, cells of %.2f m\n",
+               cWalls.GetNumWalls(), unQueries, COMM_RANGE,
+               100.0 * unOccluded / unQueries, fCellSize);
+   std::printf("%-12s %12s\n", "test", "ns/pair");
+   std::printf("%-12s %12.1f\n", "all walls", tBruteForce.count() / unQueries);
+   std::printf("%-12s %12.1f\n", "grid", tIndexed.count() / unQueries);
+   return 0;
+}
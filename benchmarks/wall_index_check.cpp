@@ -0,0 +1,80 @@
+/*
+ * Regression check of the line-of-sight test of the nav_walls
+ * range-and-bearing sensor: builds arenas of random walls from a few
+ * fixed seeds and compares, for pairs of points within range, the grid
+ * of CWallIndex with the test against every wall, for several cell
+ * sizes. An index without walls must never occlude. Exits with 1 on a
+ * mismatch, so that ctest can run it.
+ * Usage: wall_index_check
+ */
+
+#include <controllers/nav_common/wall_index.h>
+
+#include "wall_arena.h"
+
+#include <cstdio>
+#include <random>
+
+/* Seeds of the arenas, and pairs tested per arena and cell size */
+static const UInt32 CHECK_SEEDS[] = { 12345, 1, 777 };
+static const UInt32 CHECK_QUERIES = 20000;
+
+/* Inner walls of the arenas */
+static const UInt32 CHECK_WALLS = 40;
+
+/* Side of the grid cells, in m: smaller than, close to and larger than the walls */
+static const Real CHECK_CELL_SIZES[] = { 0.1, 0.25, 1.0 };
+
+/****************************************/
+/****************************************/
+
+int main() {
+   size_t unMismatches = 0;
+   size_t unOccluded = 0;
+   size_t unTests = 0;
+   std::uniform_real_distribution<Real> cPosition(0.0, ARENA_SIZE);
+   std::uniform_real_distribution<Real> cDistance(0.0, COMM_RANGE);
+   std::uniform_real_distribution<Real> cAngle(-ARGOS_PI, ARGOS_PI);
+   for(size_t s = 0; s < sizeof(CHECK_SEEDS) / sizeof(CHECK_SEEDS[0]); ++s) {
+      for(size_t c = 0; c < sizeof(CHECK_CELL_SIZES) / sizeof(CHECK_CELL_SIZES[0]); ++c) {
+         std::mt19937 cRNG(CHECK_SEEDS[s]);
+         CWallIndex cWalls;
+         BuildArena(cWalls, CHECK_WALLS, cRNG);
+         cWalls.Build(CHECK_CELL_SIZES[c]);
+         for(UInt32 i = 0; i < CHECK_QUERIES; ++i) {
+            CVector2 cFrom(cPosition(cRNG), cPosition(cRNG));
+            CVector2 cTo(cFrom);
+            /* One pair in four is axis-aligned, along the walls of the mazes */
+            if(i % 4 == 0) {
+               cTo += CVector2(cDistance(cRNG), CRadians((i % 8 == 0) ? 0.0 : ARGOS_PI / 2.0));
+            }
+            else {
+               cTo += CVector2(cDistance(cRNG), CRadians(cAngle(cRNG)));
+            }
+            bool bBruteForce = cWalls.IsOccludedBruteForce(cFrom, cTo, HEIGHT);
+            if(bBruteForce != cWalls.IsOccluded(cFrom, cTo, HEIGHT)) {
+               std::printf("seed %u, cells of %.2f m: (%f,%f)-(%f,%f) is %soccluded, grid disagrees\n",
+                           CHECK_SEEDS[s], CHECK_CELL_SIZES[c],
+                           cFrom.GetX(), cFrom.GetY(), cTo.GetX(), cTo.GetY(),
+                           bBruteForce ? "" : "not ");
+               ++unMismatches;
+            }
+            unOccluded += bBruteForce;
+            ++unTests;
+         }
+      }
+   }
+   /* An arena without walls */
+   CWallIndex cEmpty;
+   cEmpty.Build(0.25);
+   if(cEmpty.IsOccluded(CVector2(0.0, 0.0), CVector2(1.0, 1.0), HEIGHT)) {
+      std::printf("an index without walls occludes\n");
+      ++unMismatches;
+   }
+   if(unMismatches > 0) {
+      std::printf("%zu mismatches\n", unMismatches);
+      return 1;
+   }
+   std::printf("grid and brute force agree on %zu pairs, %zu occluded\n", unTests, unOccluded);
+   return 0;
+}
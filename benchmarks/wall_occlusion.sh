@@ -0,0 +1,63 @@
+#!/bin/bash
+# Simulation cost of the wall occlusion checks.
+#
+# Runs a maze experiment at several swarm sizes, once as it is (the RAB
+# medium ray-casts every pair of robots in range through the space) and
+# once with the nav_walls range-and-bearing sensor and the occlusion
+# checks of the medium off (the walls are rasterised once into a grid
+# and the sensors test the pairs against it; see
+# controllers/navigation/nav_rab_sensor.h). Every trial is stopped after
+# the same number of ticks, then the mean wall time per tick of every
+# configuration is printed. The derived files go to a temporary
+# directory.
+#
+# Usage: benchmarks/wall_occlusion.sh [-c base.argos] [-n trials] [-g cell_size] [-t ticks] [-o output.csv] [swarm size ...]
+base="experiments/maze_4Ls.argos";
+count=5;
+cell=0.25;
+ticks=2000;
+outfile="wall_occlusion.csv";
+while getopts c:n:g:t:o: flag
+do
+    case "${flag}" in
+        c) base=${OPTARG};;
+        n) count=${OPTARG};;
+        g) cell=${OPTARG};;
+        t) ticks=${OPTARG};;
+        o) outfile=${OPTARG};;
+    esac
+done
+shift $((OPTIND - 1))
+sizes=${@:-"10 20 40 80 160"}
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+cp "$base" "$workdir/medium_base.argos"
+sed -e "s/<range_and_bearing implementation=\"medium\"/<range_and_bearing implementation=\"nav_walls\" wall_cell_size=\"$cell\"/" \
+    -e "s/<range_and_bearing id=\"rab\"/<range_and_bearing id=\"rab\" check_occlusions=\"false\"/" \
+    "$base" > "$workdir/grid_base.argos"
+
+sweeps=()
+for mode in medium grid; do
+    cat > "$workdir/$mode.xml" <<EOF
+<sweep base="$workdir/${mode}_base.argos">
+  <layout name="arena" arena="$workdir/${mode}_base.argos" min="-4,-4,0" max="4,4,0" />
+  <quantity values="$sizes" />
+</sweep>
+EOF
+    sweeps+=(-x "$workdir/$mode.xml")
+done
+
+build/embedding/trial_runner/trial_runner "${sweeps[@]}" -n $count -T $ticks -o $outfile || exit 1
+
+awk -F, 'NR > 1 && $12 == "ok" && $4 > 0 {
+             n[$1]++; us[$1] += 1e6 * $10 / $4
+         }
+         END {
+             printf "%-55s %8s %14s\n", "experiment", "trials", "us per tick"
+             fflush()
+             for(e in n) {
+                 printf "%-55s %8d %14.1f\n", e, n[e], us[e] / n[e] | "sort"
+             }
+         }' $outfile
@@ -1,170 +0,0 @@
-/*
- * AUTHOR: Carlo Pinciroli <cpinciro@ulb.ac.be>
- *
- * An example diffusion controller for the foot-bot.
- *
- * This controller makes the robots behave as gas particles. The robots
- * go straight until they get close enough to another robot, in which
- * case they turn, loosely simulating an elastic collision. The net effect
- * is that over time the robots diffuse in the environment.
- *
- * The controller uses the proximity sensor to detect obstacles and the
- * wheels to move the robot around.
- *
- * This controller is meant to be used with the XML files:
- *    experiments/diffusion_1.argos
- *    experiments/diffusion_10.argos
- */
-
-#ifndef DIRECTIONAL_NAVIGATION_H
-#define DIRECTIONAL_NAVIGATION_H
-
-/*
- * Include some necessary headers.
- */
-
-#include <argos3/core/utility/math/rng.h>
-/* Definition of the CCI_Controller class. */
-#include <argos3/core/control_interface/ci_controller.h>
-/* Definition of the differential steering actuator */
-#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
-#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_sensor.h>
-/* Definition of the foot-bot proximity sensor */
-#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_proximity_sensor.h>
-
-/* Definition of the IrRB sensors */
-#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
-#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_actuator.h>
-
-/* Definition of the LEDs */
-#include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
-
-
-
-/*
- * All the ARGoS stuff in the 'argos' namespace.
- * With this statement, you save typing argos:: every time.
- */
-using namespace argos;
-
-/*
- * A controller is simply an implementation of the CCI_Controller class.
- */
-class DirectionalNavigation : public CCI_Controller {
-
-public:
-
-   /* Class constructor. */
-   DirectionalNavigation();
-
-   /* Class destructor. */
-   virtual ~DirectionalNavigation() {}
-
-   /*
-    * This function initializes the controller.
-    * The 't_node' variable points to the <parameters> section in the XML
-    * file in the <controllers><footbot_diffusion_controller> section.
-    */
-   virtual void Init(TConfigurationNode& t_node);
-
-   /*
-    * This function is called once every time step.
-    * The length of the time step is set in the XML file.
-    */
-   virtual void ControlStep();
-
-   /*
-    * This function resets the controller to its state right after the
-    * Init().
-    * It is called when you press the reset button in the GUI.
-    * In this example controller there is no need for resetting anything,
-    * so the function could have been omitted. It's here just for
-    * completeness.
-    */
-   virtual void Reset() {}
-
-   /*
-    * Called to cleanup what done by Init() when the experiment finishes.
-    * In this example controller there is no need for clean anything up,
-    * so the function could have been omitted. It's here just for
-    * completeness.
-    */
-   virtual void Destroy() {}
-
-private:
-
-   /* Pointer to the differential steering actuator */
-   CCI_DifferentialSteeringActuator* m_pcWheels;
-   CCI_DifferentialSteeringSensor* encoder;
-   /* Pointer to the foot-bot proximity sensor */
-   CCI_FootBotProximitySensor* m_pcProximity;
-   /* Pointer to the foot-bot LEDs */
-   CCI_LEDsActuator* ledRing;
-   /* Pointer to the foot-bot RAB communication */
-   CCI_RangeAndBearingActuator* rab_send;
-   CCI_RangeAndBearingSensor* rab_get;
-
-   /*
-    * The following variables are used as parameters for the
-    * algorithm. You can set their value in the <parameters> section
-    * of the XML configuration file, under the
-    * <controllers><footbot_diffusion_controller> section.
-    */
-
-   /* Maximum tolerance for the angle between
-    * the robot heading direction and
-    * the closest obstacle detected. */
-   CDegrees m_cAlpha;
-   /* Maximum tolerance for the proximity reading between
-    * the robot and the closest obstacle.
-    * The proximity reading is 0 when nothing is detected
-    * and grows exponentially to 1 when the obstacle is
-    * touching the robot.
-    */
-   Real m_fDelta;
-   /* Wheel speed. */
-   Real m_fWheelVelocity;
-   /* Angle tolerance range to go straight.
-    * It is set to [-alpha,alpha]. */
-   CRange<CRadians> m_cGoStraightAngleRange;
-
-   int robot_role;
-   /* Role of the robot 
-    * 0 is normal swarm behavior
-    * 1 is target
-    * 2 is the one navigating */
-   Real comm_range;
-
-   int navigation_type;
-   /* Type of navigation: 
-      0 is Stopping
-      1 is Random
-      2 is Directed
-   */
-
-   CRandom::CRNG* rng;
-
-   int stepnum;
-
-   int sequenceNumberStar;
-   Real distanceStar;
-   int navTargetId;
-   Real bestNavDist;
-   Real bestNavHeading;
-   int randomWanderTime;
-
-   Real heading_of_last_message;
-   Real next_heading;
-
-
-   struct NavTableEntry {
-      UInt32 sequence_number;
-      float distance;
-      Real heading;
-   };
-
-   std::map<int, NavTableEntry> navTable;
-
-};
-
-#endif
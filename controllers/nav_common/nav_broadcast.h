@@ -0,0 +1,281 @@
+/*
+ * Broadcast scheduler for the navigation table.
+ *
+ * Broadcasting the whole table every tick mostly repeats what the
+ * neighbours already know, and makes the RAB medium and every receiver
+ * redo the same work. The scheduler decides on which ticks the table
+ * goes out:
+ *
+ *    broadcast_interval     minimum number of ticks between two
+ *                           broadcasts (default 1)
+ *    broadcast_keepalive    maximum number of ticks between two
+ *                           broadcasts, so that neighbours that just
+ *                           arrived and odometry drift are covered
+ *                           (default 1)
+ *    broadcast_improvement  improvement of a known distance, in cm, that
+ *                           makes the table go out as soon as the
+ *                           interval allows it (default 1)
+ *
+ * New targets always count as significant. A table that does not fit in
+ * one payload keeps going out at the minimum interval.
+ * The default keepalive of 1 broadcasts on every tick, as the controllers
+ * always did, until the time to target on the maze experiments shows that
+ * a longer one does not slow the navigators down (see
+ * benchmarks/broadcast_traffic.sh); e.g. broadcast_keepalive="10" turns
+ * the scheduling on.
+ *
+ * With many targets the table no longer fits in the RAB payload, and the
+ * scheduler also decides which entries go out. The budget of a
+ * broadcast is the room the payload leaves for records, which follows
+ * the data_size of the RAB, possibly cut further:
+ *
+ *    broadcast_budget       bytes of records per broadcast (default 0,
+ *                           all the payload has room for); at least
+ *                           one record
+ *    broadcast_priority     whether the entries are picked by priority
+ *                           (default true) or sent round-robin
+ *    priority_freshness     score of an entry whose sequence number
+ *                           changed since it last went out (default 100)
+ *    priority_improvement   score per cm the distance went down since
+ *                           the entry last went out (default 1)
+ *    priority_age           score per tick since the entry last went
+ *                           out, so that every entry gets its turn
+ *                           (default 10)
+ *
+ * Entries never sent count as fresh and as old as the robot. When the
+ * whole table fits, it goes out as before, in target order.
+ */
+
+#ifndef NAV_BROADCAST_H
+#define NAV_BROADCAST_H
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <controllers/nav_common/nav_codec.h>
+#include <controllers/nav_common/nav_table.h>
+
+#include <algorithm>
+
+using namespace argos;
+
+class CBroadcastScheduler {
+
+public:
+
+   CBroadcastScheduler() :
+      m_unMinInterval(1),
+      m_unKeepAlive(1),
+      m_fImprovement(1.0),
+      m_unBudget(0),
+      m_bPriority(true),
+      m_fFreshnessScore(100.0),
+      m_fImprovementScore(1.0),
+      m_fAgeScore(10.0),
+      m_unTick(0),
+      m_unCursor(0),
+      m_unTicksSinceSent(0),
+      m_bPending(true) {
+      ForgetSent();
+   }
+
+   inline void Init(TConfigurationNode& t_node) {
+      GetNodeAttributeOrDefault(t_node, "broadcast_interval", m_unMinInterval, m_unMinInterval);
+      GetNodeAttributeOrDefault(t_node, "broadcast_keepalive", m_unKeepAlive, m_unKeepAlive);
+      GetNodeAttributeOrDefault(t_node, "broadcast_improvement", m_fImprovement, m_fImprovement);
+      GetNodeAttributeOrDefault(t_node, "broadcast_budget", m_unBudget, m_unBudget);
+      GetNodeAttributeOrDefault(t_node, "broadcast_priority", m_bPriority, m_bPriority);
+      GetNodeAttributeOrDefault(t_node, "priority_freshness", m_fFreshnessScore, m_fFreshnessScore);
+      GetNodeAttributeOrDefault(t_node, "priority_improvement", m_fImprovementScore, m_fImprovementScore);
+      GetNodeAttributeOrDefault(t_node, "priority_age", m_fAgeScore, m_fAgeScore);
+      if(m_unBudget > 0 && m_unBudget < CNavCodec::RECORD_SIZE) {
+         THROW_ARGOSEXCEPTION("Broadcast budget needs 0 or at least " << CNavCodec::RECORD_SIZE << " bytes, the size of a record, got " << m_unBudget);
+      }
+      if(m_fFreshnessScore < 0.0 || m_fImprovementScore < 0.0 || m_fAgeScore <= 0.0) {
+         THROW_ARGOSEXCEPTION("Broadcast priorities need freshness >= 0, improvement >= 0 and age > 0, got freshness=" << m_fFreshnessScore << ", improvement=" << m_fImprovementScore << ", age=" << m_fAgeScore);
+      }
+      Init(m_unMinInterval, m_unKeepAlive, m_fImprovement);
+   }
+
+   /* Configures the scheduler directly, e.g. outside of a simulation */
+   inline void Init(UInt32 un_min_interval,
+                    UInt32 un_keepalive,
+                    Real f_improvement) {
+      if(un_min_interval < 1 || un_keepalive < un_min_interval || f_improvement < 0.0) {
+         THROW_ARGOSEXCEPTION("Broadcast schedule needs 1 <= interval <= keepalive and improvement >= 0, got interval=" << un_min_interval << ", keepalive=" << un_keepalive << ", improvement=" << f_improvement);
+      }
+      m_unMinInterval = un_min_interval;
+      m_unKeepAlive = un_keepalive;
+      m_fImprovement = f_improvement;
+      m_unTick = 0;
+      m_unTicksSinceSent = 0;
+      m_bPending = true;
+      ForgetSent();
+   }
+
+   /* Sets how the entries are picked, e.g. outside of a simulation */
+   inline void SetPriorities(bool b_priority,
+                             Real f_freshness,
+                             Real f_improvement,
+                             Real f_age) {
+      m_bPriority = b_priority;
+      m_fFreshnessScore = f_freshness;
+      m_fImprovementScore = f_improvement;
+      m_fAgeScore = f_age;
+   }
+
+   /* Number of records of un_record_size bytes a broadcast may carry in a payload of un_payload_size */
+   inline size_t GetSlots(size_t un_payload_size,
+                          size_t un_record_size) const {
+      if(m_unBudget > 0 && m_unBudget < un_payload_size) {
+         un_payload_size = m_unBudget;
+      }
+      return un_payload_size / un_record_size;
+   }
+
+   /* Treats every entry as never sent, e.g. after a snapshot is restored */
+   inline void ForgetSent() {
+      m_unCursor = 0;
+      for(size_t i = 0; i < CNavTable::CAPACITY; ++i) {
+         m_punSentTick[i] = NEVER_SENT;
+      }
+   }
+
+   /* A target was added to the table */
+   inline void OnNewTarget() {
+      m_bPending = true;
+   }
+
+   /* The distance to a known target went down by f_improvement */
+   inline void OnImprovement(Real f_improvement) {
+      if(f_improvement >= m_fImprovement) {
+         m_bPending = true;
+      }
+   }
+
+   /*
+    * Called once per tick. Returns true if the table must be broadcast
+    * on this tick; b_rotating tells that part of the table is still
+    * waiting for its turn in the payload.
+    */
+   inline bool Tick(bool b_rotating) {
+      ++m_unTick;
+      ++m_unTicksSinceSent;
+      return m_unTicksSinceSent >= m_unKeepAlive ||
+         (m_unTicksSinceSent >= m_unMinInterval && (m_bPending || b_rotating));
+   }
+
+   /*
+    * Picks the entries of c_table to broadcast on this tick, at most
+    * un_slots, by priority or round-robin, and writes their indices to
+    * pun_entries in target order. Returns how many were picked.
+    */
+   inline size_t Select(const CNavTable& c_table,
+                        size_t un_slots,
+                        size_t* pun_entries) {
+      size_t unEntries = c_table.Size();
+      if(unEntries <= un_slots) {
+         for(size_t i = 0; i < unEntries; ++i) {
+            pun_entries[i] = i;
+         }
+         return unEntries;
+      }
+      if(!m_bPriority) {
+         if(m_unCursor >= unEntries) m_unCursor = 0;
+         for(size_t i = 0; i < un_slots; ++i) {
+            pun_entries[i] = (m_unCursor + i) % unEntries;
+         }
+         m_unCursor = (m_unCursor + un_slots) % unEntries;
+         std::sort(pun_entries, pun_entries + un_slots);
+         return un_slots;
+      }
+      for(size_t i = 0; i < unEntries; ++i) {
+         m_psCandidates[i].Entry = i;
+         m_psCandidates[i].Score = GetScore(c_table.GetTarget(i), c_table.GetEntry(i));
+      }
+      /* The un_slots highest scores, ties to the lowest target id, so the choice is reproducible */
+      std::nth_element(m_psCandidates, m_psCandidates + un_slots, m_psCandidates + unEntries,
+                        [](const SCandidate& s_a, const SCandidate& s_b) {
+                           return s_a.Score > s_b.Score ||
+                              (s_a.Score == s_b.Score && s_a.Entry < s_b.Entry);
+                        });
+      for(size_t i = 0; i < un_slots; ++i) {
+         pun_entries[i] = m_psCandidates[i].Entry;
+      }
+      std::sort(pun_entries, pun_entries + un_slots);
+      return un_slots;
+   }
+
+   /* Priority of an entry on this tick, see above */
+   inline Real GetScore(UInt8 un_target,
+                        const NavTableEntry& s_entry) const {
+      if(m_punSentTick[un_target] == NEVER_SENT) {
+         return m_fFreshnessScore + m_fAgeScore * m_unTick;
+      }
+      Real fScore = m_fAgeScore * (m_unTick - m_punSentTick[un_target]);
+      if(s_entry.sequence_number != m_punSentSequence[un_target]) {
+         fScore += m_fFreshnessScore;
+      }
+      if(s_entry.distance < m_pfSentDistance[un_target]) {
+         fScore += m_fImprovementScore * (m_pfSentDistance[un_target] - s_entry.distance);
+      }
+      return fScore;
+   }
+
+   /* The table was broadcast on this tick */
+   inline void OnSent() {
+      m_unTicksSinceSent = 0;
+      m_bPending = false;
+   }
+
+   /* The un_count entries of c_table listed in pun_entries were broadcast on this tick */
+   inline void OnSent(const CNavTable& c_table,
+                      const size_t* pun_entries,
+                      size_t un_count) {
+      for(size_t i = 0; i < un_count; ++i) {
+         UInt8 unTarget = c_table.GetTarget(pun_entries[i]);
+         NavTableEntry sEntry = c_table.GetEntry(pun_entries[i]);
+         m_punSentTick[unTarget] = m_unTick;
+         m_punSentSequence[unTarget] = sEntry.sequence_number;
+         m_pfSentDistance[unTarget] = sEntry.distance;
+      }
+      OnSent();
+   }
+
+private:
+
+   /* Sent tick of the entries that never went out */
+   static const UInt32 NEVER_SENT = 0xFFFFFFFF;
+
+   /* An entry being ranked */
+   struct SCandidate {
+      size_t Entry;
+      Real Score;
+   };
+
+private:
+
+   UInt32 m_unMinInterval;
+   UInt32 m_unKeepAlive;
+   Real m_fImprovement;
+   /* Bytes of records per broadcast, 0 for the whole payload */
+   UInt32 m_unBudget;
+   bool m_bPriority;
+   Real m_fFreshnessScore;
+   Real m_fImprovementScore;
+   Real m_fAgeScore;
+   /* Ticks since Init() */
+   UInt32 m_unTick;
+   /* Next entry to send round-robin */
+   size_t m_unCursor;
+   UInt32 m_unTicksSinceSent;
+   /* Whether something significant changed since the last broadcast */
+   bool m_bPending;
+   /* What went out last for each target id, and when */
+   UInt32 m_punSentTick[CNavTable::CAPACITY];
+   UInt32 m_punSentSequence[CNavTable::CAPACITY];
+   float m_pfSentDistance[CNavTable::CAPACITY];
+   /* Scratch space of Select() */
+   SCandidate m_psCandidates[CNavTable::CAPACITY];
+
+};
+
+#endif
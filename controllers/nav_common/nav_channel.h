@@ -0,0 +1,194 @@
+/*
+ * Communication channels, used as a compile-time policy of
+ * CNavigationController.
+ *
+ * A channel sits between the range-and-bearing sensor and the decoder,
+ * and models what happens to a payload on its way to the receiver. It
+ * provides:
+ *
+ *    void Init(TConfigurationNode& t_node);
+ *       Reads the channel parameters from the controller <params>.
+ *    const UInt8* Receive(const UInt8* pun_payload, size_t un_size);
+ *       Returns the payload as received, or NULL if it was lost.
+ *    size_t GetHeapSize() const;
+ *       Returns the bytes the channel allocated on the heap.
+ *
+ * CIdealChannel delivers every payload untouched and costs nothing.
+ *
+ * CNoiseChannel models an unreliable link. Its parameters are:
+ *
+ *    noise_ber                probability of flipping each bit
+ *    noise_burst_probability  probability that a payload is hit by a burst
+ *    noise_burst_length       length of a burst, in bits; every bit in the
+ *                             burst is replaced by a random one
+ *    noise_drop_probability   probability that a payload is lost
+ *
+ * Independent bit errors are drawn as geometric gaps between flipped
+ * bits, carried over from one payload to the next, so the cost does not
+ * depend on the payload size but on the number of errors: payloads that
+ * come through intact are not even copied. The random stream is a small
+ * generator seeded from the ARGoS "argos" category, so noisy runs are
+ * reproduced by the experiment seed.
+ */
+
+#ifndef NAV_CHANNEL_H
+#define NAV_CHANNEL_H
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/math/rng.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace argos;
+
+class CIdealChannel {
+
+public:
+
+   inline void Init(TConfigurationNode& t_node) {}
+
+   inline const UInt8* Receive(const UInt8* pun_payload,
+                               size_t un_size) {
+      return pun_payload;
+   }
+
+   inline size_t GetHeapSize() const {
+      return 0;
+   }
+
+};
+
+/****************************************/
+/****************************************/
+
+class CNoiseChannel {
+
+public:
+
+   CNoiseChannel() :
+      m_fBitErrorRate(0.0),
+      m_fBurstProbability(0.0),
+      m_unBurstLength(8),
+      m_fDropProbability(0.0),
+      m_fLogKeep(0.0),
+      m_unToNextError(NO_BIT_ERROR),
+      m_unState(0) {}
+
+   inline void Init(TConfigurationNode& t_node) {
+      GetNodeAttributeOrDefault(t_node, "noise_ber", m_fBitErrorRate, m_fBitErrorRate);
+      GetNodeAttributeOrDefault(t_node, "noise_burst_probability", m_fBurstProbability, m_fBurstProbability);
+      GetNodeAttributeOrDefault(t_node, "noise_burst_length", m_unBurstLength, m_unBurstLength);
+      GetNodeAttributeOrDefault(t_node, "noise_drop_probability", m_fDropProbability, m_fDropProbability);
+      CRandom::CRNG* pcRNG = CRandom::CreateRNG("argos");
+      UInt64 unSeed = pcRNG->Uniform(CRange<UInt32>(0, 0xFFFFFFFF));
+      unSeed = (unSeed << 32) | pcRNG->Uniform(CRange<UInt32>(0, 0xFFFFFFFF));
+      Init(m_fBitErrorRate, m_fBurstProbability, m_unBurstLength, m_fDropProbability, unSeed);
+   }
+
+   /* Configures the channel directly, e.g. outside of a simulation */
+   inline void Init(Real f_bit_error_rate,
+                    Real f_burst_probability,
+                    UInt32 un_burst_length,
+                    Real f_drop_probability,
+                    UInt64 un_seed) {
+      if(f_bit_error_rate < 0.0 || f_bit_error_rate > 1.0 ||
+         f_burst_probability < 0.0 || f_burst_probability > 1.0 ||
+         f_drop_probability < 0.0 || f_drop_probability > 1.0) {
+         THROW_ARGOSEXCEPTION("Noise probabilities must be in [0,1], got ber=" << f_bit_error_rate << ", burst=" << f_burst_probability << ", drop=" << f_drop_probability);
+      }
+      m_fBitErrorRate = f_bit_error_rate;
+      m_fBurstProbability = f_burst_probability;
+      m_unBurstLength = un_burst_length;
+      m_fDropProbability = f_drop_probability;
+      m_fLogKeep = std::log1p(-m_fBitErrorRate);
+      m_unState = un_seed;
+      m_unToNextError = NextGap();
+   }
+
+   inline const UInt8* Receive(const UInt8* pun_payload,
+                               size_t un_size) {
+      if(m_fDropProbability > 0.0 && NextReal() < m_fDropProbability) {
+         return NULL;
+      }
+      UInt64 unBits = static_cast<UInt64>(un_size) * 8;
+      bool bBurst = m_fBurstProbability > 0.0 && unBits > 0 && NextReal() < m_fBurstProbability;
+      if(m_unToNextError >= unBits && !bBurst) {
+         /* Intact */
+         m_unToNextError -= unBits;
+         return pun_payload;
+      }
+      /* Corrupt a copy, the readings are shared with the other robots */
+      if(m_vecScratch.size() < un_size) {
+         m_vecScratch.resize(un_size);
+      }
+      UInt8* punData = &m_vecScratch[0];
+      ::memcpy(punData, pun_payload, un_size);
+      UInt64 unBit = m_unToNextError;
+      while(unBit < unBits) {
+         punData[unBit >> 3] ^= 1 << (unBit & 7);
+         unBit += 1 + NextGap();
+      }
+      m_unToNextError = unBit - unBits;
+      if(bBurst) {
+         UInt64 unStart = Next() % unBits;
+         UInt64 unEnd = unStart + m_unBurstLength;
+         if(unEnd > unBits) unEnd = unBits;
+         UInt64 unRandom = 0;
+         for(UInt64 i = unStart; i < unEnd; ++i) {
+            if(((i - unStart) & 63) == 0) unRandom = Next();
+            punData[i >> 3] ^= (unRandom & 1) << (i & 7);
+            unRandom >>= 1;
+         }
+      }
+      return punData;
+   }
+
+   inline size_t GetHeapSize() const {
+      return m_vecScratch.capacity();
+   }
+
+private:
+
+   /* Gap used when no bit error can happen */
+   static const UInt64 NO_BIT_ERROR = 0xFFFFFFFFFFFFFFFFULL >> 1;
+
+   /* splitmix64 */
+   inline UInt64 Next() {
+      UInt64 unZ = (m_unState += 0x9E3779B97F4A7C15ULL);
+      unZ = (unZ ^ (unZ >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      unZ = (unZ ^ (unZ >> 27)) * 0x94D049BB133111EBULL;
+      return unZ ^ (unZ >> 31);
+   }
+
+   /* Uniform in [0,1) */
+   inline Real NextReal() {
+      return (Next() >> 11) * (1.0 / 9007199254740992.0);
+   }
+
+   /* Number of intact bits before the next bit error */
+   inline UInt64 NextGap() {
+      if(m_fBitErrorRate <= 0.0) return NO_BIT_ERROR;
+      if(m_fBitErrorRate >= 1.0) return 0;
+      Real fGap = std::floor(std::log1p(-NextReal()) / m_fLogKeep);
+      return (fGap < NO_BIT_ERROR) ? static_cast<UInt64>(fGap) : NO_BIT_ERROR;
+   }
+
+private:
+
+   Real m_fBitErrorRate;
+   Real m_fBurstProbability;
+   UInt32 m_unBurstLength;
+   Real m_fDropProbability;
+   /* log(1 - m_fBitErrorRate) */
+   Real m_fLogKeep;
+   /* Intact bits left before the next bit error */
+   UInt64 m_unToNextError;
+   UInt64 m_unState;
+   /* Corrupted copy of the last payload */
+   std::vector<UInt8> m_vecScratch;
+
+};
+
+#endif
@@ -0,0 +1,271 @@
+/*
+ * Wire format of the navigation protocol.
+ *
+ * A range-and-bearing payload is a sequence of fixed-size records. The
+ * first byte of a record is its type:
+ *
+ *    77  nav info            target id, sequence number, distance
+ *    56  direction request   target id
+ *    25  direction reply     target id, heading
+ *     0  padding             ends the payload
+ *
+ * Every record is RECORD_SIZE (10) bytes; multi-byte fields are in
+ * network byte order, as written by CByteArray's operator<<, and floats
+ * travel as their IEEE-754 bits. The layouts are spelled out as byte
+ * structs so that the sizes are checked at compile time.
+ *
+ * Encoding and decoding work in place on caller-provided buffers and
+ * never allocate. A nav table larger than the payload is split across
+ * ticks: EncodeTable() sends as many entries as fit, either continuing
+ * from where it stopped on the last call or taking the entries the
+ * broadcast scheduler picked (see nav_broadcast.h).
+ */
+
+#ifndef NAV_CODEC_H
+#define NAV_CODEC_H
+
+#include <controllers/nav_common/nav_table.h>
+
+#include <cstring>
+
+using namespace argos;
+
+class CNavCodec {
+
+public:
+
+   /* Size of every record on the wire, in bytes */
+   static const size_t RECORD_SIZE = 10;
+
+   /* Record types */
+   enum EType {
+      TYPE_PADDING           = 0,
+      TYPE_NAV_INFO          = 77,
+      TYPE_DIRECTION_REQUEST = 56,
+      TYPE_DIRECTION_REPLY   = 25
+   };
+
+   /* Nav info: what the sender knows about a target */
+   struct SNavInfo {
+      UInt8 Target;
+      UInt32 SequenceNumber;
+      float Distance;
+   };
+
+   /* Request for the direction the sender's nav info came from */
+   struct SDirectionRequest {
+      UInt8 Target;
+   };
+
+   /* Direction to follow once the requester reaches the sender */
+   struct SDirectionReply {
+      UInt8 Target;
+      float Heading;
+   };
+
+public:
+
+   /* Number of whole records that fit in a payload */
+   static inline size_t GetCapacity(size_t un_payload_size) {
+      return un_payload_size / RECORD_SIZE;
+   }
+
+   /* Type of the record starting at pun_record */
+   static inline UInt8 GetType(const UInt8* pun_record) {
+      return pun_record[0];
+   }
+
+   /*
+    * Record encoders. pun_record must point to at least RECORD_SIZE
+    * writable bytes.
+    */
+
+   static inline void Encode(const SNavInfo& s_msg,
+                             UInt8* pun_record) {
+      SNavInfoWire* psWire = reinterpret_cast<SNavInfoWire*>(pun_record);
+      psWire->Type = TYPE_NAV_INFO;
+      psWire->Target = s_msg.Target;
+      WriteUInt32(psWire->SequenceNumber, s_msg.SequenceNumber);
+      WriteFloat(psWire->Distance, s_msg.Distance);
+   }
+
+   static inline void Encode(const SDirectionRequest& s_msg,
+                             UInt8* pun_record) {
+      SDirectionRequestWire* psWire = reinterpret_cast<SDirectionRequestWire*>(pun_record);
+      psWire->Type = TYPE_DIRECTION_REQUEST;
+      psWire->Target = s_msg.Target;
+      ::memset(psWire->Padding, 0, sizeof(psWire->Padding));
+   }
+
+   static inline void Encode(const SDirectionReply& s_msg,
+                             UInt8* pun_record) {
+      SDirectionReplyWire* psWire = reinterpret_cast<SDirectionReplyWire*>(pun_record);
+      psWire->Type = TYPE_DIRECTION_REPLY;
+      psWire->Target = s_msg.Target;
+      WriteFloat(psWire->Heading, s_msg.Heading);
+      ::memset(psWire->Padding, 0, sizeof(psWire->Padding));
+   }
+
+   /*
+    * Record decoders. pun_record must point to at least RECORD_SIZE
+    * readable bytes of a record of the matching type.
+    */
+
+   static inline void Decode(const UInt8* pun_record,
+                             SNavInfo& s_msg) {
+      const SNavInfoWire* psWire = reinterpret_cast<const SNavInfoWire*>(pun_record);
+      s_msg.Target = psWire->Target;
+      s_msg.SequenceNumber = ReadUInt32(psWire->SequenceNumber);
+      s_msg.Distance = ReadFloat(psWire->Distance);
+   }
+
+   static inline void Decode(const UInt8* pun_record,
+                             SDirectionRequest& s_msg) {
+      const SDirectionRequestWire* psWire = reinterpret_cast<const SDirectionRequestWire*>(pun_record);
+      s_msg.Target = psWire->Target;
+   }
+
+   static inline void Decode(const UInt8* pun_record,
+                             SDirectionReply& s_msg) {
+      const SDirectionReplyWire* psWire = reinterpret_cast<const SDirectionReplyWire*>(pun_record);
+      s_msg.Target = psWire->Target;
+      s_msg.Heading = ReadFloat(psWire->Heading);
+   }
+
+   /*
+    * Fills a whole payload with a single record followed by padding.
+    * Returns false if the payload is too small for a record.
+    */
+   template<class MESSAGE>
+   static inline bool EncodePayload(const MESSAGE& s_msg,
+                                    UInt8* pun_payload,
+                                    size_t un_payload_size) {
+      if(un_payload_size < RECORD_SIZE) return false;
+      Encode(s_msg, pun_payload);
+      ::memset(pun_payload + RECORD_SIZE, 0, un_payload_size - RECORD_SIZE);
+      return true;
+   }
+
+   /*
+    * Fills a payload with nav info records for the entries of a table,
+    * followed by padding. When the table does not fit, the entries are
+    * sent round-robin: un_cursor is the index of the first entry to
+    * send, and is advanced past the last entry sent.
+    * Returns the number of records written.
+    */
+   static inline size_t EncodeTable(const CNavTable& c_table,
+                                    size_t& un_cursor,
+                                    UInt8* pun_payload,
+                                    size_t un_payload_size) {
+      size_t unEntries = c_table.Size();
+      size_t unCount = GetCapacity(un_payload_size);
+      if(unCount > unEntries) unCount = unEntries;
+      if(un_cursor >= unEntries) un_cursor = 0;
+      SNavInfo sInfo;
+      for(size_t i = 0; i < unCount; ++i) {
+         size_t unEntry = un_cursor + i;
+         if(unEntry >= unEntries) unEntry -= unEntries;
+         NavTableEntry sEntry = c_table.GetEntry(unEntry);
+         sInfo.Target = c_table.GetTarget(unEntry);
+         sInfo.SequenceNumber = sEntry.sequence_number;
+         sInfo.Distance = sEntry.distance;
+         Encode(sInfo, pun_payload + i * RECORD_SIZE);
+      }
+      if(unEntries > 0) {
+         un_cursor = (un_cursor + unCount) % unEntries;
+      }
+      ::memset(pun_payload + unCount * RECORD_SIZE, 0, un_payload_size - unCount * RECORD_SIZE);
+      return unCount;
+   }
+
+   /*
+    * Fills a payload with nav info records for the un_count entries of a
+    * table listed in pun_entries, as many as fit, followed by padding.
+    * Returns the number of records written.
+    */
+   static inline size_t EncodeTable(const CNavTable& c_table,
+                                    const size_t* pun_entries,
+                                    size_t un_count,
+                                    UInt8* pun_payload,
+                                    size_t un_payload_size) {
+      size_t unCount = GetCapacity(un_payload_size);
+      if(unCount > un_count) unCount = un_count;
+      SNavInfo sInfo;
+      for(size_t i = 0; i < unCount; ++i) {
+         NavTableEntry sEntry = c_table.GetEntry(pun_entries[i]);
+         sInfo.Target = c_table.GetTarget(pun_entries[i]);
+         sInfo.SequenceNumber = sEntry.sequence_number;
+         sInfo.Distance = sEntry.distance;
+         Encode(sInfo, pun_payload + i * RECORD_SIZE);
+      }
+      ::memset(pun_payload + unCount * RECORD_SIZE, 0, un_payload_size - unCount * RECORD_SIZE);
+      return unCount;
+   }
+
+private:
+
+   /* Wire layouts */
+
+   struct SNavInfoWire {
+      UInt8 Type;
+      UInt8 Target;
+      UInt8 SequenceNumber[4];
+      UInt8 Distance[4];
+   };
+
+   struct SDirectionRequestWire {
+      UInt8 Type;
+      UInt8 Target;
+      UInt8 Padding[8];
+   };
+
+   struct SDirectionReplyWire {
+      UInt8 Type;
+      UInt8 Target;
+      UInt8 Heading[4];
+      UInt8 Padding[4];
+   };
+
+   static_assert(sizeof(SNavInfoWire) == RECORD_SIZE,
+                 "nav info record must be RECORD_SIZE bytes");
+   static_assert(sizeof(SDirectionRequestWire) == RECORD_SIZE,
+                 "direction request record must be RECORD_SIZE bytes");
+   static_assert(sizeof(SDirectionReplyWire) == RECORD_SIZE,
+                 "direction reply record must be RECORD_SIZE bytes");
+   static_assert(sizeof(float) == sizeof(UInt32),
+                 "floats are sent as 32-bit words");
+
+   /* Field helpers, network byte order */
+
+   static inline void WriteUInt32(UInt8* pun_field,
+                                  UInt32 un_value) {
+      pun_field[0] = un_value >> 24;
+      pun_field[1] = un_value >> 16;
+      pun_field[2] = un_value >> 8;
+      pun_field[3] = un_value;
+   }
+
+   static inline UInt32 ReadUInt32(const UInt8* pun_field) {
+      return (static_cast<UInt32>(pun_field[0]) << 24) |
+             (static_cast<UInt32>(pun_field[1]) << 16) |
+             (static_cast<UInt32>(pun_field[2]) <<  8) |
+              static_cast<UInt32>(pun_field[3]);
+   }
+
+   static inline void WriteFloat(UInt8* pun_field,
+                                 float f_value) {
+      UInt32 unBits;
+      ::memcpy(&unBits, &f_value, sizeof(unBits));
+      WriteUInt32(pun_field, unBits);
+   }
+
+   static inline float ReadFloat(const UInt8* pun_field) {
+      UInt32 unBits = ReadUInt32(pun_field);
+      float fValue;
+      ::memcpy(&fValue, &unBits, sizeof(fValue));
+      return fValue;
+   }
+
+};
+
+#endif
@@ -0,0 +1,196 @@
+/*
+ * Common interface of the navigation controllers.
+ *
+ * All navigation controller variants derive from this class, so that loop
+ * functions and tools can query the state of any robot without knowing
+ * which navigation algorithm it runs. The controllers only record what
+ * happened; deciding when the experiment is over is left to the loop
+ * functions. Built with NAV_PROFILING, they also time the phases of
+ * their control step (see nav_profiler.h), and built with a
+ * NAV_TRACE_LEVEL, they trace their decisions (see nav_trace.h).
+ *
+ * ARGoS may run the control steps of the robots in parallel (threads
+ * attribute of <system>), so a controller only touches its own state:
+ * it traces into a ring of its own, which the loop functions drain
+ * between steps, and the arrival flag is atomic, as it is read from
+ * outside the control step.
+ */
+
+#ifndef NAV_CONTROLLER_H
+#define NAV_CONTROLLER_H
+
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
+#include <controllers/nav_common/nav_profiler.h>
+#include <controllers/nav_common/nav_trace.h>
+
+#include <atomic>
+
+using namespace argos;
+
+class CNavController : public CCI_Controller {
+
+public:
+
+   /* Robot roles, as set with the 'role' parameter */
+   enum ERole {
+      ROLE_ASSISTANT = 0,
+      ROLE_TARGET    = 1,
+      ROLE_NAVIGATOR = 2
+   };
+
+   /* Kinds of messages, for the traffic counters */
+   enum EMessage {
+      MESSAGE_NAV_INFO = 0,
+      MESSAGE_DIRECTION_REQUEST,
+      MESSAGE_DIRECTION_REPLY,
+      MESSAGE_COUNT
+   };
+
+   /* Radio traffic of the robot during its last control step */
+   struct STraffic {
+      /* Payloads set on the RAB, by kind of message */
+      UInt32 Sent[MESSAGE_COUNT];
+      /* Bytes of payload the RAB carries after the step, 0 once silenced */
+      UInt32 BytesOnAir;
+      /* Packets read from the RAB sensor */
+      UInt32 Received;
+      /* Packets ignored because they came from beyond comm_range */
+      UInt32 OutOfRange;
+      /* Packets lost in the channel or rejected by the payload codec */
+      UInt32 Dropped;
+      /* Records received, by kind of message */
+      UInt32 Records[MESSAGE_COUNT];
+   };
+
+   /* Per-robot statistics collected over a run */
+   struct SStats {
+      /* Number of times this robot set new RAB data */
+      UInt32 MessagesSent;
+      /* Number of times a navigator switched to a better nav point */
+      UInt32 Hops;
+      /* Distance covered by the robot, in cm */
+      Real PathLength;
+   };
+
+   /* Where the robot is heading, as it stands after its last control step */
+   struct SNavState {
+      /* Distance, in cm, and bearing, in rad, left to the current nav point */
+      Real BestNavDist;
+      Real BestNavHeading;
+      /* Distance to the target advertised by the current nav point, -1 if none yet */
+      Real DistanceStar;
+   };
+
+public:
+
+   CNavController() :
+      m_bArrived(false) {
+      ResetStats();
+      ResetTraffic();
+   }
+
+   virtual ~CNavController() {}
+
+   /* Returns the role of the robot (see ERole) */
+   virtual int GetRole() const = 0;
+
+   /* Returns the range the robot accepts messages from, in cm */
+   virtual Real GetCommRange() const = 0;
+
+   /* Returns the id a target advertises, or the one a navigator heads to */
+   virtual UInt8 GetTargetId() const = 0;
+
+   /* Returns true if the nav table of the robot has an entry for a target */
+   virtual bool KnowsTarget(UInt8 un_target) const = 0;
+
+   /* Sets f_distance to the distance to a target in the nav table; returns false if it has no entry */
+   virtual bool GetTableDistance(UInt8 un_target,
+                                 Real& f_distance) const = 0;
+
+   virtual SNavState GetNavState() const = 0;
+
+   /*
+    * Appends the navigation state of the robot (nav table, nav point,
+    * statistics) to a snapshot, and reads it back. The devices and the
+    * parameters are not part of it: they come from the configuration.
+    */
+   virtual void SaveState(CByteArray& c_state) const = 0;
+   virtual void LoadState(CByteArray& c_state) = 0;
+
+   /*
+    * Returns the bytes of memory the controller holds: the object itself
+    * and the buffers it allocated. The devices belong to the simulator
+    * and are not counted.
+    */
+   virtual size_t GetStateSize() const = 0;
+
+   /* Returns true once a navigator has reached its target */
+   inline bool HasArrived() const {
+      return m_bArrived.load(std::memory_order_acquire);
+   }
+
+   inline const SStats& GetStats() const {
+      return m_sStats;
+   }
+
+   inline const STraffic& GetTraffic() const {
+      return m_sTraffic;
+   }
+
+#ifdef NAV_PROFILING
+   inline const CNavProfile& GetProfile() const {
+      return m_cProfile;
+   }
+#endif
+
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+   inline CNavTrace& GetTrace() {
+      return m_cTrace;
+   }
+#endif
+
+protected:
+
+   /* Called at the start of every control step */
+   inline void ResetTraffic() {
+      for(size_t i = 0; i < MESSAGE_COUNT; ++i) {
+         m_sTraffic.Sent[i] = 0;
+         m_sTraffic.Records[i] = 0;
+      }
+      m_sTraffic.BytesOnAir = 0;
+      m_sTraffic.Received = 0;
+      m_sTraffic.OutOfRange = 0;
+      m_sTraffic.Dropped = 0;
+   }
+
+   inline void SetArrived(bool b_arrived) {
+      m_bArrived.store(b_arrived, std::memory_order_release);
+   }
+
+   inline void ResetStats() {
+      m_sStats.MessagesSent = 0;
+      m_sStats.Hops = 0;
+      m_sStats.PathLength = 0.0;
+#ifdef NAV_PROFILING
+      m_cProfile.Clear();
+#endif
+   }
+
+protected:
+
+   std::atomic<bool> m_bArrived;
+   SStats m_sStats;
+   STraffic m_sTraffic;
+#ifdef NAV_PROFILING
+   /* Cycles spent in the phases of the control step */
+   CNavProfile m_cProfile;
+#endif
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+   /* Events of the robot, drained by the loop functions */
+   CNavTrace m_cTrace;
+#endif
+
+};
+
+#endif
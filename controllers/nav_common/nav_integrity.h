@@ -0,0 +1,200 @@
+/*
+ * Error detection and correction primitives for range-and-bearing
+ * payloads.
+ *
+ * - CCrc8:   CRC-8 (polynomial 0x07), 1 byte, detects every error burst
+ *            up to 8 bits and all odd numbers of bit errors;
+ * - CCrc16:  CRC-16/CCITT-FALSE (polynomial 0x1021, init 0xFFFF),
+ *            2 bytes, detects bursts up to 16 bits;
+ * - CSecded: extended Hamming(8,4), one codeword byte per data nibble,
+ *            corrects one flipped bit per codeword and detects two.
+ *
+ * Everything is table-driven: the tables are computed at compile time,
+ * so checking a payload costs one lookup per byte (CRC) or per codeword
+ * (SECDED) instead of a loop over the bits.
+ */
+
+#ifndef NAV_INTEGRITY_H
+#define NAV_INTEGRITY_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <array>
+#include <cstddef>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/*
+ * Compile-time table builders
+ */
+
+constexpr std::array<UInt8, 256> MakeCrc8Table() {
+   std::array<UInt8, 256> punTable = {};
+   for(size_t i = 0; i < 256; ++i) {
+      UInt8 unCRC = i;
+      for(size_t b = 0; b < 8; ++b) {
+         unCRC = (unCRC & 0x80) ? ((unCRC << 1) ^ 0x07) : (unCRC << 1);
+      }
+      punTable[i] = unCRC;
+   }
+   return punTable;
+}
+
+constexpr std::array<UInt16, 256> MakeCrc16Table() {
+   std::array<UInt16, 256> punTable = {};
+   for(size_t i = 0; i < 256; ++i) {
+      UInt16 unCRC = i << 8;
+      for(size_t b = 0; b < 8; ++b) {
+         unCRC = (unCRC & 0x8000) ? ((unCRC << 1) ^ 0x1021) : (unCRC << 1);
+      }
+      punTable[i] = unCRC;
+   }
+   return punTable;
+}
+
+/*
+ * Bit 0 is the overall parity, bits 1-7 the Hamming(7,4) codeword
+ * p1 p2 d1 p3 d2 d3 d4.
+ */
+constexpr UInt8 MakeSecdedCodeword(UInt8 un_nibble) {
+   UInt8 d1 = (un_nibble >> 0) & 1;
+   UInt8 d2 = (un_nibble >> 1) & 1;
+   UInt8 d3 = (un_nibble >> 2) & 1;
+   UInt8 d4 = (un_nibble >> 3) & 1;
+   UInt8 p1 = d1 ^ d2 ^ d4;
+   UInt8 p2 = d1 ^ d3 ^ d4;
+   UInt8 p3 = d2 ^ d3 ^ d4;
+   UInt8 unCodeword = (p1 << 1) | (p2 << 2) | (d1 << 3) | (p3 << 4) | (d2 << 5) | (d3 << 6) | (d4 << 7);
+   UInt8 p0 = p1 ^ p2 ^ d1 ^ p3 ^ d2 ^ d3 ^ d4;
+   return unCodeword | p0;
+}
+
+constexpr size_t CountBits(UInt8 un_byte) {
+   size_t unCount = 0;
+   for(; un_byte != 0; un_byte &= un_byte - 1) ++unCount;
+   return unCount;
+}
+
+constexpr std::array<UInt8, 16> MakeSecdedEncodeTable() {
+   std::array<UInt8, 16> punTable = {};
+   for(size_t i = 0; i < 16; ++i) {
+      punTable[i] = MakeSecdedCodeword(i);
+   }
+   return punTable;
+}
+
+/* Codewords are 4 bits apart: within 1 bit is corrected, 2 bits off is detected */
+constexpr std::array<UInt8, 256> MakeSecdedDecodeTable() {
+   std::array<UInt8, 256> punTable = {};
+   for(size_t i = 0; i < 256; ++i) {
+      punTable[i] = 0xFF; /* CSecded::INVALID */
+      for(size_t n = 0; n < 16; ++n) {
+         if(CountBits(i ^ MakeSecdedCodeword(n)) <= 1) {
+            punTable[i] = n;
+         }
+      }
+   }
+   return punTable;
+}
+
+/****************************************/
+/****************************************/
+
+class CCrc8 {
+
+public:
+
+   /* Size of the checksum on the wire, in bytes */
+   static const size_t SIZE = 1;
+
+   static inline UInt8 Compute(const UInt8* pun_data,
+                               size_t un_size) {
+      UInt8 unCRC = 0;
+      for(size_t i = 0; i < un_size; ++i) {
+         unCRC = TABLE[unCRC ^ pun_data[i]];
+      }
+      return unCRC;
+   }
+
+   static inline void Write(UInt8 un_crc,
+                            UInt8* pun_field) {
+      pun_field[0] = un_crc;
+   }
+
+   static inline UInt8 Read(const UInt8* pun_field) {
+      return pun_field[0];
+   }
+
+private:
+
+   static constexpr std::array<UInt8, 256> TABLE = MakeCrc8Table();
+
+};
+
+/****************************************/
+/****************************************/
+
+class CCrc16 {
+
+public:
+
+   /* Size of the checksum on the wire, in bytes */
+   static const size_t SIZE = 2;
+
+   static inline UInt16 Compute(const UInt8* pun_data,
+                                size_t un_size) {
+      UInt16 unCRC = 0xFFFF;
+      for(size_t i = 0; i < un_size; ++i) {
+         unCRC = (unCRC << 8) ^ TABLE[(unCRC >> 8) ^ pun_data[i]];
+      }
+      return unCRC;
+   }
+
+   /* Network byte order */
+   static inline void Write(UInt16 un_crc,
+                            UInt8* pun_field) {
+      pun_field[0] = un_crc >> 8;
+      pun_field[1] = un_crc;
+   }
+
+   static inline UInt16 Read(const UInt8* pun_field) {
+      return (static_cast<UInt16>(pun_field[0]) << 8) | pun_field[1];
+   }
+
+private:
+
+   static constexpr std::array<UInt16, 256> TABLE = MakeCrc16Table();
+
+};
+
+/****************************************/
+/****************************************/
+
+class CSecded {
+
+public:
+
+   /* Returned by Decode() for codewords with two or more errors */
+   static const UInt8 INVALID = 0xFF;
+
+   /* Codeword of the low nibble of un_nibble */
+   static inline UInt8 Encode(UInt8 un_nibble) {
+      return ENCODE_TABLE[un_nibble & 0x0F];
+   }
+
+   /* Nibble carried by a codeword, corrected if needed, or INVALID */
+   static inline UInt8 Decode(UInt8 un_codeword) {
+      return DECODE_TABLE[un_codeword];
+   }
+
+private:
+
+   static constexpr std::array<UInt8, 16> ENCODE_TABLE = MakeSecdedEncodeTable();
+   static constexpr std::array<UInt8, 256> DECODE_TABLE = MakeSecdedDecodeTable();
+
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Payload codecs, used as a compile-time policy of CNavigationController.
+ *
+ * The records of CNavCodec are the messages; a payload codec decides how
+ * a whole range-and-bearing payload carries them. It provides:
+ *
+ *    UInt8* Init(CByteArray& c_payload, size_t& un_records_size);
+ *       Prepares the codec for the outgoing payload. Returns where the
+ *       records must be written and sets how many bytes they can take.
+ *    void Encode(CByteArray& c_payload);
+ *       Turns the records written since the last call into the payload.
+ *    const UInt8* Decode(const UInt8* pun_payload, size_t& un_size);
+ *       Returns the records carried by a received payload of un_size
+ *       bytes and sets un_size to their size, or returns NULL if the
+ *       payload must be dropped.
+ *    size_t GetHeapSize() const;
+ *       Returns the bytes the codec allocated on the heap.
+ *
+ * The codecs trade payload room for robustness (see nav_integrity.h):
+ *
+ *    CPlainPayloadCodec   records as they are, no overhead, zero-copy
+ *    CCrcPayloadCodec     records followed by a CRC-8 or CRC-16 of them;
+ *                         payloads that fail the check are dropped
+ *    CSecdedPayloadCodec  every record nibble as a SECDED(8,4) codeword,
+ *                         half the room; single bit errors per codeword
+ *                         are corrected, payloads with more are dropped
+ *
+ * The robots' rab_data_size must leave room for at least one record
+ * once the overhead is taken (11 bytes with CRC-8, 12 with CRC-16, 20
+ * with SECDED).
+ */
+
+#ifndef NAV_PAYLOAD_CODEC_H
+#define NAV_PAYLOAD_CODEC_H
+
+#include <controllers/nav_common/nav_integrity.h>
+
+#include <argos3/core/utility/datatypes/byte_array.h>
+
+#include <vector>
+
+using namespace argos;
+
+class CPlainPayloadCodec {
+
+public:
+
+   inline UInt8* Init(CByteArray& c_payload,
+                      size_t& un_records_size) {
+      un_records_size = c_payload.Size();
+      return c_payload.ToCArray();
+   }
+
+   inline void Encode(CByteArray& c_payload) {}
+
+   inline const UInt8* Decode(const UInt8* pun_payload,
+                              size_t& un_size) {
+      return pun_payload;
+   }
+
+   inline size_t GetHeapSize() const {
+      return 0;
+   }
+
+};
+
+/****************************************/
+/****************************************/
+
+template<class CRC>
+class CCrcPayloadCodec {
+
+public:
+
+   inline UInt8* Init(CByteArray& c_payload,
+                      size_t& un_records_size) {
+      un_records_size = (c_payload.Size() > CRC::SIZE) ? c_payload.Size() - CRC::SIZE : 0;
+      return c_payload.ToCArray();
+   }
+
+   inline void Encode(CByteArray& c_payload) {
+      if(c_payload.Size() < CRC::SIZE) return;
+      size_t unRecordsSize = c_payload.Size() - CRC::SIZE;
+      UInt8* punPayload = c_payload.ToCArray();
+      CRC::Write(CRC::Compute(punPayload, unRecordsSize), punPayload + unRecordsSize);
+   }
+
+   inline const UInt8* Decode(const UInt8* pun_payload,
+                              size_t& un_size) {
+      if(un_size < CRC::SIZE) return NULL;
+      un_size -= CRC::SIZE;
+      if(CRC::Compute(pun_payload, un_size) != CRC::Read(pun_payload + un_size)) return NULL;
+      return pun_payload;
+   }
+
+   inline size_t GetHeapSize() const {
+      return 0;
+   }
+
+};
+
+/****************************************/
+/****************************************/
+
+class CSecdedPayloadCodec {
+
+public:
+
+   inline UInt8* Init(CByteArray& c_payload,
+                      size_t& un_records_size) {
+      un_records_size = c_payload.Size() / 2;
+      m_vecRecords.assign(un_records_size, 0);
+      return m_vecRecords.empty() ? NULL : &m_vecRecords[0];
+   }
+
+   inline void Encode(CByteArray& c_payload) {
+      UInt8* punPayload = c_payload.ToCArray();
+      for(size_t i = 0; i < m_vecRecords.size(); ++i) {
+         punPayload[2 * i]     = CSecded::Encode(m_vecRecords[i] >> 4);
+         punPayload[2 * i + 1] = CSecded::Encode(m_vecRecords[i]);
+      }
+      /* An odd last byte carries nothing */
+      if(c_payload.Size() & 1) {
+         punPayload[c_payload.Size() - 1] = 0;
+      }
+   }
+
+   inline const UInt8* Decode(const UInt8* pun_payload,
+                              size_t& un_size) {
+      un_size /= 2;
+      if(m_vecDecoded.size() < un_size) {
+         m_vecDecoded.resize(un_size);
+      }
+      for(size_t i = 0; i < un_size; ++i) {
+         UInt8 unHigh = CSecded::Decode(pun_payload[2 * i]);
+         UInt8 unLow  = CSecded::Decode(pun_payload[2 * i + 1]);
+         if((unHigh | unLow) == CSecded::INVALID) return NULL;
+         m_vecDecoded[i] = (unHigh << 4) | unLow;
+      }
+      return m_vecDecoded.empty() ? pun_payload : &m_vecDecoded[0];
+   }
+
+   inline size_t GetHeapSize() const {
+      return m_vecRecords.capacity() + m_vecDecoded.capacity();
+   }
+
+private:
+
+   /* Outgoing records, before encoding */
+   std::vector<UInt8> m_vecRecords;
+   /* Records of the last payload received */
+   std::vector<UInt8> m_vecDecoded;
+
+};
+
+typedef CCrcPayloadCodec<CCrc8> CCrc8PayloadCodec;
+typedef CCrcPayloadCodec<CCrc16> CCrc16PayloadCodec;
+
+#endif
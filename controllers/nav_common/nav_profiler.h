@@ -0,0 +1,195 @@
+/*
+ * Per-phase profiling of the navigation control step.
+ *
+ * When the controllers are built with NAV_PROFILING defined
+ * (cmake -DNAV_PROFILING=ON), every robot times the phases of its
+ * ControlStep with the CPU cycle counter and keeps a histogram of the
+ * cycles per phase, with one bucket per power of two. At the end of the
+ * experiment the nav_loop_functions add up the histograms of all the
+ * robots, log a summary and write the histograms to a CSV file.
+ *
+ * Without NAV_PROFILING, NAV_PROFILE_SCOPE expands to nothing and the
+ * controllers carry no profile, so the instrumentation can stay in the
+ * code of production builds.
+ */
+
+#ifndef NAV_PROFILER_H
+#define NAV_PROFILER_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <chrono>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace argos;
+
+/* Phases of the control step */
+enum ENavPhase {
+   /* Odometry update of the nav table */
+   NAV_PHASE_ODOMETRY = 0,
+   /* Channel and payload codec of the received packets */
+   NAV_PHASE_DECODE,
+   /* Merge of the received nav info into the nav table */
+   NAV_PHASE_MERGE,
+   /* Direction requests and replies */
+   NAV_PHASE_REQUESTS,
+   /* Encoding and sending of the nav table */
+   NAV_PHASE_BROADCAST,
+   /* Obstacle avoidance and navigation */
+   NAV_PHASE_MOTION,
+   NAV_PHASE_COUNT
+};
+
+class CNavProfile {
+
+public:
+
+   /* One bucket per power of two of the cycle count */
+   static const size_t BUCKETS = 64;
+
+   struct SPhase {
+      UInt64 Calls;
+      UInt64 Cycles;
+      UInt64 Min;
+      UInt64 Max;
+      /* Bucket i counts the calls that took [2^i, 2^(i+1)) cycles, bucket 0 also 0 */
+      UInt64 Histogram[BUCKETS];
+   };
+
+public:
+
+   CNavProfile() {
+      Clear();
+   }
+
+   inline void Clear() {
+      for(size_t i = 0; i < NAV_PHASE_COUNT; ++i) {
+         SPhase& sPhase = m_psPhases[i];
+         sPhase.Calls = 0;
+         sPhase.Cycles = 0;
+         sPhase.Min = ~static_cast<UInt64>(0);
+         sPhase.Max = 0;
+         for(size_t j = 0; j < BUCKETS; ++j) {
+            sPhase.Histogram[j] = 0;
+         }
+      }
+   }
+
+   /* Records a call of a phase that took un_cycles */
+   inline void Add(UInt32 un_phase,
+                   UInt64 un_cycles) {
+      SPhase& sPhase = m_psPhases[un_phase];
+      ++sPhase.Calls;
+      sPhase.Cycles += un_cycles;
+      if(un_cycles < sPhase.Min) sPhase.Min = un_cycles;
+      if(un_cycles > sPhase.Max) sPhase.Max = un_cycles;
+      ++sPhase.Histogram[63 - __builtin_clzll(un_cycles | 1)];
+   }
+
+   /* Adds the calls of another profile to this one */
+   inline void Merge(const CNavProfile& c_other) {
+      for(size_t i = 0; i < NAV_PHASE_COUNT; ++i) {
+         SPhase& sPhase = m_psPhases[i];
+         const SPhase& sOther = c_other.m_psPhases[i];
+         sPhase.Calls += sOther.Calls;
+         sPhase.Cycles += sOther.Cycles;
+         if(sOther.Min < sPhase.Min) sPhase.Min = sOther.Min;
+         if(sOther.Max > sPhase.Max) sPhase.Max = sOther.Max;
+         for(size_t j = 0; j < BUCKETS; ++j) {
+            sPhase.Histogram[j] += sOther.Histogram[j];
+         }
+      }
+   }
+
+   inline const SPhase& GetPhase(UInt32 un_phase) const {
+      return m_psPhases[un_phase];
+   }
+
+   static inline const char* GetPhaseName(UInt32 un_phase) {
+      static const char* ppchNames[NAV_PHASE_COUNT] = {
+         "odometry", "decode", "merge", "requests", "broadcast", "motion"
+      };
+      return ppchNames[un_phase];
+   }
+
+   /*
+    * Reads the cycle counter: the time stamp counter on x86, the virtual
+    * counter on ARM, nanoseconds elsewhere.
+    */
+   static inline UInt64 Now() {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#elif defined(__aarch64__)
+      UInt64 unCount;
+      asm volatile("mrs %0, cntvct_el0" : "=r"(unCount));
+      return unCount;
+#else
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+   }
+
+   /*
+    * Writes the non-empty buckets of every phase as CSV rows
+    * phase,from_cycles,to_cycles,calls
+    */
+   inline void WriteHistograms(std::ostream& c_out) const {
+      c_out << "phase,from_cycles,to_cycles,calls" << std::endl;
+      for(size_t i = 0; i < NAV_PHASE_COUNT; ++i) {
+         for(size_t j = 0; j < BUCKETS; ++j) {
+            if(m_psPhases[i].Histogram[j] == 0) continue;
+            c_out << GetPhaseName(i) << ","
+                  << ((j == 0) ? 0 : (static_cast<UInt64>(1) << j)) << ","
+                  << ((j == BUCKETS - 1) ? ~static_cast<UInt64>(0) : (static_cast<UInt64>(1) << (j + 1)) - 1) << ","
+                  << m_psPhases[i].Histogram[j] << std::endl;
+         }
+      }
+   }
+
+private:
+
+   SPhase m_psPhases[NAV_PHASE_COUNT];
+
+};
+
+/*
+ * Times the enclosing scope as a call of a phase.
+ */
+class CNavProfileScope {
+
+public:
+
+   CNavProfileScope(CNavProfile& c_profile,
+                    UInt32 un_phase) :
+      m_cProfile(c_profile),
+      m_unPhase(un_phase),
+      m_unStart(CNavProfile::Now()) {}
+
+   ~CNavProfileScope() {
+      m_cProfile.Add(m_unPhase, CNavProfile::Now() - m_unStart);
+   }
+
+private:
+
+   CNavProfile& m_cProfile;
+   UInt32 m_unPhase;
+   UInt64 m_unStart;
+
+};
+
+#define NAV_PROFILE_CONCAT2(A, B) A ## B
+#define NAV_PROFILE_CONCAT(A, B) NAV_PROFILE_CONCAT2(A, B)
+
+#ifdef NAV_PROFILING
+/* Times the rest of the enclosing scope as a call of PHASE in PROFILE */
+#define NAV_PROFILE_SCOPE(PROFILE, PHASE) \
+   CNavProfileScope NAV_PROFILE_CONCAT(cNavProfileScope, __LINE__)(PROFILE, PHASE)
+#else
+#define NAV_PROFILE_SCOPE(PROFILE, PHASE)
+#endif
+
+#endif
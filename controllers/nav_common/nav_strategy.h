@@ -0,0 +1,202 @@
+/*
+ * Navigation strategies, used as a compile-time policy of
+ * CNavigationController.
+ *
+ * The controller follows the chain of nav points the same way whatever
+ * the strategy; the strategy decides what the navigator does when it
+ * reaches its last known nav point without having heard anything better:
+ *
+ *    CStopStrategy      NwS, stop and wait for new information
+ *    CRandomStrategy    NwR, move in a random direction for a random
+ *                       (exponentially distributed) distance
+ *    CDirectedStrategy  NwD, move in the direction the nav point got its
+ *                       information from, as learned with a direction
+ *                       request; fall back to NwR when there is none
+ *
+ * A strategy provides:
+ *
+ *    void Init(CRandom::CRNG* pc_rng, CNavTrace* pc_trace);
+ *       Called once, with the RNG and the trace of the controller (NULL
+ *       when built without tracing, see nav_trace.h).
+ *    bool OnBetterNavInfo(Real f_bearing);
+ *       Called when the navigator switches to a better nav point seen
+ *       at f_bearing. Returns true to send a direction request to it.
+ *    void OnDirectionReply(Real f_bearing, Real f_heading);
+ *       Called when the navigator receives a direction reply.
+ *    bool OnNavPointReached(Real& f_heading, Real& f_distance, Real f_distance_star);
+ *       Called on every tick spent at the nav point. Returns true after
+ *       setting a new heading and distance to travel, false to stop.
+ *    void SaveState(CByteArray& c_state) const;
+ *    void LoadState(CByteArray& c_state);
+ *       Append the strategy state to a snapshot, and read it back.
+ *
+ * The hooks are inline and the controller calls them directly, so the
+ * ones a strategy does not need compile away.
+ */
+
+#ifndef NAV_STRATEGY_H
+#define NAV_STRATEGY_H
+
+#include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
+#include <controllers/nav_common/nav_trace.h>
+
+#include <cmath>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+class CStopStrategy {
+
+public:
+
+   inline void Init(CRandom::CRNG* pc_rng,
+                    CNavTrace* pc_trace) {}
+
+   inline bool OnBetterNavInfo(Real f_bearing) {
+      return false;
+   }
+
+   inline void OnDirectionReply(Real f_bearing,
+                                Real f_heading) {}
+
+   inline bool OnNavPointReached(Real& f_heading,
+                                 Real& f_distance,
+                                 Real f_distance_star) {
+      return false;
+   }
+
+   inline void SaveState(CByteArray& c_state) const {}
+
+   inline void LoadState(CByteArray& c_state) {}
+
+};
+
+/****************************************/
+/****************************************/
+
+class CRandomStrategy {
+
+public:
+
+   CRandomStrategy() :
+      m_pcRNG(NULL),
+      m_pcTrace(NULL) {}
+
+   inline void Init(CRandom::CRNG* pc_rng,
+                    CNavTrace* pc_trace) {
+      m_pcRNG = pc_rng;
+      m_pcTrace = pc_trace;
+   }
+
+   inline bool OnBetterNavInfo(Real f_bearing) {
+      return false;
+   }
+
+   inline void OnDirectionReply(Real f_bearing,
+                                Real f_heading) {}
+
+   inline bool OnNavPointReached(Real& f_heading,
+                                 Real& f_distance,
+                                 Real f_distance_star) {
+      f_heading = m_pcRNG->Uniform(CRange<Real>(-ARGOS_PI, ARGOS_PI));
+      f_distance = m_pcRNG->Exponential(150);
+      NAV_TRACE_INFO(*m_pcTrace, NAV_TRACE_NAV_POINT_RANDOM, 0, f_heading, f_distance);
+      return true;
+   }
+
+   /* The RNG belongs to the controller, nothing else to save */
+   inline void SaveState(CByteArray& c_state) const {}
+
+   inline void LoadState(CByteArray& c_state) {}
+
+private:
+
+   CRandom::CRNG* m_pcRNG;
+   CNavTrace* m_pcTrace;
+
+};
+
+/****************************************/
+/****************************************/
+
+class CDirectedStrategy {
+
+public:
+
+   /* Replies coming from further than this from the nav point are ignored, in radians */
+   static constexpr Real BEARING_TOLERANCE = 0.1;
+
+public:
+
+   CDirectedStrategy() :
+      m_pcTrace(NULL),
+      m_fLastBearing(0.0),
+      m_fNextHeading(0.0),
+      m_bHasNextHeading(false) {}
+
+   inline void Init(CRandom::CRNG* pc_rng,
+                    CNavTrace* pc_trace) {
+      m_cFallback.Init(pc_rng, pc_trace);
+      m_pcTrace = pc_trace;
+      m_fLastBearing = 0.0;
+      m_bHasNextHeading = false;
+   }
+
+   inline bool OnBetterNavInfo(Real f_bearing) {
+      m_fLastBearing = f_bearing;
+      return true;
+   }
+
+   inline void OnDirectionReply(Real f_bearing,
+                                Real f_heading) {
+      /* Only accept the reply of the robot that just gave us new nav info */
+      if(std::abs(f_bearing - m_fLastBearing) > BEARING_TOLERANCE) return;
+      m_fNextHeading = f_heading;
+      m_bHasNextHeading = true;
+      NAV_TRACE_INFO(*m_pcTrace, NAV_TRACE_NEXT_HEADING, 0, m_fNextHeading, f_bearing);
+   }
+
+   inline bool OnNavPointReached(Real& f_heading,
+                                 Real& f_distance,
+                                 Real f_distance_star) {
+      if(!m_bHasNextHeading) {
+         return m_cFallback.OnNavPointReached(f_heading, f_distance, f_distance_star);
+      }
+      /* Go toward the saved heading, no better info has been found */
+      f_heading = m_fNextHeading;
+      f_distance = f_distance_star;
+      NAV_TRACE_INFO(*m_pcTrace, NAV_TRACE_NAV_POINT_SAVED, 0, f_heading, f_distance);
+      m_bHasNextHeading = false;
+      return true;
+   }
+
+   inline void SaveState(CByteArray& c_state) const {
+      c_state << m_fLastBearing
+              << m_fNextHeading
+              << static_cast<UInt8>(m_bHasNextHeading);
+   }
+
+   inline void LoadState(CByteArray& c_state) {
+      UInt8 unHasNextHeading;
+      c_state >> m_fLastBearing
+              >> m_fNextHeading
+              >> unHasNextHeading;
+      m_bHasNextHeading = (unHasNextHeading != 0);
+   }
+
+private:
+
+   CRandomStrategy m_cFallback;
+   CNavTrace* m_pcTrace;
+   /* Bearing of the nav point the last direction request went to */
+   Real m_fLastBearing;
+   /* Heading to take at the nav point, if its direction reply arrived */
+   Real m_fNextHeading;
+   bool m_bHasNextHeading;
+
+};
+
+#endif
@@ -0,0 +1,184 @@
+/*
+ * Navigation table shared by the navigation controllers.
+ *
+ * Each entry holds what a robot knows about one target: the freshest
+ * sequence number it heard, the estimated distance to the target and the
+ * bearing the information came from. Target ids are UInt8 on the wire,
+ * so the table is a fixed-capacity flat structure for 256 targets:
+ *
+ * - a direct-indexed slot map (target id -> slot) gives O(1) lookups;
+ * - the entries themselves are stored densely and sorted by target id,
+ *   so the per-tick walk over the known targets touches contiguous
+ *   memory and visits targets in the same order std::map did.
+ *
+ * Insertions of new targets shift the dense arrays to keep them sorted;
+ * they only happen the first time a robot hears about a target.
+ *
+ * The robot's own motion changes every distance and heading in the table
+ * by the same amount, so the entries are stored relative to an odometry
+ * epoch (the distance and rotation accumulated since the table was
+ * created) and Move() only updates the epoch: it costs the same with one
+ * known target or 256. Entries are materialized against the epoch when
+ * they are read, which is why they are returned by value.
+ */
+
+#ifndef NAV_TABLE_H
+#define NAV_TABLE_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <cstddef>
+
+using namespace argos;
+
+/* An entry as seen from the robot's current pose */
+struct NavTableEntry {
+   UInt32 sequence_number;
+   float distance;
+   Real heading;
+};
+
+class CNavTable {
+
+public:
+
+   /* Number of distinct target ids */
+   static const size_t CAPACITY = 256;
+
+public:
+
+   CNavTable() :
+      m_unSize(0),
+      m_fEpochDistance(0.0),
+      m_fEpochRotation(0.0) {
+      for(size_t i = 0; i < CAPACITY; ++i) {
+         m_punSlots[i] = NO_SLOT;
+      }
+   }
+
+   /* Number of known targets */
+   inline size_t Size() const {
+      return m_unSize;
+   }
+
+   inline bool Empty() const {
+      return m_unSize == 0;
+   }
+
+   inline bool Contains(UInt8 un_target) const {
+      return m_punSlots[un_target] != NO_SLOT;
+   }
+
+   /*
+    * Copies the entry of a target into s_entry.
+    * Returns false, leaving s_entry untouched, if the target is unknown.
+    */
+   inline bool Find(UInt8 un_target,
+                    NavTableEntry& s_entry) const {
+      UInt16 unSlot = m_punSlots[un_target];
+      if(unSlot == NO_SLOT) return false;
+      s_entry = Materialize(m_psEntries[unSlot]);
+      return true;
+   }
+
+   /* Inserts or overwrites the entry of a target */
+   inline void Insert(UInt8 un_target,
+                      const NavTableEntry& s_entry) {
+      UInt16 unSlot = m_punSlots[un_target];
+      if(unSlot == NO_SLOT) {
+         /* New target: make room for it, keeping the entries sorted by id */
+         unSlot = m_unSize;
+         while(unSlot > 0 && m_punTargets[unSlot - 1] > un_target) {
+            m_punTargets[unSlot] = m_punTargets[unSlot - 1];
+            m_psEntries[unSlot] = m_psEntries[unSlot - 1];
+            m_punSlots[m_punTargets[unSlot]] = unSlot;
+            --unSlot;
+         }
+         m_punTargets[unSlot] = un_target;
+         m_punSlots[un_target] = unSlot;
+         ++m_unSize;
+      }
+      m_psEntries[unSlot].SequenceNumber = s_entry.sequence_number;
+      m_psEntries[unSlot].Distance = s_entry.distance - m_fEpochDistance;
+      m_psEntries[unSlot].Heading = s_entry.heading + m_fEpochRotation;
+   }
+
+   /* Increments the sequence number of a known target */
+   inline void IncrementSequenceNumber(UInt8 un_target) {
+      UInt16 unSlot = m_punSlots[un_target];
+      if(unSlot != NO_SLOT) {
+         ++m_psEntries[unSlot].SequenceNumber;
+      }
+   }
+
+   /* Forgets all the targets */
+   inline void Clear() {
+      for(size_t i = 0; i < m_unSize; ++i) {
+         m_punSlots[m_punTargets[i]] = NO_SLOT;
+      }
+      m_unSize = 0;
+      /* Nothing is relative to the epoch anymore, start over */
+      m_fEpochDistance = 0.0;
+      m_fEpochRotation = 0.0;
+   }
+
+   /*
+    * Applies the robot's own motion to all the entries: the robot moved
+    * away from every nav point by f_distance and turned by f_rotation.
+    */
+   inline void Move(Real f_distance,
+                    Real f_rotation) {
+      m_fEpochDistance += f_distance;
+      m_fEpochRotation += f_rotation;
+   }
+
+   /*
+    * Dense access, in increasing target id order.
+    * un_index must be smaller than Size().
+    */
+   inline UInt8 GetTarget(size_t un_index) const {
+      return m_punTargets[un_index];
+   }
+
+   inline NavTableEntry GetEntry(size_t un_index) const {
+      return Materialize(m_psEntries[un_index]);
+   }
+
+private:
+
+   /* An entry relative to the odometry epoch */
+   struct SStoredEntry {
+      UInt32 SequenceNumber;
+      /* Distance minus the epoch distance at the time of insertion */
+      Real Distance;
+      /* Heading plus the epoch rotation at the time of insertion */
+      Real Heading;
+   };
+
+   inline NavTableEntry Materialize(const SStoredEntry& s_entry) const {
+      NavTableEntry sEntry;
+      sEntry.sequence_number = s_entry.SequenceNumber;
+      sEntry.distance = s_entry.Distance + m_fEpochDistance;
+      sEntry.heading = s_entry.Heading - m_fEpochRotation;
+      return sEntry;
+   }
+
+private:
+
+   static const UInt16 NO_SLOT = 0xFFFF;
+
+   /* Dense, sorted storage */
+   SStoredEntry m_psEntries[CAPACITY];
+   UInt8 m_punTargets[CAPACITY];
+   size_t m_unSize;
+
+   /* Target id -> slot in the dense storage, or NO_SLOT */
+   UInt16 m_punSlots[CAPACITY];
+
+   /* Odometry accumulated since the epoch */
+   Real m_fEpochDistance;
+   Real m_fEpochRotation;
+
+};
+
+#endif
@@ -0,0 +1,215 @@
+/*
+ * Diagnostic trace of the navigation controllers.
+ *
+ * Instead of formatting text, the controllers record what they decide
+ * as fixed-size binary events into a ring buffer of their own: no
+ * formatting, no allocation and nothing shared between robots, so
+ * tracing can stay on in large swarms and under multi-threaded steps.
+ * The nav_loop_functions drain the rings between steps into a binary
+ * file, which nav_trace_decode turns into CSV offline.
+ *
+ * Which events are recorded is decided at compile time by NAV_TRACE_LEVEL
+ * (cmake -DNAV_TRACE_LEVEL=<n>; by default 2 in Debug builds, 0
+ * otherwise):
+ *
+ *    0  NAV_TRACE_LEVEL_OFF      nothing, the controllers carry no trace
+ *    1  NAV_TRACE_LEVEL_INFO     decisions of the navigator: hops, nav
+ *                                points, arrival
+ *    2  NAV_TRACE_LEVEL_DEBUG    messages: nav table updates, direction
+ *                                requests and replies
+ *    3  NAV_TRACE_LEVEL_VERBOSE  every packet received
+ *
+ * The NAV_TRACE_INFO, NAV_TRACE_DEBUG and NAV_TRACE_VERBOSE macros
+ * expand to nothing above the level, arguments included.
+ *
+ * Events carry the tick, a type, a small integer (usually a target id)
+ * and two values:
+ *
+ *    type                  level    target       value0          value1
+ *    hop                   info     target       distance (cm)   heading (rad)
+ *    nav_point_random      info     -            heading (rad)   distance (cm)
+ *    nav_point_saved       info     -            heading (rad)   distance (cm)
+ *    next_heading          info     -            heading (rad)   bearing (rad)
+ *    arrived               info     target       distance (cm)   heading (rad)
+ *    table_update          debug    target       distance (cm)   heading (rad)
+ *    direction_request     debug    target       -               -
+ *    direction_reply       debug    target       heading (rad)   -
+ *    packet                verbose  size (B)     range (cm)      bearing (rad)
+ *    packet_ignored        verbose  reason       range (cm)      bearing (rad)
+ *
+ * where the reason a packet is ignored is 0 if it came from beyond
+ * comm_range, 1 if it was lost in the channel or codec.
+ */
+
+#ifndef NAV_TRACE_H
+#define NAV_TRACE_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+using namespace argos;
+
+#define NAV_TRACE_LEVEL_OFF     0
+#define NAV_TRACE_LEVEL_INFO    1
+#define NAV_TRACE_LEVEL_DEBUG   2
+#define NAV_TRACE_LEVEL_VERBOSE 3
+
+#ifndef NAV_TRACE_LEVEL
+#define NAV_TRACE_LEVEL NAV_TRACE_LEVEL_OFF
+#endif
+
+/* Types of events */
+enum ENavTraceEvent {
+   NAV_TRACE_HOP = 0,
+   NAV_TRACE_NAV_POINT_RANDOM,
+   NAV_TRACE_NAV_POINT_SAVED,
+   NAV_TRACE_NEXT_HEADING,
+   NAV_TRACE_ARRIVED,
+   NAV_TRACE_TABLE_UPDATE,
+   NAV_TRACE_DIRECTION_REQUEST,
+   NAV_TRACE_DIRECTION_REPLY,
+   NAV_TRACE_PACKET,
+   NAV_TRACE_PACKET_IGNORED,
+   NAV_TRACE_EVENT_COUNT
+};
+
+/* An event, as stored in the ring and in the trace file */
+struct SNavTraceEvent {
+   UInt32 Tick;
+   UInt16 Type;
+   UInt16 Target;
+   float Values[2];
+};
+
+static_assert(sizeof(SNavTraceEvent) == 16, "trace events must be 16 bytes");
+
+class CNavTrace {
+
+public:
+
+   /* Events per robot, unless set otherwise */
+   static const size_t DEFAULT_CAPACITY = 1024;
+
+public:
+
+   CNavTrace() :
+      m_unTick(0),
+      m_unWritten(0),
+      m_unRead(0) {
+      SetCapacity(DEFAULT_CAPACITY);
+   }
+
+   /* Sets the number of events the ring holds, rounded up to a power of two, and empties it */
+   inline void SetCapacity(size_t un_capacity) {
+      size_t unSize = 1;
+      while(unSize < un_capacity) unSize <<= 1;
+      m_vecEvents.assign(unSize, SNavTraceEvent());
+      m_unMask = unSize - 1;
+      Clear();
+   }
+
+   inline size_t GetCapacity() const {
+      return m_vecEvents.size();
+   }
+
+   inline void Clear() {
+      m_unWritten.store(0, std::memory_order_relaxed);
+      m_unRead = 0;
+   }
+
+   /* Sets the tick of the next events */
+   inline void SetTick(UInt32 un_tick) {
+      m_unTick = un_tick;
+   }
+
+   /*
+    * Records an event, overwriting the oldest one if the ring is full.
+    * Only the robot that owns the trace records into it.
+    */
+   inline void Record(UInt16 un_type,
+                      UInt16 un_target,
+                      Real f_value0,
+                      Real f_value1) {
+      UInt64 unWritten = m_unWritten.load(std::memory_order_relaxed);
+      SNavTraceEvent& sEvent = m_vecEvents[unWritten & m_unMask];
+      sEvent.Tick = m_unTick;
+      sEvent.Type = un_type;
+      sEvent.Target = un_target;
+      sEvent.Values[0] = f_value0;
+      sEvent.Values[1] = f_value1;
+      m_unWritten.store(unWritten + 1, std::memory_order_release);
+   }
+
+   /* Number of events recorded and not drained yet, lost ones included */
+   inline UInt64 GetPending() const {
+      return m_unWritten.load(std::memory_order_acquire) - m_unRead;
+   }
+
+   /*
+    * Passes the events recorded since the last call, oldest first, to
+    * c_sink(const SNavTraceEvent* ps_events, size_t un_count), in at most
+    * two contiguous pieces. Returns how many events were overwritten
+    * before they could be drained. Must not run during the control step
+    * of the robot.
+    */
+   template<class SINK>
+   inline UInt64 Drain(SINK c_sink) {
+      UInt64 unWritten = m_unWritten.load(std::memory_order_acquire);
+      UInt64 unLost = 0;
+      if(unWritten - m_unRead > m_vecEvents.size()) {
+         unLost = unWritten - m_unRead - m_vecEvents.size();
+         m_unRead += unLost;
+      }
+      while(m_unRead < unWritten) {
+         size_t unStart = m_unRead & m_unMask;
+         size_t unCount = std::min<UInt64>(unWritten - m_unRead, m_vecEvents.size() - unStart);
+         c_sink(&m_vecEvents[unStart], unCount);
+         m_unRead += unCount;
+      }
+      return unLost;
+   }
+
+   static inline const char* GetEventName(UInt32 un_type) {
+      static const char* ppchNames[NAV_TRACE_EVENT_COUNT] = {
+         "hop", "nav_point_random", "nav_point_saved", "next_heading", "arrived",
+         "table_update", "direction_request", "direction_reply",
+         "packet", "packet_ignored"
+      };
+      return (un_type < NAV_TRACE_EVENT_COUNT) ? ppchNames[un_type] : "unknown";
+   }
+
+private:
+
+   std::vector<SNavTraceEvent> m_vecEvents;
+   size_t m_unMask;
+   UInt32 m_unTick;
+   /* Events recorded since the last Clear(), written by the robot only */
+   std::atomic<UInt64> m_unWritten;
+   /* Events drained, read and written by the reader only */
+   UInt64 m_unRead;
+
+};
+
+/* Records an event of the given level in TRACE, see the table above */
+#if NAV_TRACE_LEVEL >= NAV_TRACE_LEVEL_INFO
+#define NAV_TRACE_INFO(TRACE, TYPE, TARGET, VALUE0, VALUE1) (TRACE).Record(TYPE, TARGET, VALUE0, VALUE1)
+#else
+#define NAV_TRACE_INFO(TRACE, TYPE, TARGET, VALUE0, VALUE1)
+#endif
+
+#if NAV_TRACE_LEVEL >= NAV_TRACE_LEVEL_DEBUG
+#define NAV_TRACE_DEBUG(TRACE, TYPE, TARGET, VALUE0, VALUE1) (TRACE).Record(TYPE, TARGET, VALUE0, VALUE1)
+#else
+#define NAV_TRACE_DEBUG(TRACE, TYPE, TARGET, VALUE0, VALUE1)
+#endif
+
+#if NAV_TRACE_LEVEL >= NAV_TRACE_LEVEL_VERBOSE
+#define NAV_TRACE_VERBOSE(TRACE, TYPE, TARGET, VALUE0, VALUE1) (TRACE).Record(TYPE, TARGET, VALUE0, VALUE1)
+#else
+#define NAV_TRACE_VERBOSE(TRACE, TYPE, TARGET, VALUE0, VALUE1)
+#endif
+
+#endif
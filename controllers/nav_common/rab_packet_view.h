@@ -0,0 +1,138 @@
+/*
+ * Read-only view of a range-and-bearing packet.
+ *
+ * The view decodes fields straight out of the payload owned by the
+ * sensor readings: nothing is copied and nothing is allocated, and
+ * reading a field only advances a cursor (CByteArray::PopFront instead
+ * shifts the whole buffer on every call).
+ *
+ * Multi-byte fields use the same network byte order as CByteArray's
+ * operator<<, so the view decodes data written with it. Reading past
+ * the end of the payload yields zeros and marks the view as overrun,
+ * instead of throwing.
+ */
+
+#ifndef RAB_PACKET_VIEW_H
+#define RAB_PACKET_VIEW_H
+
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
+
+#include <cstring>
+
+using namespace argos;
+
+class CRABPacketView {
+
+public:
+
+   explicit CRABPacketView(const CCI_RangeAndBearingSensor::SPacket& s_packet) :
+      m_sPacket(s_packet),
+      m_punData(s_packet.Data.ToCArray()),
+      m_unSize(s_packet.Data.Size()),
+      m_unCursor(0),
+      m_bOverrun(false) {}
+
+   /*
+    * View over a payload held outside s_packet (e.g. after the channel
+    * and the payload codec): range and bearing come from s_packet, the
+    * data from pun_data.
+    */
+   CRABPacketView(const CCI_RangeAndBearingSensor::SPacket& s_packet,
+                  const UInt8* pun_data,
+                  size_t un_size) :
+      m_sPacket(s_packet),
+      m_punData(pun_data),
+      m_unSize(un_size),
+      m_unCursor(0),
+      m_bOverrun(false) {}
+
+   /* Distance of the sender, in cm */
+   inline Real GetRange() const {
+      return m_sPacket.Range;
+   }
+
+   /* Bearing of the sender, in the robot's frame */
+   inline const CRadians& GetHorizontalBearing() const {
+      return m_sPacket.HorizontalBearing;
+   }
+
+   /* Payload size, in bytes */
+   inline size_t Size() const {
+      return m_unSize;
+   }
+
+   /* Bytes left after the cursor */
+   inline size_t Remaining() const {
+      return m_unSize - m_unCursor;
+   }
+
+   /* Pointer to the raw payload */
+   inline const UInt8* Data() const {
+      return m_punData;
+   }
+
+   /* True if a read went past the end of the payload */
+   inline bool IsOverrun() const {
+      return m_bOverrun;
+   }
+
+   /*
+    * Returns the next un_bytes bytes of the payload and moves past them,
+    * or NULL if fewer bytes are left. Used to walk fixed-size records.
+    */
+   inline const UInt8* ReadRecord(size_t un_bytes) {
+      if(m_unCursor + un_bytes > m_unSize) return NULL;
+      const UInt8* punRecord = m_punData + m_unCursor;
+      m_unCursor += un_bytes;
+      return punRecord;
+   }
+
+   inline void Skip(size_t un_bytes) {
+      if(Reserve(un_bytes)) m_unCursor += un_bytes;
+   }
+
+   inline UInt8 ReadUInt8() {
+      if(!Reserve(1)) return 0;
+      return m_punData[m_unCursor++];
+   }
+
+   inline UInt32 ReadUInt32() {
+      if(!Reserve(4)) return 0;
+      const UInt8* punBytes = m_punData + m_unCursor;
+      m_unCursor += 4;
+      return (static_cast<UInt32>(punBytes[0]) << 24) |
+             (static_cast<UInt32>(punBytes[1]) << 16) |
+             (static_cast<UInt32>(punBytes[2]) <<  8) |
+              static_cast<UInt32>(punBytes[3]);
+   }
+
+   /* Reads a float sent as the bits of a UInt32 */
+   inline float ReadFloat() {
+      UInt32 unBits = ReadUInt32();
+      float fValue;
+      ::memcpy(&fValue, &unBits, sizeof(fValue));
+      return fValue;
+   }
+
+private:
+
+   inline bool Reserve(size_t un_bytes) {
+      if(m_unCursor + un_bytes > m_unSize) {
+         m_bOverrun = true;
+         m_unCursor = m_unSize;
+         return false;
+      }
+      return true;
+   }
+
+private:
+
+   const CCI_RangeAndBearingSensor::SPacket& m_sPacket;
+   const UInt8* m_punData;
+   size_t m_unSize;
+   size_t m_unCursor;
+   bool m_bOverrun;
+
+};
+
+#endif
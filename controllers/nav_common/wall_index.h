@@ -0,0 +1,293 @@
+/*
+ * Grid index of the static walls of an arena, for line-of-sight tests.
+ *
+ * The walls are the boxes of the arena, seen from above: rectangles
+ * with a position, a size, a rotation around Z and a height. They are
+ * added once, then Build() rasterises them into a uniform grid whose
+ * cells list the walls that overlap them. A line of sight is tested by
+ * walking the cells the segment crosses and intersecting it exactly
+ * with the walls of those cells only, so the cost depends on the length
+ * of the segment and on the walls next to it, not on the size of the
+ * arena. The segments are taken as horizontal: a wall blocks a segment
+ * if it crosses it in the plane and rises above the lower end.
+ *
+ * The index is read-only once built, so any number of threads can
+ * query it at the same time.
+ */
+
+#ifndef WALL_INDEX_H
+#define WALL_INDEX_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/vector2.h>
+#include <argos3/core/utility/math/angles.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace argos;
+
+class CWallIndex {
+
+public:
+
+   CWallIndex() :
+      m_fCellSize(0.25),
+      m_nColumns(0),
+      m_nRows(0),
+      m_fMinX(0.0),
+      m_fMinY(0.0) {}
+
+   /*
+    * Adds a wall centered in c_center, with the given full size, rotated
+    * by c_yaw around Z and rising to f_top. Build() must be called
+    * afterwards.
+    */
+   inline void AddWall(const CVector2& c_center,
+                       const CVector2& c_size,
+                       const CRadians& c_yaw,
+                       Real f_top) {
+      SWall sWall;
+      sWall.X = c_center.GetX();
+      sWall.Y = c_center.GetY();
+      sWall.HalfX = c_size.GetX() / 2.0;
+      sWall.HalfY = c_size.GetY() / 2.0;
+      sWall.Cos = std::cos(c_yaw.GetValue());
+      sWall.Sin = std::sin(c_yaw.GetValue());
+      sWall.Top = f_top;
+      m_vecWalls.push_back(sWall);
+   }
+
+   /* Rasterises the walls into cells of f_cell_size meters */
+   inline void Build(Real f_cell_size) {
+      m_fCellSize = f_cell_size;
+      m_vecCellStart.clear();
+      m_vecCellWalls.clear();
+      if(m_vecWalls.empty()) {
+         m_nColumns = m_nRows = 0;
+         return;
+      }
+      /* The grid covers the bounding box of the walls */
+      Real fMaxX = -std::numeric_limits<Real>::max();
+      Real fMaxY = -std::numeric_limits<Real>::max();
+      m_fMinX = m_fMinY = std::numeric_limits<Real>::max();
+      for(size_t i = 0; i < m_vecWalls.size(); ++i) {
+         Real pfBox[4];
+         GetBounds(m_vecWalls[i], pfBox);
+         m_fMinX = std::min(m_fMinX, pfBox[0]);
+         m_fMinY = std::min(m_fMinY, pfBox[1]);
+         fMaxX = std::max(fMaxX, pfBox[2]);
+         fMaxY = std::max(fMaxY, pfBox[3]);
+      }
+      m_nColumns = static_cast<SInt32>(std::floor((fMaxX - m_fMinX) / m_fCellSize)) + 1;
+      m_nRows = static_cast<SInt32>(std::floor((fMaxY - m_fMinY) / m_fCellSize)) + 1;
+      /* Count the walls of every cell, then fill them in */
+      m_vecCellStart.assign(m_nColumns * m_nRows + 1, 0);
+      for(int nPass = 0; nPass < 2; ++nPass) {
+         std::vector<UInt32> vecFill;
+         if(nPass == 1) {
+            for(size_t c = 1; c < m_vecCellStart.size(); ++c) {
+               m_vecCellStart[c] += m_vecCellStart[c - 1];
+            }
+            m_vecCellWalls.resize(m_vecCellStart.back());
+            vecFill.assign(m_vecCellStart.begin(), m_vecCellStart.end() - 1);
+         }
+         for(size_t i = 0; i < m_vecWalls.size(); ++i) {
+            Real pfBox[4];
+            GetBounds(m_vecWalls[i], pfBox);
+            SInt32 nX0 = CellX(pfBox[0]), nX1 = CellX(pfBox[2]);
+            SInt32 nY0 = CellY(pfBox[1]), nY1 = CellY(pfBox[3]);
+            for(SInt32 y = nY0; y <= nY1; ++y) {
+               for(SInt32 x = nX0; x <= nX1; ++x) {
+                  size_t unCell = y * m_nColumns + x;
+                  if(nPass == 0) ++m_vecCellStart[unCell + 1];
+                  else m_vecCellWalls[vecFill[unCell]++] = i;
+               }
+            }
+         }
+      }
+   }
+
+   /* Removes all the walls */
+   inline void Clear() {
+      m_vecWalls.clear();
+      Build(m_fCellSize);
+   }
+
+   inline size_t GetNumWalls() const {
+      return m_vecWalls.size();
+   }
+
+   /*
+    * Returns true if a wall higher than f_height crosses the segment
+    * between c_from and c_to.
+    */
+   inline bool IsOccluded(const CVector2& c_from,
+                          const CVector2& c_to,
+                          Real f_height) const {
+      if(m_nColumns == 0) return false;
+      Real fAX = c_from.GetX(), fAY = c_from.GetY();
+      Real fDX = c_to.GetX() - fAX, fDY = c_to.GetY() - fAY;
+      /* Clip the segment to the grid */
+      Real fT0 = 0.0, fT1 = 1.0;
+      if(!Clip(-fDX, fAX - m_fMinX, fT0, fT1) ||
+         !Clip( fDX, m_fMinX + m_nColumns * m_fCellSize - fAX, fT0, fT1) ||
+         !Clip(-fDY, fAY - m_fMinY, fT0, fT1) ||
+         !Clip( fDY, m_fMinY + m_nRows * m_fCellSize - fAY, fT0, fT1)) {
+         return false;
+      }
+      /* Walk the cells from fT0 to fT1 */
+      SInt32 nX = CellX(fAX + fT0 * fDX), nY = CellY(fAY + fT0 * fDY);
+      SInt32 nEndX = CellX(fAX + fT1 * fDX), nEndY = CellY(fAY + fT1 * fDY);
+      SInt32 nStepX = (fDX > 0.0) ? 1 : -1;
+      SInt32 nStepY = (fDY > 0.0) ? 1 : -1;
+      Real fNextX = std::numeric_limits<Real>::max(), fDeltaX = std::numeric_limits<Real>::max();
+      Real fNextY = std::numeric_limits<Real>::max(), fDeltaY = std::numeric_limits<Real>::max();
+      if(fDX != 0.0) {
+         fNextX = (m_fMinX + (nX + (nStepX > 0)) * m_fCellSize - fAX) / fDX;
+         fDeltaX = m_fCellSize / std::fabs(fDX);
+      }
+      if(fDY != 0.0) {
+         fNextY = (m_fMinY + (nY + (nStepY > 0)) * m_fCellSize - fAY) / fDY;
+         fDeltaY = m_fCellSize / std::fabs(fDY);
+      }
+      while(true) {
+         if(CellBlocks(nX, nY, fAX, fAY, fDX, fDY, f_height)) return true;
+         if(nX == nEndX && nY == nEndY) return false;
+         if(fNextX < fNextY) {
+            nX += nStepX;
+            fNextX += fDeltaX;
+         }
+         else if(fNextY < fNextX) {
+            nY += nStepY;
+            fNextY += fDeltaY;
+         }
+         else {
+            /* Through a corner: the two cells beside it are touched too */
+            if(CellBlocks(nX + nStepX, nY, fAX, fAY, fDX, fDY, f_height) ||
+               CellBlocks(nX, nY + nStepY, fAX, fAY, fDX, fDY, f_height)) return true;
+            nX += nStepX;
+            nY += nStepY;
+            fNextX += fDeltaX;
+            fNextY += fDeltaY;
+         }
+         if(nX < 0 || nX >= m_nColumns || nY < 0 || nY >= m_nRows) return false;
+      }
+   }
+
+   /*
+    * Same test against every wall, without the grid. Used to check the
+    * index and as the baseline of the benchmark.
+    */
+   inline bool IsOccludedBruteForce(const CVector2& c_from,
+                                    const CVector2& c_to,
+                                    Real f_height) const {
+      Real fAX = c_from.GetX(), fAY = c_from.GetY();
+      Real fDX = c_to.GetX() - fAX, fDY = c_to.GetY() - fAY;
+      for(size_t i = 0; i < m_vecWalls.size(); ++i) {
+         if(m_vecWalls[i].Top > f_height &&
+            Crosses(m_vecWalls[i], fAX, fAY, fDX, fDY)) return true;
+      }
+      return false;
+   }
+
+private:
+
+   struct SWall {
+      Real X, Y;
+      Real HalfX, HalfY;
+      Real Cos, Sin;
+      Real Top;
+   };
+
+   /* Axis-aligned bounds of a wall: min x, min y, max x, max y */
+   static inline void GetBounds(const SWall& s_wall,
+                                Real* pf_box) {
+      Real fExtentX = std::fabs(s_wall.HalfX * s_wall.Cos) + std::fabs(s_wall.HalfY * s_wall.Sin);
+      Real fExtentY = std::fabs(s_wall.HalfX * s_wall.Sin) + std::fabs(s_wall.HalfY * s_wall.Cos);
+      pf_box[0] = s_wall.X - fExtentX;
+      pf_box[1] = s_wall.Y - fExtentY;
+      pf_box[2] = s_wall.X + fExtentX;
+      pf_box[3] = s_wall.Y + fExtentY;
+   }
+
+   inline SInt32 CellX(Real f_x) const {
+      return std::min(std::max(static_cast<SInt32>(std::floor((f_x - m_fMinX) / m_fCellSize)), 0), m_nColumns - 1);
+   }
+
+   inline SInt32 CellY(Real f_y) const {
+      return std::min(std::max(static_cast<SInt32>(std::floor((f_y - m_fMinY) / m_fCellSize)), 0), m_nRows - 1);
+   }
+
+   /* Liang-Barsky clipping of the parameter range against one side */
+   static inline bool Clip(Real f_p,
+                           Real f_q,
+                           Real& f_t0,
+                           Real& f_t1) {
+      if(f_p == 0.0) return f_q >= 0.0;
+      Real fT = f_q / f_p;
+      if(f_p < 0.0) {
+         if(fT > f_t1) return false;
+         if(fT > f_t0) f_t0 = fT;
+      }
+      else {
+         if(fT < f_t0) return false;
+         if(fT < f_t1) f_t1 = fT;
+      }
+      return true;
+   }
+
+   /* Whether the segment (f_ax,f_ay) + t (f_dx,f_dy), t in [0,1], crosses a wall */
+   static inline bool Crosses(const SWall& s_wall,
+                              Real f_ax,
+                              Real f_ay,
+                              Real f_dx,
+                              Real f_dy) {
+      /* Move the segment into the frame of the wall, and clip it to the box */
+      Real fRX = f_ax - s_wall.X, fRY = f_ay - s_wall.Y;
+      Real fLX =  fRX * s_wall.Cos + fRY * s_wall.Sin;
+      Real fLY = -fRX * s_wall.Sin + fRY * s_wall.Cos;
+      Real fLDX =  f_dx * s_wall.Cos + f_dy * s_wall.Sin;
+      Real fLDY = -f_dx * s_wall.Sin + f_dy * s_wall.Cos;
+      Real fT0 = 0.0, fT1 = 1.0;
+      return
+         Clip(-fLDX, fLX + s_wall.HalfX, fT0, fT1) &&
+         Clip( fLDX, s_wall.HalfX - fLX, fT0, fT1) &&
+         Clip(-fLDY, fLY + s_wall.HalfY, fT0, fT1) &&
+         Clip( fLDY, s_wall.HalfY - fLY, fT0, fT1);
+   }
+
+   inline bool CellBlocks(SInt32 n_x,
+                          SInt32 n_y,
+                          Real f_ax,
+                          Real f_ay,
+                          Real f_dx,
+                          Real f_dy,
+                          Real f_height) const {
+      if(n_x < 0 || n_x >= m_nColumns || n_y < 0 || n_y >= m_nRows) return false;
+      size_t unCell = n_y * m_nColumns + n_x;
+      for(UInt32 i = m_vecCellStart[unCell]; i < m_vecCellStart[unCell + 1]; ++i) {
+         const SWall& sWall = m_vecWalls[m_vecCellWalls[i]];
+         if(sWall.Top > f_height && Crosses(sWall, f_ax, f_ay, f_dx, f_dy)) return true;
+      }
+      return false;
+   }
+
+private:
+
+   std::vector<SWall> m_vecWalls;
+   Real m_fCellSize;
+   SInt32 m_nColumns;
+   SInt32 m_nRows;
+   /* Corner of the grid */
+   Real m_fMinX;
+   Real m_fMinY;
+   /* Walls of cell c: m_vecCellWalls[m_vecCellStart[c]] to m_vecCellWalls[m_vecCellStart[c + 1] - 1] */
+   std::vector<UInt32> m_vecCellStart;
+   std::vector<UInt32> m_vecCellWalls;
+
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "nav_rab_sensor.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/plugins/simulator/entities/box_entity.h>
+#include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
+#include <argos3/plugins/simulator/media/rab_medium.h>
+
+#include <map>
+#include <mutex>
+
+/* Range of the inclination of the noise vector, as in the default sensor */
+static const CRange<CRadians> INCLINATION_RANGE(CRadians(0), CRadians(ARGOS_PI));
+
+/****************************************/
+/****************************************/
+
+CNavRABSensor::CNavRABSensor() :
+   m_fCellSize(0.25) {}
+
+/****************************************/
+/****************************************/
+
+void CNavRABSensor::Init(TConfigurationNode& t_tree) {
+   CRangeAndBearingDefaultSensor::Init(t_tree);
+   GetNodeAttributeOrDefault(t_tree, "wall_cell_size", m_fCellSize, m_fCellSize);
+   if(m_fCellSize <= 0.0) {
+      THROW_ARGOSEXCEPTION("wall_cell_size must be positive, got " << m_fCellSize);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavRABSensor::Update() {
+   /*
+    * The boxes may be added to the space after the robots, so the walls
+    * are read on the first update rather than in Init()
+    */
+   if(!m_pcWalls) {
+      m_pcWalls = GetWallIndex(m_fCellSize);
+   }
+   m_tReadings.clear();
+   const CSet<CRABEquippedEntity*, SEntityComparator>& setRABs =
+      m_pcRangeAndBearingMedium->GetRABsCommunicatingWith(*m_pcRangeAndBearingEquippedEntity);
+   const CVector3& cPosition = m_pcRangeAndBearingEquippedEntity->GetPosition();
+   CVector3 cVectorRobotToMessage;
+   CCI_RangeAndBearingSensor::SPacket sPacket;
+   for(CSet<CRABEquippedEntity*, SEntityComparator>::iterator it = setRABs.begin();
+       it != setRABs.end(); ++it) {
+      CRABEquippedEntity& cRABEntity = **it;
+      /* Drop the packets that a wall stands in the way of */
+      if(m_pcWalls->IsOccluded(CVector2(cPosition.GetX(), cPosition.GetY()),
+                               CVector2(cRABEntity.GetPosition().GetX(), cRABEntity.GetPosition().GetY()),
+                               std::min(cPosition.GetZ(), cRABEntity.GetPosition().GetZ()))) {
+         continue;
+      }
+      /* From here on, as in the default sensor */
+      if(m_pcRNG != NULL &&
+         m_fPacketDropProb > 0.0 &&
+         m_pcRNG->Bernoulli(m_fPacketDropProb)) {
+         continue;
+      }
+      if(m_bShowRays) {
+         m_pcControllableEntity->AddCheckedRay(false, CRay3(cRABEntity.GetPosition(), cPosition));
+      }
+      cVectorRobotToMessage = cRABEntity.GetPosition();
+      cVectorRobotToMessage -= cPosition;
+      if(m_pcRNG != NULL && m_fDistanceNoiseStdDev > 0.0) {
+         cVectorRobotToMessage += CVector3(m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
+                                           m_pcRNG->Uniform(INCLINATION_RANGE),
+                                           m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
+      }
+      /* Range and bearing in the frame of the robot, range in cm */
+      cVectorRobotToMessage.Rotate(m_pcRangeAndBearingEquippedEntity->GetOrientation().Inverse());
+      cVectorRobotToMessage.ToSphericalCoords(sPacket.Range,
+                                              sPacket.VerticalBearing,
+                                              sPacket.HorizontalBearing);
+      sPacket.Range *= 100.0;
+      sPacket.HorizontalBearing.SignedNormalize();
+      /* Elevation from the inclination */
+      sPacket.VerticalBearing.Negate();
+      sPacket.VerticalBearing += CRadians::PI_OVER_TWO;
+      sPacket.VerticalBearing.SignedNormalize();
+      sPacket.Data = cRABEntity.GetData();
+      m_tReadings.push_back(sPacket);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavRABSensor::Destroy() {
+   m_pcWalls.reset();
+   CRangeAndBearingDefaultSensor::Destroy();
+}
+
+/****************************************/
+/****************************************/
+
+std::shared_ptr<const CWallIndex> CNavRABSensor::GetWallIndex(Real f_cell_size) {
+   /*
+    * The index lives as long as some sensor holds it, so a new
+    * experiment in the same process builds its own. There is one per
+    * cell size, as robots may set different wall_cell_size values. The
+    * sensors may be updated by several threads at once, the first one
+    * builds it.
+    */
+   static std::mutex cMutex;
+   static std::map<Real, std::weak_ptr<const CWallIndex> > mapShared;
+   std::lock_guard<std::mutex> cLock(cMutex);
+   std::shared_ptr<const CWallIndex> pcWalls = mapShared[f_cell_size].lock();
+   if(pcWalls) {
+      return pcWalls;
+   }
+   /* Forget the indices of past experiments */
+   for(std::map<Real, std::weak_ptr<const CWallIndex> >::iterator it = mapShared.begin(); it != mapShared.end();) {
+      if(it->second.expired()) {
+         mapShared.erase(it++);
+      }
+      else {
+         ++it;
+      }
+   }
+   std::shared_ptr<CWallIndex> pcNew = std::make_shared<CWallIndex>();
+   /* ARGoS throws when the space has no entity of a type: an arena without boxes has no walls */
+   CSpace::TMapPerType tNoBoxes;
+   CSpace::TMapPerType* ptBoxes = &tNoBoxes;
+   try {
+      ptBoxes = &CSimulator::GetInstance().GetSpace().GetEntitiesByType("box");
+   }
+   catch(CARGoSException&) {}
+   size_t unMovable = 0;
+   for(CSpace::TMapPerType::iterator it = ptBoxes->begin(); it != ptBoxes->end(); ++it) {
+      CBoxEntity& cBox = *any_cast<CBoxEntity*>(it->second);
+      if(cBox.GetEmbodiedEntity().IsMovable()) {
+         ++unMovable;
+         continue;
+      }
+      /* The origin of a box is the center of its base */
+      const SAnchor& sOrigin = cBox.GetEmbodiedEntity().GetOriginAnchor();
+      CRadians cYaw, cPitch, cRoll;
+      sOrigin.Orientation.ToEulerAngles(cYaw, cPitch, cRoll);
+      pcNew->AddWall(CVector2(sOrigin.Position.GetX(), sOrigin.Position.GetY()),
+                     CVector2(cBox.GetSize().GetX(), cBox.GetSize().GetY()),
+                     cYaw,
+                     sOrigin.Position.GetZ() + cBox.GetSize().GetZ());
+   }
+   pcNew->Build(f_cell_size);
+   if(unMovable > 0) {
+      LOGERR << "[WARNING] nav_walls range and bearing sensor: "
+             << unMovable << " movable boxes don't occlude" << std::endl;
+   }
+   mapShared[f_cell_size] = pcNew;
+   return pcNew;
+}
+
+/****************************************/
+/****************************************/
+
+REGISTER_SENSOR(CNavRABSensor,
+                "range_and_bearing", "nav_walls",
+                "ARGoS swarm navigation",
+                "1.0",
+                "A range and bearing sensor that checks occlusions against a grid of the static walls.",
+                "Same as the default range and bearing sensor, except that packets are\n"
+                "dropped when a non-movable box stands between sender and receiver. The\n"
+                "boxes are rasterised once into a grid shared by all the robots, so set\n"
+                "check_occlusions=\"false\" in the rab medium. Robots and movable boxes\n"
+                "don't occlude. In addition to the parameters of the default sensor:\n"
+                "  wall_cell_size  side of the cells of the wall grid, in m (default 0.25)\n",
+                "Usable");
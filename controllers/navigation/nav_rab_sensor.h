@@ -0,0 +1,71 @@
+/*
+ * Range-and-bearing sensor that checks occlusions against a grid of the
+ * static walls.
+ *
+ * The default sensor gets from the RAB medium the robots in range and,
+ * with occlusion checks on, the medium ray-casts every pair of robots
+ * through the whole space on every tick. In the mazes the only
+ * obstacles worth testing are the walls, and they never move: this
+ * implementation rasterises the non-movable boxes of the arena once,
+ * into a CWallIndex shared by all the robots, and drops the packets
+ * whose line of sight crosses a wall. It is meant to be used with the
+ * occlusion checks of the medium turned off:
+ *
+ *    <sensors>
+ *       <range_and_bearing implementation="nav_walls" medium="rab" />
+ *    </sensors>
+ *    ...
+ *    <media>
+ *       <range_and_bearing id="rab" check_occlusions="false" />
+ *    </media>
+ *
+ * Unlike the ray casts of the medium, robots don't occlude each other
+ * and movable boxes are ignored. The noise and packet drop parameters
+ * are those of the default sensor, plus:
+ *
+ *    wall_cell_size  side of the cells of the wall grid, in m (0.25);
+ *                    robots with the same size share the grid
+ */
+
+#ifndef NAV_RAB_SENSOR_H
+#define NAV_RAB_SENSOR_H
+
+#include <controllers/nav_common/wall_index.h>
+
+#include <argos3/plugins/robots/generic/simulator/range_and_bearing_default_sensor.h>
+
+#include <memory>
+
+using namespace argos;
+
+class CNavRABSensor : public CRangeAndBearingDefaultSensor {
+
+public:
+
+   CNavRABSensor();
+
+   virtual ~CNavRABSensor() {}
+
+   virtual void Init(TConfigurationNode& t_tree);
+
+   virtual void Update();
+
+   virtual void Destroy();
+
+private:
+
+   /*
+    * Returns the wall index of the current space for a cell size,
+    * building it on the first call of any robot with that size. Empty
+    * if the arena has no boxes.
+    */
+   static std::shared_ptr<const CWallIndex> GetWallIndex(Real f_cell_size);
+
+private:
+
+   std::shared_ptr<const CWallIndex> m_pcWalls;
+   Real m_fCellSize;
+
+};
+
+#endif
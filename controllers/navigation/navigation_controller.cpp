@@ -0,0 +1,527 @@
+/* Include the controller definition */
+#include "navigation_controller.h"
+/* Function definitions for XML parsing */
+#include <argos3/core/utility/configuration/argos_configuration.h>
+/* 2D vector definition */
+#include <argos3/core/utility/math/vector2.h>
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+/* Simulation clock, for the trace */
+#include <argos3/core/simulator/simulator.h>
+#endif
+
+#include <cstdlib>
+
+/****************************************/
+/****************************************/
+
+/*
+ * Parses a target id parameter: a number from 0 to 255, or "auto" for the
+ * number the id of the robot ends with
+ */
+static UInt8 ParseTargetId(const std::string& str_parameter,
+                           const std::string& str_value,
+                           const std::string& str_robot_id) {
+   std::string strNumber = str_value;
+   if(str_value == "auto") {
+      size_t unStart = str_robot_id.find_last_not_of("0123456789") + 1;
+      strNumber = str_robot_id.substr(unStart);
+   }
+   char* pchEnd = NULL;
+   unsigned long unId = std::strtoul(strNumber.c_str(), &pchEnd, 10);
+   if(strNumber.empty() || *pchEnd != '\0' || unId > 255) {
+      THROW_ARGOSEXCEPTION("Robot \"" << str_robot_id << "\": " << str_parameter << " must be a number from 0 to 255 or \"auto\", got \"" << str_value << "\"");
+   }
+   return static_cast<UInt8>(unId);
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+CNavigationController<STRATEGY, CHANNEL, CODEC>::CNavigationController() :
+   m_pcWheels(NULL),
+   m_pcProximity(NULL),
+   m_cAlpha(10.0f),
+   m_fDelta(0.5f),
+   m_fWheelVelocity(2.5f),
+   m_cGoStraightAngleRange(-ToRadians(m_cAlpha),
+                           ToRadians(m_cAlpha)),
+   robot_role(ROLE_ASSISTANT),
+   comm_range(0.0f),
+   target_id(0),
+   rng(NULL),
+   record_buffer(NULL),
+   record_buffer_size(0),
+   payload_on_air(false) {}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+void CNavigationController<STRATEGY, CHANNEL, CODEC>::Init(TConfigurationNode& t_node) {
+   /*
+    * Get sensor/actuator handles
+    *
+    * The passed string (ex. "differential_steering") corresponds to the
+    * XML tag of the device whose handle we want to have. For a list of
+    * allowed values, type at the command prompt:
+    *
+    * $ argos3 -q actuators
+    *
+    * to have a list of all the possible actuators, or
+    *
+    * $ argos3 -q sensors
+    *
+    * to have a list of all the possible sensors.
+    *
+    * NOTE: ARGoS creates and initializes actuators and sensors
+    * internally, on the basis of the lists provided the configuration
+    * file at the <controllers><nw*_controller><actuators> and
+    * <controllers><nw*_controller><sensors> sections. If you forgot to
+    * list a device in the XML and then you request it here, an error
+    * occurs.
+    */
+   m_pcWheels    = GetActuator<CCI_DifferentialSteeringActuator>("differential_steering");
+   m_pcProximity = GetSensor  <CCI_FootBotProximitySensor      >("footbot_proximity"    );
+   rab_send      = GetActuator<CCI_RangeAndBearingActuator     >("range_and_bearing");
+   rab_get       = GetSensor  <CCI_RangeAndBearingSensor       >("range_and_bearing");
+   ledRing       = GetActuator<CCI_LEDsActuator                >("leds");
+   encoder       = GetSensor  <CCI_DifferentialSteeringSensor  >("differential_steering");
+   /*
+    * Parse the configuration file
+    *
+    * The user defines this part. Here, the algorithm accepts three
+    * parameters and it's nice to put them in the config file so we don't
+    * have to recompile if we want to try other settings.
+    */
+   GetNodeAttributeOrDefault(t_node, "alpha", m_cAlpha, m_cAlpha);
+   m_cGoStraightAngleRange.Set(-ToRadians(m_cAlpha), ToRadians(m_cAlpha));
+   GetNodeAttributeOrDefault(t_node, "delta", m_fDelta, m_fDelta);
+   GetNodeAttributeOrDefault(t_node, "velocity", m_fWheelVelocity, m_fWheelVelocity);
+   GetNodeAttributeOrDefault(t_node, "role", robot_role, robot_role);
+   GetNodeAttributeOrDefault(t_node, "comm_range", comm_range, comm_range);
+   std::string target_param = "0";
+   GetNodeAttributeOrDefault(t_node, "target_id", target_param, target_param);
+   target_id = ParseTargetId("target_id", target_param, GetId());
+   target_param = "0";
+   GetNodeAttributeOrDefault(t_node, "nav_target", target_param, target_param);
+   navTargetId = ParseTargetId("nav_target", target_param, GetId());
+
+   rng = CRandom::CreateRNG("argos");
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+   m_cStrategy.Init(rng, &m_cTrace);
+   m_cTrace.Clear();
+#else
+   m_cStrategy.Init(rng, NULL);
+#endif
+   m_cChannel.Init(t_node);
+   m_cScheduler.Init(t_node);
+
+   // Set unique colors
+   if (robot_role == ROLE_TARGET) {
+      ledRing->SetAllColors(CColor(0, 255, 0, 255));
+   } else if (robot_role == ROLE_NAVIGATOR) {
+      ledRing->SetAllColors(CColor(255, 0, 0, 255));
+   }
+
+   // Initialize outgoing messages
+   message_buffer = CByteArray(rab_send->GetSize());
+   record_buffer = m_cCodec.Init(message_buffer, record_buffer_size);
+   if (record_buffer_size < CNavCodec::RECORD_SIZE) {
+      THROW_ARGOSEXCEPTION("The range_and_bearing data size leaves " << record_buffer_size << " bytes for records, at least " << CNavCodec::RECORD_SIZE << " are needed");
+   }
+   payload_on_air = false;
+
+   // Initialize Nav Table
+   if (robot_role == ROLE_TARGET) {
+      navTable.Insert(target_id, {0, 0, 0});
+   }
+
+   bestNavHeading = 0;
+   bestNavDist = 0;
+   distanceStar = -1;
+   sequenceNumberStar = 0;
+   SetArrived(false);
+   ResetStats();
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+void CNavigationController<STRATEGY, CHANNEL, CODEC>::ControlStep() {
+   ResetTraffic();
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+   m_cTrace.SetTick(CSimulator::GetInstance().GetSpace().GetSimulationClock());
+#endif
+
+   /* Update local distance estimates */
+   {
+      NAV_PROFILE_SCOPE(m_cProfile, NAV_PHASE_ODOMETRY);
+      CCI_DifferentialSteeringSensor::SReading encoder_reading = encoder->GetReading();
+      Real distance_moved = (encoder_reading.CoveredDistanceLeftWheel + encoder_reading.CoveredDistanceRightWheel) / 2;
+      Real radians_rotated = (-encoder_reading.CoveredDistanceLeftWheel + encoder_reading.CoveredDistanceRightWheel) / encoder_reading.WheelAxisLength;
+      navTable.Move(distance_moved, radians_rotated);
+      m_sStats.PathLength += std::abs(distance_moved);
+      if (robot_role == ROLE_NAVIGATOR) {
+         bestNavDist -= distance_moved;
+         bestNavHeading -= radians_rotated;
+      }
+   }
+
+   bool time_to_send_update = true;
+   UInt32 messages_before = m_sStats.MessagesSent;
+
+   /* Process recieved messages */
+   const CCI_RangeAndBearingSensor::TReadings& readings = rab_get->GetReadings();
+   m_sTraffic.Received = readings.size();
+   for (size_t i = 0; i < readings.size(); ++i) {
+      const CCI_RangeAndBearingSensor::SPacket& reading = readings[i];
+
+      if (reading.Range > comm_range) {
+         // Only reached when the medium does not cut packets at comm_range (see nav_loop_functions.h)
+         ++m_sTraffic.OutOfRange;
+         NAV_TRACE_VERBOSE(m_cTrace, NAV_TRACE_PACKET_IGNORED, 0, reading.Range, reading.HorizontalBearing.GetValue());
+         continue; // Artificially limit the range of communication by ignoring comms from beyond that range
+      }
+
+      /* Get the records through the channel and the payload codec */
+      size_t payload_size = reading.Data.Size();
+      const UInt8* payload;
+      {
+         NAV_PROFILE_SCOPE(m_cProfile, NAV_PHASE_DECODE);
+         payload = m_cChannel.Receive(reading.Data.ToCArray(), payload_size);
+         if (payload != NULL) {
+            payload = m_cCodec.Decode(payload, payload_size); // NULL if corrupted beyond repair
+         }
+      }
+      if (payload == NULL) { // Lost on the way
+         ++m_sTraffic.Dropped;
+         NAV_TRACE_VERBOSE(m_cTrace, NAV_TRACE_PACKET_IGNORED, 1, reading.Range, reading.HorizontalBearing.GetValue());
+         continue;
+      }
+
+      NAV_TRACE_VERBOSE(m_cTrace, NAV_TRACE_PACKET, payload_size, reading.Range, reading.HorizontalBearing.GetValue());
+
+      CRABPacketView data(reading, payload, payload_size);
+      while (const UInt8* record = data.ReadRecord(CNavCodec::RECORD_SIZE)) {
+         UInt8 magic = CNavCodec::GetType(record);
+         if (magic == CNavCodec::TYPE_NAV_INFO) {
+            NAV_PROFILE_SCOPE(m_cProfile, NAV_PHASE_MERGE);
+            ++m_sTraffic.Records[MESSAGE_NAV_INFO];
+            CNavCodec::SNavInfo info;
+            CNavCodec::Decode(record, info);
+            ReceiveNavInfo(reading, info, time_to_send_update);
+         } else if (magic == CNavCodec::TYPE_DIRECTION_REQUEST) {
+            /* Request for directional information */
+            NAV_PROFILE_SCOPE(m_cProfile, NAV_PHASE_REQUESTS);
+            ++m_sTraffic.Records[MESSAGE_DIRECTION_REQUEST];
+            CRadians nav_heading = reading.HorizontalBearing + CRadians::PI;
+            CNavCodec::SDirectionRequest request;
+            CNavCodec::Decode(record, request);
+
+            // Nothing to answer with if we never heard of this target
+            NavTableEntry known_entry;
+            if (!navTable.Find(request.Target, known_entry)) continue;
+            time_to_send_update = false;
+
+            CNavCodec::SDirectionReply reply;
+            reply.Target = request.Target;
+            reply.Heading = (CRadians(known_entry.heading) - nav_heading).SignedNormalize().GetValue();
+            CNavCodec::EncodePayload(reply, record_buffer, record_buffer_size);
+            SendPayload(MESSAGE_DIRECTION_REPLY);
+            NAV_TRACE_DEBUG(m_cTrace, NAV_TRACE_DIRECTION_REPLY, reply.Target, reply.Heading, 0);
+         } else if (magic == CNavCodec::TYPE_DIRECTION_REPLY) {
+            /* Directional information */
+            NAV_PROFILE_SCOPE(m_cProfile, NAV_PHASE_REQUESTS);
+            ++m_sTraffic.Records[MESSAGE_DIRECTION_REPLY];
+            if (robot_role != ROLE_NAVIGATOR) continue;
+            CNavCodec::SDirectionReply reply;
+            CNavCodec::Decode(record, reply);
+            if (reply.Target != navTargetId) continue;
+            m_cStrategy.OnDirectionReply(reading.HorizontalBearing.GetValue(), reply.Heading);
+         } else {
+            break; // Padding, nothing else in this packet
+         }
+      }
+   }
+
+   /* Send Messages */
+   {
+      NAV_PROFILE_SCOPE(m_cProfile, NAV_PHASE_BROADCAST);
+      size_t slots = m_cScheduler.GetSlots(record_buffer_size, CNavCodec::RECORD_SIZE);
+      bool rotating = navTable.Size() > slots;
+      if (m_cScheduler.Tick(rotating) && time_to_send_update) {
+         // Only fresh broadcasts carry a new sequence number, so neighbours see news, not ticks
+         if (robot_role == ROLE_TARGET) { // Robot is a target
+            navTable.IncrementSequenceNumber(target_id);
+         }
+
+         // Send the entries the scheduler picks within the budget, the rest goes out on the next ticks
+         size_t count = (slots > 0) ? m_cScheduler.Select(navTable, slots, broadcast_entries) : 0;
+         if (count > 0) {
+            CNavCodec::EncodeTable(navTable, broadcast_entries, count, record_buffer, record_buffer_size);
+            SendPayload(MESSAGE_NAV_INFO);
+            m_cScheduler.OnSent(navTable, broadcast_entries, count);
+         }
+      }
+      if (m_sStats.MessagesSent == messages_before && payload_on_air) {
+         // The RAB keeps repeating the last payload: silence it rather than repeat stale records
+         rab_send->ClearData();
+         payload_on_air = false;
+      }
+      m_sTraffic.BytesOnAir = payload_on_air ? message_buffer.Size() : 0;
+   }
+
+   /* Assistants wander randomly, the navigator follows the nav points */
+   if (robot_role == ROLE_NAVIGATOR && HasArrived()) {
+      // Parked at the target: the others may still be on their way, keep relaying for them
+      m_pcWheels->SetLinearVelocity(0.0f, 0.0f);
+   } else if (robot_role == ROLE_ASSISTANT || robot_role == ROLE_NAVIGATOR) {
+      NAV_PROFILE_SCOPE(m_cProfile, NAV_PHASE_MOTION);
+      /* Get readings from proximity sensor */
+      const CCI_FootBotProximitySensor::TReadings& tProxReads = m_pcProximity->GetReadings();
+      /* Sum them together */
+      CVector2 cAccumulator;
+      for(size_t i = 0; i < tProxReads.size(); ++i) {
+         cAccumulator += CVector2(tProxReads[i].Value, tProxReads[i].Angle);
+      }
+      cAccumulator /= tProxReads.size();
+      /* If the angle of the vector is small enough and the closest obstacle
+       * is far enough, continue going straight, otherwise curve a little
+       */
+      CRadians cAngle = cAccumulator.Angle();
+      if(m_cGoStraightAngleRange.WithinMinBoundIncludedMaxBoundIncluded(cAngle) &&
+         cAccumulator.Length() < m_fDelta ) {
+         /* If Nav robot, do custom navigation logic
+            as long as we aren't coliding with anything */
+         if (robot_role == ROLE_NAVIGATOR) {
+            Navigate();
+         } else {
+            /* Go straight */
+            m_pcWheels->SetLinearVelocity(m_fWheelVelocity, m_fWheelVelocity);
+         }
+      }
+      else {
+         /* Turn, depending on the sign of the angle */
+         if(cAngle.GetValue() > 0.0f) {
+            m_pcWheels->SetLinearVelocity(m_fWheelVelocity, 0.0f);
+         }
+         else {
+            m_pcWheels->SetLinearVelocity(0.0f, m_fWheelVelocity);
+         }
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+void CNavigationController<STRATEGY, CHANNEL, CODEC>::ReceiveNavInfo(const CCI_RangeAndBearingSensor::SPacket& reading,
+                                                                     const CNavCodec::SNavInfo& info,
+                                                                     bool& time_to_send_update) {
+   /* Update navigation tables is new information is better */
+   float computed_distance = reading.Range + info.Distance;
+   NavTableEntry known_entry;
+   bool known = navTable.Find(info.Target, known_entry);
+   if (!known || (computed_distance < known_entry.distance && info.SequenceNumber >= known_entry.sequence_number) ) {
+      if (known) {
+         m_cScheduler.OnImprovement(known_entry.distance - computed_distance);
+      } else {
+         m_cScheduler.OnNewTarget();
+      }
+      navTable.Insert(info.Target, {
+         info.SequenceNumber,
+         computed_distance,
+         reading.HorizontalBearing.GetValue()
+      });
+      NAV_TRACE_DEBUG(m_cTrace, NAV_TRACE_TABLE_UPDATE, info.Target, computed_distance, reading.HorizontalBearing.GetValue());
+   }
+
+   /* Update navigation behavior is new information is better */
+   if (robot_role == ROLE_NAVIGATOR && info.Target == navTargetId) {
+      if (distanceStar == -1 || (info.Distance < distanceStar && info.SequenceNumber >= sequenceNumberStar)) {
+         distanceStar = info.Distance;
+         sequenceNumberStar = info.SequenceNumber;
+         bestNavDist = reading.Range;
+         bestNavHeading = reading.HorizontalBearing.GetValue() - 0.02; // Offset to avoid colision
+         ++m_sStats.Hops;
+         NAV_TRACE_INFO(m_cTrace, NAV_TRACE_HOP, info.Target, bestNavDist, bestNavHeading);
+
+         if (m_cStrategy.OnBetterNavInfo(reading.HorizontalBearing.GetValue())) {
+            /* Request directional info */
+            time_to_send_update = false;
+            CNavCodec::SDirectionRequest request = { info.Target };
+            CNavCodec::EncodePayload(request, record_buffer, record_buffer_size);
+            SendPayload(MESSAGE_DIRECTION_REQUEST);
+            NAV_TRACE_DEBUG(m_cTrace, NAV_TRACE_DIRECTION_REQUEST, info.Target, 0, 0);
+         }
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+void CNavigationController<STRATEGY, CHANNEL, CODEC>::Navigate() {
+   if (bestNavDist <= 0) {
+      // Arrived at last bot location, the strategy picks what to do next
+      if (!m_cStrategy.OnNavPointReached(bestNavHeading, bestNavDist, distanceStar)) {
+         m_pcWheels->SetLinearVelocity(0.0f, 0.0f);
+      }
+   } else if (bestNavDist <= 15 && distanceStar == 0) {
+      // Reached the target, the robot parks from now on
+      if (!HasArrived()) {
+         NAV_TRACE_INFO(m_cTrace, NAV_TRACE_ARRIVED, navTargetId, bestNavDist, bestNavHeading);
+      }
+      SetArrived(true);
+      m_pcWheels->SetLinearVelocity(0.0f, 0.0f);
+   } else if(m_cGoStraightAngleRange.WithinMinBoundIncludedMaxBoundIncluded(CRadians(bestNavHeading)) ) {
+      /* Go straight */
+      m_pcWheels->SetLinearVelocity(m_fWheelVelocity, m_fWheelVelocity);
+   } else {
+      // Turn towards best heading
+      if(bestNavHeading < 0.0f) {
+         m_pcWheels->SetLinearVelocity(m_fWheelVelocity, -m_fWheelVelocity);
+      }
+      else {
+         m_pcWheels->SetLinearVelocity(-m_fWheelVelocity, m_fWheelVelocity);
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+void CNavigationController<STRATEGY, CHANNEL, CODEC>::SendPayload(EMessage message) {
+   m_cCodec.Encode(message_buffer);
+   rab_send->SetData(message_buffer);
+   payload_on_air = true;
+   ++m_sStats.MessagesSent;
+   ++m_sTraffic.Sent[message];
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+void CNavigationController<STRATEGY, CHANNEL, CODEC>::SaveState(CByteArray& c_state) const {
+   c_state << static_cast<UInt32>(navTable.Size());
+   for (size_t i = 0; i < navTable.Size(); ++i) {
+      NavTableEntry entry = navTable.GetEntry(i);
+      c_state << navTable.GetTarget(i)
+              << entry.sequence_number
+              << static_cast<Real>(entry.distance)
+              << entry.heading;
+   }
+   c_state << sequenceNumberStar
+           << distanceStar
+           << static_cast<SInt32>(navTargetId)
+           << bestNavDist
+           << bestNavHeading
+           << static_cast<UInt8>(HasArrived())
+           << m_sStats.MessagesSent
+           << m_sStats.Hops
+           << m_sStats.PathLength;
+   m_cStrategy.SaveState(c_state);
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+void CNavigationController<STRATEGY, CHANNEL, CODEC>::LoadState(CByteArray& c_state) {
+   UInt32 entries;
+   c_state >> entries;
+   navTable.Clear();
+   for (UInt32 i = 0; i < entries; ++i) {
+      UInt8 target;
+      NavTableEntry entry;
+      Real distance;
+      c_state >> target
+              >> entry.sequence_number
+              >> distance
+              >> entry.heading;
+      entry.distance = distance;
+      navTable.Insert(target, entry);
+   }
+   SInt32 target_id;
+   UInt8 arrived;
+   c_state >> sequenceNumberStar
+           >> distanceStar
+           >> target_id
+           >> bestNavDist
+           >> bestNavHeading
+           >> arrived
+           >> m_sStats.MessagesSent
+           >> m_sStats.Hops
+           >> m_sStats.PathLength;
+   navTargetId = target_id;
+   SetArrived(arrived != 0);
+   m_cStrategy.LoadState(c_state);
+   // Nothing is on the air in the new run, tell the neighbours what we know right away
+   payload_on_air = false;
+   m_cScheduler.ForgetSent();
+   m_cScheduler.OnNewTarget();
+}
+
+/****************************************/
+/****************************************/
+
+template<class STRATEGY, class CHANNEL, class CODEC>
+size_t CNavigationController<STRATEGY, CHANNEL, CODEC>::GetStateSize() const {
+   // The nav table, the scheduler and the strategy are fixed-size members
+   size_t size = sizeof(*this) +
+                 message_buffer.Size() +
+                 m_cChannel.GetHeapSize() +
+                 m_cCodec.GetHeapSize();
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+   size += m_cTrace.GetCapacity() * sizeof(SNavTraceEvent);
+#endif
+   return size;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * The variants compared by the experiments.
+ *
+ * REGISTER_CONTROLLER builds its symbols from the class name, so each
+ * variant gets a typedef. The label is nw<s|r|d>, the payload codec if
+ * any (crc8, crc16, secded) and _noisy for the noisy channel, e.g.
+ * nwd_crc16_noisy_controller.
+ */
+#define REGISTER_NAVIGATION_CONTROLLER(STRATEGY, CHANNEL, CODEC, NAME)   \
+   typedef CNavigationController<STRATEGY, CHANNEL, CODEC> CNavigation_ ## NAME; \
+   REGISTER_CONTROLLER(CNavigation_ ## NAME, #NAME "_controller")
+
+#define REGISTER_NAVIGATION_CODECS(STRATEGY, CHANNEL, NAME, SUFFIX)                                   \
+   REGISTER_NAVIGATION_CONTROLLER(STRATEGY, CHANNEL, CPlainPayloadCodec, NAME ## SUFFIX)               \
+   REGISTER_NAVIGATION_CONTROLLER(STRATEGY, CHANNEL, CCrc8PayloadCodec, NAME ## _crc8 ## SUFFIX)       \
+   REGISTER_NAVIGATION_CONTROLLER(STRATEGY, CHANNEL, CCrc16PayloadCodec, NAME ## _crc16 ## SUFFIX)     \
+   REGISTER_NAVIGATION_CONTROLLER(STRATEGY, CHANNEL, CSecdedPayloadCodec, NAME ## _secded ## SUFFIX)
+
+/*
+ * This statement notifies ARGoS of the existence of the controller.
+ * It binds the class passed as first argument to the string passed as
+ * second argument.
+ * The string is then usable in the configuration file to refer to this
+ * controller.
+ * When ARGoS reads that string in the configuration file, it knows which
+ * controller class to instantiate.
+ * See also the configuration files for an example of how this is used.
+ */
+
+/* Navigation with Stopping */
+REGISTER_NAVIGATION_CODECS(CStopStrategy, CIdealChannel, nws, )
+REGISTER_NAVIGATION_CODECS(CStopStrategy, CNoiseChannel, nws, _noisy)
+/* Navigation with Random */
+REGISTER_NAVIGATION_CODECS(CRandomStrategy, CIdealChannel, nwr, )
+REGISTER_NAVIGATION_CODECS(CRandomStrategy, CNoiseChannel, nwr, _noisy)
+/* Navigation with Direction */
+REGISTER_NAVIGATION_CODECS(CDirectedStrategy, CIdealChannel, nwd, )
+REGISTER_NAVIGATION_CODECS(CDirectedStrategy, CNoiseChannel, nwd, _noisy)
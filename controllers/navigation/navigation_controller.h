@@ -0,0 +1,249 @@
+/*
+ * Cooperative navigation controller for the foot-bot.
+ *
+ * Every robot keeps a navigation table (see nav_table.h) with what it
+ * knows about the targets, and broadcasts it over range-and-bearing.
+ * Assistants wander around, avoiding obstacles; the target stays put and
+ * refreshes its own entry; the navigator follows the chain of nav points
+ * towards the target. The table goes out on every tick by default, or,
+ * with a longer keepalive, only when it has news or a keepalive is due
+ * (see nav_broadcast.h).
+ *
+ * There may be many targets, told apart by their id (0 to 255):
+ *
+ *    target_id   id a target advertises (default 0); "auto" takes the
+ *                number the robot id ends with, so that the targets of a
+ *                <distribute> block get distinct ids
+ *    nav_target  id of the target the navigator heads to (default 0);
+ *                "auto" as for target_id, so that navigators nav0, nav1...
+ *                head to target0, target1...
+ *
+ * Several navigators can share a run. A navigator that reached its target
+ * parks there, and keeps relaying nav info for the others.
+ *
+ * When the table no longer fits in the payload, the scheduler picks the
+ * entries of every broadcast.
+ *
+ * The controller is a template over three policies, so that each
+ * variant is compiled on its own and its control step has no run-time
+ * branches on the configuration:
+ *
+ *    STRATEGY  what the navigator does at its last nav point (nav_strategy.h)
+ *    CHANNEL   what happens to payloads on the way in (nav_channel.h)
+ *    CODEC     how payloads carry the records (nav_payload_codec.h)
+ *
+ * The variants are registered in navigation_controller.cpp and are used
+ * with the XML files in experiments/.
+ */
+
+#ifndef NAVIGATION_CONTROLLER_H
+#define NAVIGATION_CONTROLLER_H
+
+/*
+ * Include some necessary headers.
+ */
+
+#include <argos3/core/utility/math/rng.h>
+/* Definition of the CNavController class. */
+#include <controllers/nav_common/nav_controller.h>
+/* Definition of the navigation table */
+#include <controllers/nav_common/nav_table.h>
+/* Definition of the zero-copy packet view */
+#include <controllers/nav_common/rab_packet_view.h>
+/* Definition of the message wire format */
+#include <controllers/nav_common/nav_codec.h>
+/* Definition of the broadcast scheduler */
+#include <controllers/nav_common/nav_broadcast.h>
+/* Definition of the policies */
+#include <controllers/nav_common/nav_strategy.h>
+#include <controllers/nav_common/nav_channel.h>
+#include <controllers/nav_common/nav_payload_codec.h>
+/* Definition of the differential steering actuator */
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_sensor.h>
+/* Definition of the foot-bot proximity sensor */
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_proximity_sensor.h>
+
+/* Definition of the IrRB sensors */
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_actuator.h>
+
+/* Definition of the LEDs */
+#include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
+
+/*
+ * All the ARGoS stuff in the 'argos' namespace.
+ * With this statement, you save typing argos:: every time.
+ */
+using namespace argos;
+
+/*
+ * A controller is simply an implementation of the CCI_Controller class.
+ * Navigation controllers derive from CNavController, which exposes
+ * their state to the loop functions.
+ */
+template<class STRATEGY, class CHANNEL, class CODEC>
+class CNavigationController : public CNavController {
+
+public:
+
+   /* Class constructor. */
+   CNavigationController();
+
+   /* Class destructor. */
+   virtual ~CNavigationController() {}
+
+   /*
+    * This function initializes the controller.
+    * The 't_node' variable points to the <parameters> section in the XML
+    * file in the <controllers><nw*_controller> section.
+    */
+   virtual void Init(TConfigurationNode& t_node);
+
+   /*
+    * This function is called once every time step.
+    * The length of the time step is set in the XML file.
+    */
+   virtual void ControlStep();
+
+   /*
+    * This function resets the controller to its state right after the
+    * Init().
+    * It is called when you press the reset button in the GUI.
+    */
+   virtual void Reset() {}
+
+   /*
+    * Called to cleanup what done by Init() when the experiment finishes.
+    */
+   virtual void Destroy() {}
+
+   /* Returns the role of the robot */
+   virtual int GetRole() const {
+      return robot_role;
+   }
+
+   virtual Real GetCommRange() const {
+      return comm_range;
+   }
+
+   virtual UInt8 GetTargetId() const {
+      return (robot_role == ROLE_NAVIGATOR) ? navTargetId : target_id;
+   }
+
+   virtual bool KnowsTarget(UInt8 un_target) const {
+      return navTable.Contains(un_target);
+   }
+
+   virtual bool GetTableDistance(UInt8 un_target,
+                                 Real& f_distance) const {
+      NavTableEntry entry;
+      if (!navTable.Find(un_target, entry)) return false;
+      f_distance = entry.distance;
+      return true;
+   }
+
+   virtual SNavState GetNavState() const {
+      SNavState state;
+      state.BestNavDist = bestNavDist;
+      state.BestNavHeading = bestNavHeading;
+      state.DistanceStar = distanceStar;
+      return state;
+   }
+
+   virtual void SaveState(CByteArray& c_state) const;
+
+   virtual void LoadState(CByteArray& c_state);
+
+   virtual size_t GetStateSize() const;
+
+private:
+
+   /* Merges a nav info record received from reading */
+   void ReceiveNavInfo(const CCI_RangeAndBearingSensor::SPacket& reading,
+                       const CNavCodec::SNavInfo& info,
+                       bool& time_to_send_update);
+
+   /* Moves the navigator towards its current nav point */
+   void Navigate();
+
+   /* Encodes the records written to record_buffer and sends them */
+   void SendPayload(EMessage message);
+
+private:
+
+   /* Pointer to the differential steering actuator */
+   CCI_DifferentialSteeringActuator* m_pcWheels;
+   CCI_DifferentialSteeringSensor* encoder;
+   /* Pointer to the foot-bot proximity sensor */
+   CCI_FootBotProximitySensor* m_pcProximity;
+   /* Pointer to the foot-bot LEDs */
+   CCI_LEDsActuator* ledRing;
+   /* Pointer to the foot-bot RAB communication */
+   CCI_RangeAndBearingActuator* rab_send;
+   CCI_RangeAndBearingSensor* rab_get;
+
+   /*
+    * The following variables are used as parameters for the
+    * algorithm. You can set their value in the <parameters> section
+    * of the XML configuration file, under the
+    * <controllers><nw*_controller> section.
+    */
+
+   /* Maximum tolerance for the angle between
+    * the robot heading direction and
+    * the closest obstacle detected. */
+   CDegrees m_cAlpha;
+   /* Maximum tolerance for the proximity reading between
+    * the robot and the closest obstacle.
+    * The proximity reading is 0 when nothing is detected
+    * and grows exponentially to 1 when the obstacle is
+    * touching the robot.
+    */
+   Real m_fDelta;
+   /* Wheel speed. */
+   Real m_fWheelVelocity;
+   /* Angle tolerance range to go straight.
+    * It is set to [-alpha,alpha]. */
+   CRange<CRadians> m_cGoStraightAngleRange;
+
+   int robot_role;
+   /* Role of the robot
+    * 0 is normal swarm behavior
+    * 1 is target
+    * 2 is the one navigating */
+   Real comm_range;
+   /* Id advertised by a target */
+   UInt8 target_id;
+
+   /* Policies */
+   STRATEGY m_cStrategy;
+   CHANNEL m_cChannel;
+   CODEC m_cCodec;
+
+   /* Decides on which ticks the nav table is broadcast */
+   CBroadcastScheduler m_cScheduler;
+
+   CRandom::CRNG* rng;
+
+   UInt32 sequenceNumberStar;
+   Real distanceStar;
+   int navTargetId;
+   Real bestNavDist;
+   Real bestNavHeading;
+
+   CNavTable navTable;
+
+   /* Outgoing payload, sized to the RAB data_size and reused every tick */
+   CByteArray message_buffer;
+   /* Where the records of the outgoing payload are written, and their room */
+   UInt8* record_buffer;
+   size_t record_buffer_size;
+   /* Nav table entries picked for the next broadcast */
+   size_t broadcast_entries[CNavTable::CAPACITY];
+   /* Whether the RAB is still repeating the last payload we set */
+   bool payload_on_air;
+
+};
+
+#endif
@@ -0,0 +1,379 @@
+/*
+ * Measures how fast the simulator steps a swarm of a given size, and how
+ * much memory the swarm takes.
+ *
+ * Usage:
+ *    nav_throughput -c <experiment.argos> -q <robots> [-d <density>] [-t <ticks>]
+ *                   [-w <ticks>] [-r <rounds>] [-s <seed>] [-e <name>] [-o <output.csv>]
+ *
+ *    -c   experiment the controllers, loop functions, physics engines and
+ *         media are taken from; its arena is replaced
+ *    -q   number of assistants
+ *    -d   assistants per square meter (default 1); the arena grows with
+ *         the swarm to keep it
+ *    -t   ticks to time (default 200)
+ *    -w   ticks to run before timing, so that the nav tables fill up
+ *         (default 50)
+ *    -r   rounds of control steps to time (default 10, see below)
+ *    -s   random seed (default 1)
+ *    -e   name of the experiment in the output (default the file name of
+ *         the experiment, without extension)
+ *    -o   CSV file the results are appended to (default throughput.csv)
+ *
+ * The arena is a square walled box with the target and the navigator in
+ * opposite corners, the controllers with role 1 and 2 of the experiment,
+ * and the assistants spread uniformly over it with the controller with
+ * role 0. The experiment runs headless and writes none of its files.
+ *
+ * The results are one CSV row:
+ *
+ *    experiment           name of the experiment
+ *    robots               number of foot-bots, target and navigator included
+ *    arena_side           side of the box, in m
+ *    ticks                ticks timed
+ *    ticks_per_second     simulated ticks per second of wall-clock time
+ *    us_per_tick          wall-clock time per tick, in microseconds
+ *    ns_per_control_step  wall-clock time of one ControlStep, in nanoseconds
+ *    peak_rss_kb          peak resident set size of the process, in kB
+ *    rss_per_robot        growth of the resident set size from before the
+ *                         simulator is initialized to the end of the run,
+ *                         per robot, in bytes; it includes the fixed cost of
+ *                         the simulator, so it falls with the swarm size
+ *    controller_bytes     mean memory held by a controller, in bytes (see
+ *                         CNavController::GetStateSize())
+ *
+ * The time of a tick covers the whole step: sensors, control steps,
+ * actuators, physics and media. ARGoS does not time the control steps
+ * alone, so after the timed ticks every controller is stepped again,
+ * -r times in a row, on the readings of the last tick; the mean of those
+ * calls is the time per ControlStep. The nav tables are full by then, so
+ * it is the steady-state cost, but the state the repeated steps leave is
+ * not meaningful and the run ends there.
+ *
+ * Run one size per process: the peak RSS is that of the whole process.
+ * benchmarks/throughput.sh runs the usual sizes and compares them with a
+ * baseline.
+ */
+
+#include <loop_functions/nav_loop_functions/nav_loop_functions.h>
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+static void PrintUsage(const char* pch_program) {
+   std::cerr << "Usage: " << pch_program
+             << " -c <experiment.argos> -q <robots> [-d density] [-t ticks] [-w ticks]"
+             << " [-r rounds] [-s seed] [-e name] [-o output.csv]"
+             << std::endl;
+}
+
+/****************************************/
+/****************************************/
+
+/* Returns the resident set size of the process, in bytes */
+static size_t GetResidentSize() {
+   size_t unPages = 0, unResident = 0;
+   std::FILE* pcStatm = std::fopen("/proc/self/statm", "r");
+   if(pcStatm != NULL) {
+      if(std::fscanf(pcStatm, "%zu %zu", &unPages, &unResident) != 2) {
+         unResident = 0;
+      }
+      std::fclose(pcStatm);
+   }
+   return unResident * ::sysconf(_SC_PAGESIZE);
+}
+
+/****************************************/
+/****************************************/
+
+/* Formats a position or size attribute */
+static std::string FormatVector(Real f_x,
+                                Real f_y,
+                                Real f_z) {
+   std::ostringstream cStream;
+   cStream << f_x << "," << f_y << "," << f_z;
+   return cStream.str();
+}
+
+/****************************************/
+/****************************************/
+
+/* Returns the id of the controller configuration with the given role */
+static std::string FindController(TConfigurationNode& t_root,
+                                  int n_role) {
+   TConfigurationNode tControllers = GetNode(t_root, "controllers");
+   TConfigurationNodeIterator itController;
+   for(itController = itController.begin(&tControllers);
+       itController != itController.end();
+       ++itController) {
+      int nRole = -1;
+      if(NodeExists(*itController, "params")) {
+         TConfigurationNode tParams = GetNode(*itController, "params");
+         GetNodeAttributeOrDefault(tParams, "role", nRole, nRole);
+      }
+      if(nRole == n_role) {
+         std::string strId;
+         GetNodeAttribute(*itController, "id", strId);
+         return strId;
+      }
+   }
+   THROW_ARGOSEXCEPTION("The experiment has no controller with role " << n_role);
+}
+
+/****************************************/
+/****************************************/
+
+static void AddWall(TConfigurationNode& t_arena,
+                    const std::string& str_id,
+                    const std::string& str_size,
+                    const std::string& str_position) {
+   TConfigurationNode tBody("body");
+   SetNodeAttribute(tBody, "position", str_position);
+   SetNodeAttribute(tBody, "orientation", std::string("0,0,0"));
+   TConfigurationNode tBox("box");
+   SetNodeAttribute(tBox, "id", str_id);
+   SetNodeAttribute(tBox, "size", str_size);
+   SetNodeAttribute(tBox, "movable", std::string("false"));
+   tBox.InsertEndChild(tBody);
+   t_arena.InsertEndChild(tBox);
+}
+
+/****************************************/
+/****************************************/
+
+static void AddFootBot(TConfigurationNode& t_arena,
+                       const std::string& str_id,
+                       const std::string& str_position,
+                       const std::string& str_config) {
+   TConfigurationNode tBody("body");
+   SetNodeAttribute(tBody, "position", str_position);
+   SetNodeAttribute(tBody, "orientation", std::string("0,0,0"));
+   TConfigurationNode tController("controller");
+   SetNodeAttribute(tController, "config", str_config);
+   TConfigurationNode tFootBot("foot-bot");
+   SetNodeAttribute(tFootBot, "id", str_id);
+   tFootBot.InsertEndChild(tBody);
+   tFootBot.InsertEndChild(tController);
+   t_arena.InsertEndChild(tFootBot);
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Replaces the arena with a walled square box of side f_side, the target
+ * and the navigator in opposite corners and un_robots assistants spread
+ * over it.
+ */
+static void BuildArena(TConfigurationNode& t_root,
+                       UInt32 un_robots,
+                       Real f_side) {
+   std::string strAssistant = FindController(t_root, CNavController::ROLE_ASSISTANT);
+   std::string strTarget = FindController(t_root, CNavController::ROLE_TARGET);
+   std::string strNavigator = FindController(t_root, CNavController::ROLE_NAVIGATOR);
+   TConfigurationNode tArena = GetNode(t_root, "arena");
+   tArena.Clear();
+   SetNodeAttribute(tArena, "size", FormatVector(f_side + 1.0, f_side + 1.0, 1.0));
+   SetNodeAttribute(tArena, "center", std::string("0,0,0.5"));
+   Real fHalf = f_side / 2.0;
+   AddWall(tArena, "wall_north", FormatVector(f_side, 0.1, 0.5), FormatVector(0.0, fHalf, 0.0));
+   AddWall(tArena, "wall_south", FormatVector(f_side, 0.1, 0.5), FormatVector(0.0, -fHalf, 0.0));
+   AddWall(tArena, "wall_east", FormatVector(0.1, f_side, 0.5), FormatVector(fHalf, 0.0, 0.0));
+   AddWall(tArena, "wall_west", FormatVector(0.1, f_side, 0.5), FormatVector(-fHalf, 0.0, 0.0));
+   /* Keep the robots clear of the walls */
+   Real fInner = fHalf - 0.2;
+   AddFootBot(tArena, "fb_target", FormatVector(fInner, -fInner, 0.0), strTarget);
+   AddFootBot(tArena, "fb_nav", FormatVector(-fInner, fInner, 0.0), strNavigator);
+   TConfigurationNode tController("controller");
+   SetNodeAttribute(tController, "config", strAssistant);
+   TConfigurationNode tFootBot("foot-bot");
+   SetNodeAttribute(tFootBot, "id", std::string("fb"));
+   tFootBot.InsertEndChild(tController);
+   TConfigurationNode tEntity("entity");
+   SetNodeAttribute(tEntity, "quantity", un_robots);
+   SetNodeAttribute(tEntity, "max_trials", 100);
+   tEntity.InsertEndChild(tFootBot);
+   TConfigurationNode tPosition("position");
+   SetNodeAttribute(tPosition, "method", std::string("uniform"));
+   SetNodeAttribute(tPosition, "min", FormatVector(-fInner, -fInner, 0.0));
+   SetNodeAttribute(tPosition, "max", FormatVector(fInner, fInner, 0.0));
+   TConfigurationNode tOrientation("orientation");
+   SetNodeAttribute(tOrientation, "method", std::string("gaussian"));
+   SetNodeAttribute(tOrientation, "mean", std::string("0,0,0"));
+   SetNodeAttribute(tOrientation, "std_dev", std::string("360,0,0"));
+   TConfigurationNode tDistribute("distribute");
+   tDistribute.InsertEndChild(tPosition);
+   tDistribute.InsertEndChild(tOrientation);
+   tDistribute.InsertEndChild(tEntity);
+   tArena.InsertEndChild(tDistribute);
+}
+
+/****************************************/
+/****************************************/
+
+/* Runs the experiment headless, without any of its output files and budgets */
+static void PrepareExperiment(TConfigurationNode& t_root,
+                              UInt32 un_seed) {
+   TConfigurationNode tFramework = GetNode(t_root, "framework");
+   TConfigurationNode tExperiment = GetNode(tFramework, "experiment");
+   SetNodeAttribute(tExperiment, "random_seed", un_seed);
+   SetNodeAttribute(tExperiment, "length", 0);
+   if(!NodeExists(t_root, "loop_functions")) {
+      THROW_ARGOSEXCEPTION("The experiment has no loop functions; it must use the nav_loop_functions");
+   }
+   TConfigurationNode tLoopFunctions = GetNode(t_root, "loop_functions");
+   const char* ppchFiles[] = { "output", "profile", "trace", "traffic", "propagation", "navigators", "trajectory" };
+   for(size_t i = 0; i < sizeof(ppchFiles) / sizeof(ppchFiles[0]); ++i) {
+      SetNodeAttribute(tLoopFunctions, ppchFiles[i], std::string());
+   }
+   SetNodeAttribute(tLoopFunctions, "max_ticks", 0);
+   SetNodeAttribute(tLoopFunctions, "max_wall_time", 0);
+   if(NodeExists(t_root, "visualization")) {
+      TConfigurationNode tVisualization = GetNode(t_root, "visualization");
+      tVisualization.Clear();
+   }
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   std::string strExperiment;
+   std::string strName;
+   std::string strOutput = "throughput.csv";
+   UInt32 unRobots = 0;
+   Real fDensity = 1.0;
+   UInt32 unTicks = 200;
+   UInt32 unWarmUp = 50;
+   UInt32 unRounds = 10;
+   UInt32 unSeed = 1;
+   int nOption;
+   while((nOption = ::getopt(argc, argv, "c:q:d:t:w:r:s:e:o:")) != -1) {
+      switch(nOption) {
+         case 'c': strExperiment = optarg; break;
+         case 'q': unRobots = std::strtoul(optarg, NULL, 10); break;
+         case 'd': fDensity = std::strtod(optarg, NULL); break;
+         case 't': unTicks = std::strtoul(optarg, NULL, 10); break;
+         case 'w': unWarmUp = std::strtoul(optarg, NULL, 10); break;
+         case 'r': unRounds = std::strtoul(optarg, NULL, 10); break;
+         case 's': unSeed = std::strtoul(optarg, NULL, 10); break;
+         case 'e': strName = optarg; break;
+         case 'o': strOutput = optarg; break;
+         default:
+            PrintUsage(argv[0]);
+            return 1;
+      }
+   }
+   if(strExperiment.empty() || unRobots == 0 || fDensity <= 0.0 || unTicks == 0) {
+      PrintUsage(argv[0]);
+      return 1;
+   }
+   if(strName.empty()) {
+      strName = strExperiment.substr(strExperiment.find_last_of('/') + 1);
+      strName = strName.substr(0, strName.find_last_of('.'));
+   }
+   Real fSide = std::sqrt(unRobots / fDensity);
+   try {
+      size_t unResidentBefore = GetResidentSize();
+      /* The document must outlive the simulation, as ARGoS keeps references into it */
+      ticpp::Document cDocument;
+      cDocument.LoadFile(strExperiment);
+      TConfigurationNode tRoot = *cDocument.FirstChildElement();
+      BuildArena(tRoot, unRobots, fSide);
+      PrepareExperiment(tRoot, unSeed);
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      cSimulator.GetConfigurationRoot() = tRoot;
+      cSimulator.Init();
+      CNavLoopFunctions* pcLoopFunctions =
+         dynamic_cast<CNavLoopFunctions*>(&cSimulator.GetLoopFunctions());
+      if(pcLoopFunctions == NULL) {
+         THROW_ARGOSEXCEPTION("The experiment must use the nav_loop_functions");
+      }
+      const std::vector<CNavController*>& vecControllers = pcLoopFunctions->GetControllers();
+      for(UInt32 i = 0; i < unWarmUp; ++i) {
+         cSimulator.UpdateSpace();
+      }
+      /* Whole ticks */
+      std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+      for(UInt32 i = 0; i < unTicks; ++i) {
+         cSimulator.UpdateSpace();
+      }
+      Real fTickTime = std::chrono::duration<Real>(std::chrono::steady_clock::now() - tStart).count();
+      /* Control steps alone, on the readings of the last tick */
+      tStart = std::chrono::steady_clock::now();
+      for(UInt32 i = 0; i < unRounds; ++i) {
+         for(size_t j = 0; j < vecControllers.size(); ++j) {
+            vecControllers[j]->ControlStep();
+         }
+      }
+      Real fStepTime = std::chrono::duration<Real>(std::chrono::steady_clock::now() - tStart).count();
+      size_t unStateSize = 0;
+      for(size_t i = 0; i < vecControllers.size(); ++i) {
+         unStateSize += vecControllers[i]->GetStateSize();
+      }
+      size_t unResidentAfter = GetResidentSize();
+      struct rusage sUsage;
+      ::getrusage(RUSAGE_SELF, &sUsage);
+      size_t unControllers = vecControllers.size();
+      cSimulator.Destroy();
+      /* Write the header only when starting a new file */
+      bool bNewFile;
+      {
+         std::ifstream cExisting(strOutput.c_str());
+         bNewFile = !cExisting.good() || cExisting.peek() == std::ifstream::traits_type::eof();
+      }
+      std::ofstream cOutput(strOutput.c_str(), std::ios::app);
+      if(!cOutput) {
+         std::cerr << "Cannot write results to \"" << strOutput << "\"" << std::endl;
+         return 1;
+      }
+      if(bNewFile) {
+         cOutput << "experiment,robots,arena_side,ticks,ticks_per_second,us_per_tick,"
+                 << "ns_per_control_step,peak_rss_kb,rss_per_robot,controller_bytes" << std::endl;
+      }
+      std::ostringstream cRow;
+      cRow << strName << ","
+           << unControllers << ","
+           << fSide << ","
+           << unTicks << ","
+           << unTicks / fTickTime << ","
+           << 1e6 * fTickTime / unTicks << ","
+           << ((unControllers > 0 && unRounds > 0) ? 1e9 * fStepTime / (unRounds * unControllers) : 0.0) << ","
+           /* ru_maxrss is in kB on Linux */
+           << sUsage.ru_maxrss << ","
+           << ((unResidentAfter > unResidentBefore && unControllers > 0) ? (unResidentAfter - unResidentBefore) / unControllers : 0) << ","
+           << ((unControllers > 0) ? unStateSize / unControllers : 0);
+      cOutput << cRow.str() << std::endl;
+      std::cout << cRow.str() << std::endl;
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   catch(std::exception& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   return 0;
+}
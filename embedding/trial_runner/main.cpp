@@ -0,0 +1,164 @@
+/*
+ * Runs many trials of one or more experiments in parallel.
+ *
+ * Usage:
+ *    trial_runner -c <experiment.argos> [-c <experiment.argos> ...]
+ *                 [-x <sweep.xml> ...] [-n <trials>] [-j <workers>] [-s <base seed>] [-o <output.csv>]
+ *                 [-w <width> [-m mean|median] [-N <max trials>]] [-b <cpu seconds>] [-W <ticks>]
+ *                 [-T <ticks>] [-L <seconds>] [-k <survival.csv>]
+ *
+ *    -c   experiment file; can be given several times
+ *    -x   sweep specification (see sweep.h), every point of which is run
+ *         as an experiment; can be given several times
+ *    -n   number of trials per experiment (default 10); with -w, the
+ *         number of trials to run before checking convergence
+ *    -j   number of parallel workers (default 0 = one per hardware thread)
+ *    -s   base seed from which the per-trial seeds are derived (default 1)
+ *    -o   CSV file receiving one row per trial (default log.csv)
+ *    -w   keep adding trials to an experiment until the 95% confidence
+ *         interval of its time to target is narrower than this fraction
+ *         of the estimate (e.g. 0.1)
+ *    -m   statistic the interval is computed for (default median)
+ *    -N   maximum number of trials per experiment with -w (default 1000)
+ *    -b   stop launching trials once they used this much CPU time, in
+ *         seconds
+ *    -W   simulate the first ticks of every experiment once, and start
+ *         all its trials from a snapshot of that state (ticks in the
+ *         results still count from 0)
+ *    -T   stop every trial after this many ticks and record it as
+ *         censored (overrides max_ticks of the nav_loop_functions)
+ *    -L   stop every trial after this many seconds of wall-clock time
+ *         and record it as censored (overrides max_wall_time)
+ *    -k   CSV file receiving the Kaplan-Meier curve of the time to
+ *         target of every experiment
+ *
+ * With -w, -b, -T or -L, a report of the trials run per experiment and
+ * of the intervals reached is printed at the end, with the restricted
+ * mean and Kaplan-Meier median of the experiments that had censored
+ * trials. Censored trials leave the mean undefined, so -m mean keeps
+ * adding trials to them up to -N; the median interval holds as long as
+ * the median is within the budget.
+ *
+ * This replaces the serial loop in batch_run.sh.
+ */
+
+#include "trial_runner.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+/****************************************/
+/****************************************/
+
+static void PrintUsage(const char* pch_program) {
+   std::cerr << "Usage: " << pch_program
+             << " -c <experiment.argos> [-c ...] [-x sweep.xml ...] [-n trials] [-j workers] [-s seed] [-o output.csv]"
+             << " [-w width [-m mean|median] [-N max trials]] [-b cpu seconds] [-W ticks]"
+             << " [-T ticks] [-L seconds] [-k survival.csv]"
+             << std::endl;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   std::vector<std::string> vecExperiments;
+   std::vector<std::string> vecSweeps;
+   std::string strOutput = "log.csv";
+   UInt32 unTrials = 10;
+   UInt32 unWorkers = 0;
+   UInt32 unSeed = 1;
+   UInt32 unWarmUp = 0;
+   CTrialRunner::SStoppingRule sRule;
+   sRule.Width = 0.0;
+   sRule.Statistic = CTrialStatistics::STAT_MEDIAN;
+   sRule.MaxTrials = 1000;
+   sRule.CpuBudget = 0.0;
+   CTrialRunner::STrialBudget sBudget;
+   sBudget.Ticks = 0;
+   sBudget.WallTime = 0.0;
+   std::string strSurvival;
+   std::string strStatistic;
+   int nOption;
+   while((nOption = ::getopt(argc, argv, "c:x:n:j:s:o:w:m:N:b:W:T:L:k:")) != -1) {
+      switch(nOption) {
+         case 'c': vecExperiments.push_back(optarg); break;
+         case 'x': vecSweeps.push_back(optarg); break;
+         case 'n': unTrials = std::strtoul(optarg, NULL, 10); break;
+         case 'j': unWorkers = std::strtoul(optarg, NULL, 10); break;
+         case 's': unSeed = std::strtoul(optarg, NULL, 10); break;
+         case 'o': strOutput = optarg; break;
+         case 'w': sRule.Width = std::strtod(optarg, NULL); break;
+         case 'm': strStatistic = optarg; break;
+         case 'N': sRule.MaxTrials = std::strtoul(optarg, NULL, 10); break;
+         case 'b': sRule.CpuBudget = std::strtod(optarg, NULL); break;
+         case 'W': unWarmUp = std::strtoul(optarg, NULL, 10); break;
+         case 'T': sBudget.Ticks = std::strtoul(optarg, NULL, 10); break;
+         case 'L': sBudget.WallTime = std::strtod(optarg, NULL); break;
+         case 'k': strSurvival = optarg; break;
+         default:
+            PrintUsage(argv[0]);
+            return 1;
+      }
+   }
+   if(vecExperiments.empty() && vecSweeps.empty()) {
+      PrintUsage(argv[0]);
+      return 1;
+   }
+   if(strStatistic == "mean") {
+      sRule.Statistic = CTrialStatistics::STAT_MEAN;
+   }
+   else if(!strStatistic.empty() && strStatistic != "median") {
+      PrintUsage(argv[0]);
+      return 1;
+   }
+   try {
+      CTrialRunner cRunner(unWorkers);
+      cRunner.SetStoppingRule(sRule);
+      cRunner.SetWarmUp(unWarmUp);
+      cRunner.SetTrialBudget(sBudget);
+      for(size_t i = 0; i < vecExperiments.size(); ++i) {
+         cRunner.AddTrials(vecExperiments[i], unTrials, unSeed);
+      }
+      for(size_t i = 0; i < vecSweeps.size(); ++i) {
+         cRunner.AddSweep(vecSweeps[i], unTrials, unSeed);
+      }
+      std::ofstream cOutput(strOutput.c_str());
+      if(!cOutput) {
+         std::cerr << "Cannot open \"" << strOutput << "\" for writing" << std::endl;
+         return 1;
+      }
+      if(sRule.Width > 0.0) {
+         std::cerr << "Running " << cRunner.GetNumExperiments() << " experiments on "
+                   << cRunner.GetNumWorkers() << " workers until their confidence intervals are within "
+                   << sRule.Width << " of the estimate" << std::endl;
+      }
+      else {
+         std::cerr << "Running " << unTrials * cRunner.GetNumExperiments() << " trials on "
+                   << cRunner.GetNumWorkers() << " workers" << std::endl;
+      }
+      cRunner.Run(cOutput);
+      if(sRule.Width > 0.0 || sRule.CpuBudget > 0.0 ||
+         sBudget.Ticks > 0 || sBudget.WallTime > 0.0) {
+         cRunner.WriteReport(std::cerr);
+      }
+      if(!strSurvival.empty()) {
+         std::ofstream cSurvival(strSurvival.c_str());
+         if(!cSurvival) {
+            std::cerr << "Cannot open \"" << strSurvival << "\" for writing" << std::endl;
+            return 1;
+         }
+         cRunner.WriteSurvival(cSurvival);
+      }
+   }
+   catch(CARGoSException& ex) {
+      std::cerr << ex.what() << std::endl;
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,304 @@
+#include "sweep.h"
+
+#include <sstream>
+
+/****************************************/
+/****************************************/
+
+/* Splits a whitespace-separated list of values */
+static std::vector<std::string> SplitValues(const std::string& str_values) {
+   std::vector<std::string> vecValues;
+   std::istringstream cStream(str_values);
+   std::string strValue;
+   while(cStream >> strValue) {
+      vecValues.push_back(strValue);
+   }
+   return vecValues;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Finds the <entity> of a <distribute> of the arena that creates
+ * foot-bots. Returns false if there is none.
+ */
+static bool FindFootBotEntity(TConfigurationNode& t_arena,
+                              TConfigurationNode& t_distribute,
+                              TConfigurationNode& t_entity) {
+   TConfigurationNodeIterator itDistribute("distribute");
+   for(itDistribute = itDistribute.begin(&t_arena);
+       itDistribute != itDistribute.end();
+       ++itDistribute) {
+      if(!NodeExists(*itDistribute, "entity")) continue;
+      TConfigurationNode tEntity = GetNode(*itDistribute, "entity");
+      if(NodeExists(tEntity, "foot-bot")) {
+         t_distribute = *itDistribute;
+         t_entity = tEntity;
+         return true;
+      }
+   }
+   return false;
+}
+
+/****************************************/
+/****************************************/
+
+CSweep::CSweep(const std::string& str_spec) :
+   m_unPoints(1) {
+   /* The name of the sweep is the file name, without directory and extension */
+   m_strName = str_spec.substr(str_spec.find_last_of('/') + 1);
+   m_strName = m_strName.substr(0, m_strName.find_last_of('.'));
+   TConfigurationNode& tSpec = LoadFile(str_spec);
+   /* The base gets its own document, as the points modify it */
+   std::string strBase;
+   GetNodeAttribute(tSpec, "base", strBase);
+   try {
+      m_lstDocuments.emplace_back();
+      m_lstDocuments.back().LoadFile(strBase);
+      m_tBase = *m_lstDocuments.back().FirstChildElement();
+   }
+   catch(ticpp::Exception& ex) {
+      THROW_ARGOSEXCEPTION("Cannot load \"" << strBase << "\": " << ex.what());
+   }
+   /* Index of the layout dimension, if any */
+   int nLayouts = -1;
+   TConfigurationNodeIterator itDimension;
+   for(itDimension = itDimension.begin(&tSpec);
+       itDimension != itDimension.end();
+       ++itDimension) {
+      const std::string& strType = itDimension->Value();
+      if(strType == "layout") {
+         /* All the layouts form one dimension, where they first appear */
+         std::string strName, strArena;
+         GetNodeAttribute(*itDimension, "name", strName);
+         GetNodeAttribute(*itDimension, "arena", strArena);
+         SLayout sLayout;
+         sLayout.Arena = GetNode(LoadFile(strArena), "arena");
+         GetNodeAttributeOrDefault(*itDimension, "min", sLayout.Min, std::string());
+         GetNodeAttributeOrDefault(*itDimension, "max", sLayout.Max, std::string());
+         TConfigurationNode tDistribute, tEntity;
+         if(sLayout.Min.empty() != sLayout.Max.empty() ||
+            (sLayout.Min.empty() && !FindFootBotEntity(sLayout.Arena, tDistribute, tEntity))) {
+            THROW_ARGOSEXCEPTION("Layout \"" << strName << "\" of sweep \"" << str_spec << "\" needs both min and max, as " << strArena << " distributes no foot-bots");
+         }
+         if(!m_mapLayouts.insert(std::make_pair(strName, sLayout)).second) {
+            THROW_ARGOSEXCEPTION("Layout \"" << strName << "\" appears twice in sweep \"" << str_spec << "\"");
+         }
+         if(nLayouts < 0) {
+            nLayouts = m_vecDimensions.size();
+            m_vecDimensions.push_back(SDimension());
+            m_vecDimensions.back().Type = DIMENSION_LAYOUT;
+         }
+         m_vecDimensions[nLayouts].Values.push_back(strName);
+         continue;
+      }
+      SDimension sDimension;
+      if(strType == "quantity") {
+         sDimension.Type = DIMENSION_QUANTITY;
+      }
+      else if(strType == "navigation_type") {
+         sDimension.Type = DIMENSION_NAVIGATION_TYPE;
+      }
+      else if(strType == "parameter") {
+         sDimension.Type = DIMENSION_PARAMETER;
+         GetNodeAttribute(*itDimension, "name", sDimension.Name);
+      }
+      else {
+         THROW_ARGOSEXCEPTION("Unknown sweep dimension <" << strType << "> in \"" << str_spec << "\"");
+      }
+      std::string strValues;
+      GetNodeAttribute(*itDimension, "values", strValues);
+      sDimension.Values = SplitValues(strValues);
+      if(sDimension.Values.empty()) {
+         THROW_ARGOSEXCEPTION("Sweep dimension <" << strType << "> in \"" << str_spec << "\" has no values");
+      }
+      m_vecDimensions.push_back(sDimension);
+   }
+   for(size_t i = 0; i < m_vecDimensions.size(); ++i) {
+      m_unPoints *= m_vecDimensions[i].Values.size();
+   }
+}
+
+/****************************************/
+/****************************************/
+
+std::string CSweep::GetPointName(size_t un_point) const {
+   std::vector<size_t> vecIndices = Decode(un_point);
+   std::ostringstream cName;
+   cName << m_strName << "[";
+   for(size_t i = 0; i < m_vecDimensions.size(); ++i) {
+      const SDimension& sDimension = m_vecDimensions[i];
+      if(i > 0) cName << " ";
+      switch(sDimension.Type) {
+         case DIMENSION_LAYOUT:          cName << "layout="; break;
+         case DIMENSION_QUANTITY:        cName << "quantity="; break;
+         case DIMENSION_NAVIGATION_TYPE: cName << "navigation_type="; break;
+         case DIMENSION_PARAMETER:       cName << sDimension.Name << "="; break;
+      }
+      cName << sDimension.Values[vecIndices[i]];
+   }
+   cName << "]";
+   return cName.str();
+}
+
+/****************************************/
+/****************************************/
+
+TConfigurationNode& CSweep::Expand(size_t un_point) {
+   std::vector<size_t> vecIndices = Decode(un_point);
+   /* The layout first, the other dimensions may apply to its arena */
+   for(size_t i = 0; i < m_vecDimensions.size(); ++i) {
+      if(m_vecDimensions[i].Type == DIMENSION_LAYOUT) {
+         ApplyLayout(m_tBase, m_mapLayouts[m_vecDimensions[i].Values[vecIndices[i]]]);
+      }
+   }
+   for(size_t i = 0; i < m_vecDimensions.size(); ++i) {
+      const SDimension& sDimension = m_vecDimensions[i];
+      const std::string& strValue = sDimension.Values[vecIndices[i]];
+      switch(sDimension.Type) {
+         case DIMENSION_LAYOUT:          break;
+         case DIMENSION_QUANTITY:        ApplyQuantity(m_tBase, strValue); break;
+         case DIMENSION_NAVIGATION_TYPE: ApplyNavigationType(m_tBase, strValue); break;
+         case DIMENSION_PARAMETER:       ApplyParameter(m_tBase, sDimension.Name, strValue); break;
+      }
+   }
+   return m_tBase;
+}
+
+/****************************************/
+/****************************************/
+
+TConfigurationNode& CSweep::LoadFile(const std::string& str_path) {
+   std::map<std::string, TConfigurationNode>::iterator itRoot = m_mapRoots.find(str_path);
+   if(itRoot != m_mapRoots.end()) {
+      return itRoot->second;
+   }
+   try {
+      m_lstDocuments.emplace_back();
+      m_lstDocuments.back().LoadFile(str_path);
+      return m_mapRoots[str_path] = *m_lstDocuments.back().FirstChildElement();
+   }
+   catch(ticpp::Exception& ex) {
+      THROW_ARGOSEXCEPTION("Cannot load \"" << str_path << "\": " << ex.what());
+   }
+}
+
+/****************************************/
+/****************************************/
+
+std::vector<size_t> CSweep::Decode(size_t un_point) const {
+   /* The last dimension varies fastest */
+   std::vector<size_t> vecIndices(m_vecDimensions.size());
+   for(size_t i = m_vecDimensions.size(); i > 0; --i) {
+      size_t unValues = m_vecDimensions[i - 1].Values.size();
+      vecIndices[i - 1] = un_point % unValues;
+      un_point /= unValues;
+   }
+   return vecIndices;
+}
+
+/****************************************/
+/****************************************/
+
+void CSweep::ApplyLayout(TConfigurationNode& t_root,
+                         SLayout& s_layout) {
+   TConfigurationNode tArena = GetNode(t_root, "arena");
+   t_root.ReplaceChild(&tArena, s_layout.Arena);
+   if(s_layout.Min.empty()) return;
+   /* Spread the assistants over the layout, creating their distribution if needed */
+   tArena = GetNode(t_root, "arena");
+   TConfigurationNode tDistribute, tEntity;
+   if(!FindFootBotEntity(tArena, tDistribute, tEntity)) {
+      /* The assistants run the controller configuration with role 0 */
+      std::string strConfig = "fdc";
+      TConfigurationNode tControllers = GetNode(t_root, "controllers");
+      TConfigurationNodeIterator itController;
+      for(itController = itController.begin(&tControllers);
+          itController != itController.end();
+          ++itController) {
+         int nRole = -1;
+         if(NodeExists(*itController, "params")) {
+            TConfigurationNode tParams = GetNode(*itController, "params");
+            GetNodeAttributeOrDefault(tParams, "role", nRole, nRole);
+         }
+         if(nRole == 0) {
+            GetNodeAttribute(*itController, "id", strConfig);
+            break;
+         }
+      }
+      TConfigurationNode tController("controller");
+      SetNodeAttribute(tController, "config", strConfig);
+      TConfigurationNode tFootBot("foot-bot");
+      SetNodeAttribute(tFootBot, "id", std::string("fb"));
+      tFootBot.InsertEndChild(tController);
+      TConfigurationNode tNewEntity("entity");
+      SetNodeAttribute(tNewEntity, "quantity", 0);
+      SetNodeAttribute(tNewEntity, "max_trials", 100);
+      tNewEntity.InsertEndChild(tFootBot);
+      TConfigurationNode tPosition("position");
+      SetNodeAttribute(tPosition, "method", std::string("uniform"));
+      TConfigurationNode tOrientation("orientation");
+      SetNodeAttribute(tOrientation, "method", std::string("gaussian"));
+      SetNodeAttribute(tOrientation, "mean", std::string("0,0,0"));
+      SetNodeAttribute(tOrientation, "std_dev", std::string("360,0,0"));
+      TConfigurationNode tNewDistribute("distribute");
+      tNewDistribute.InsertEndChild(tPosition);
+      tNewDistribute.InsertEndChild(tOrientation);
+      tNewDistribute.InsertEndChild(tNewEntity);
+      tArena.InsertEndChild(tNewDistribute);
+      FindFootBotEntity(tArena, tDistribute, tEntity);
+   }
+   TConfigurationNode tPosition = GetNode(tDistribute, "position");
+   SetNodeAttribute(tPosition, "method", std::string("uniform"));
+   SetNodeAttribute(tPosition, "min", s_layout.Min);
+   SetNodeAttribute(tPosition, "max", s_layout.Max);
+}
+
+/****************************************/
+/****************************************/
+
+void CSweep::ApplyQuantity(TConfigurationNode& t_root,
+                           const std::string& str_quantity) {
+   TConfigurationNode tArena = GetNode(t_root, "arena");
+   TConfigurationNode tDistribute, tEntity;
+   if(!FindFootBotEntity(tArena, tDistribute, tEntity)) {
+      THROW_ARGOSEXCEPTION("Sweep \"" << m_strName << "\" sets the quantity of foot-bots, but the arena distributes none; give its layout min and max");
+   }
+   SetNodeAttribute(tEntity, "quantity", str_quantity);
+}
+
+/****************************************/
+/****************************************/
+
+void CSweep::ApplyNavigationType(TConfigurationNode& t_root,
+                                 const std::string& str_type) {
+   TConfigurationNode tControllers = GetNode(t_root, "controllers");
+   TConfigurationNodeIterator itController;
+   for(itController = itController.begin(&tControllers);
+       itController != itController.end();
+       ++itController) {
+      /* nw<s|r|d>[_codec][_noisy]_controller */
+      std::string strLabel = itController->Value();
+      size_t unPrefix = strLabel.find('_');
+      if(unPrefix == std::string::npos || strLabel.compare(0, 2, "nw") != 0) continue;
+      itController->SetValue(str_type + strLabel.substr(unPrefix));
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CSweep::ApplyParameter(TConfigurationNode& t_root,
+                            const std::string& str_name,
+                            const std::string& str_value) {
+   TConfigurationNode tControllers = GetNode(t_root, "controllers");
+   TConfigurationNodeIterator itController;
+   for(itController = itController.begin(&tControllers);
+       itController != itController.end();
+       ++itController) {
+      if(!NodeExists(*itController, "params")) continue;
+      TConfigurationNode tParams = GetNode(*itController, "params");
+      SetNodeAttribute(tParams, str_name, str_value);
+   }
+}
@@ -0,0 +1,127 @@
+/*
+ * Parameter sweep over a base experiment.
+ *
+ * A sweep specification expands one .argos file into the cartesian
+ * product of the values of its dimensions, instead of keeping a
+ * hand-edited copy of the file for every point:
+ *
+ *    <sweep base="experiments/maze_4Ls.argos">
+ *      <layout name="2Ls" arena="experiments/maze_2Ls.argos" min="-4,-4,0" max="4,4,0" />
+ *      <layout name="4Ls" arena="experiments/maze_4Ls.argos" min="-4,-4,0" max="4,4,0" />
+ *      <quantity values="10 20 40" />
+ *      <navigation_type values="nwr nwd" />
+ *      <parameter name="comm_range" values="150 300" />
+ *      <parameter name="velocity" values="5 10" />
+ *    </sweep>
+ *
+ *    layout           replaces the <arena> of the base with the one of
+ *                     another experiment file; min and max bound the
+ *                     area the assistants are distributed in, and are
+ *                     required if that arena does not distribute any
+ *    quantity         number of assistant foot-bots
+ *    navigation_type  strategy prefix of the controller labels (nws, nwr
+ *                     or nwd), e.g. nwd_crc16_controller becomes
+ *                     nwr_crc16_controller
+ *    parameter        an attribute of the <params> of every controller
+ *
+ * Dimensions can be omitted or repeated (one <parameter> per attribute);
+ * the order of the specification is the order of the points.
+ *
+ * Every XML file is parsed once, when the sweep is loaded. A point is
+ * applied in place to the parsed base, so it is meant to be expanded in
+ * the trial runner's worker processes, which work on their own copy of
+ * the parent memory: no file is written and nothing is parsed again.
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CSweep {
+
+public:
+
+   /* Loads a sweep specification and the files it refers to */
+   CSweep(const std::string& str_spec);
+
+   inline size_t GetNumPoints() const {
+      return m_unPoints;
+   }
+
+   /* Name of a point, e.g. "mazes[layout=2Ls quantity=10 navigation_type=nwr]" */
+   std::string GetPointName(size_t un_point) const;
+
+   /*
+    * Applies a point to the parsed base experiment and returns its root.
+    * Every point sets all the swept values, so points can be applied one
+    * after the other to the same tree.
+    */
+   TConfigurationNode& Expand(size_t un_point);
+
+private:
+
+   enum EDimension {
+      DIMENSION_LAYOUT,
+      DIMENSION_QUANTITY,
+      DIMENSION_NAVIGATION_TYPE,
+      DIMENSION_PARAMETER
+   };
+
+   struct SDimension {
+      EDimension Type;
+      /* Attribute name, for parameters */
+      std::string Name;
+      /* Values, or layout names */
+      std::vector<std::string> Values;
+   };
+
+   struct SLayout {
+      /* Arena of the layout file */
+      TConfigurationNode Arena;
+      /* Bounds of the assistant distribution, empty to keep those of the arena */
+      std::string Min;
+      std::string Max;
+   };
+
+   /* Returns the root of a parsed, read-only file, parsing it on first use */
+   TConfigurationNode& LoadFile(const std::string& str_path);
+
+   /* Value index of every dimension for a point */
+   std::vector<size_t> Decode(size_t un_point) const;
+
+   void ApplyLayout(TConfigurationNode& t_root,
+                    SLayout& s_layout);
+
+   void ApplyQuantity(TConfigurationNode& t_root,
+                      const std::string& str_quantity);
+
+   void ApplyNavigationType(TConfigurationNode& t_root,
+                            const std::string& str_type);
+
+   void ApplyParameter(TConfigurationNode& t_root,
+                       const std::string& str_name,
+                       const std::string& str_value);
+
+private:
+
+   std::string m_strName;
+   /* Parsed files, by path; a list keeps the documents in place */
+   std::list<ticpp::Document> m_lstDocuments;
+   std::map<std::string, TConfigurationNode> m_mapRoots;
+   TConfigurationNode m_tBase;
+   std::vector<SDimension> m_vecDimensions;
+   /* Layouts, by name */
+   std::map<std::string, SLayout> m_mapLayouts;
+   size_t m_unPoints;
+
+};
+
+#endif
@@ -0,0 +1,649 @@
+#include "trial_runner.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <loop_functions/nav_loop_functions/nav_loop_functions.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Trial index of the warm-up seed and of the workers running a warm-up */
+static const UInt32 WARMUP_TRIAL = 0xFFFFFFFF;
+
+/****************************************/
+/****************************************/
+
+CTrialRunner::CTrialRunner(UInt32 un_workers) :
+   m_unWorkers(un_workers),
+   m_unWarmUpTicks(0),
+   m_fCpuTime(0.0) {
+   if(m_unWorkers == 0) {
+      m_unWorkers = std::thread::hardware_concurrency();
+      if(m_unWorkers == 0) m_unWorkers = 1;
+   }
+   m_sRule.Width = 0.0;
+   m_sRule.Statistic = CTrialStatistics::STAT_MEAN;
+   m_sRule.MaxTrials = 0;
+   m_sRule.CpuBudget = 0.0;
+   m_sBudget.Ticks = 0;
+   m_sBudget.WallTime = 0.0;
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::AddTrials(const std::string& str_experiment,
+                             UInt32 un_count,
+                             UInt32 un_base_seed) {
+   SExperiment sExperiment;
+   sExperiment.Path = str_experiment;
+   sExperiment.BaseSeed = un_base_seed;
+   sExperiment.Trials = un_count;
+   sExperiment.Launched = 0;
+   sExperiment.Running = 0;
+   sExperiment.Sweep = NULL;
+   sExperiment.Point = 0;
+   sExperiment.WarmUp = WARMUP_NONE;
+   m_vecExperiments.push_back(sExperiment);
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::AddSweep(const std::string& str_spec,
+                            UInt32 un_count,
+                            UInt32 un_base_seed) {
+   m_lstSweeps.emplace_back(str_spec);
+   CSweep& cSweep = m_lstSweeps.back();
+   for(size_t i = 0; i < cSweep.GetNumPoints(); ++i) {
+      AddTrials(cSweep.GetPointName(i), un_count, un_base_seed);
+      m_vecExperiments.back().Sweep = &cSweep;
+      m_vecExperiments.back().Point = i;
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::SetStoppingRule(const SStoppingRule& s_rule) {
+   if(s_rule.Width < 0.0 || s_rule.CpuBudget < 0.0) {
+      THROW_ARGOSEXCEPTION("Stopping rule needs width >= 0 and budget >= 0, got width=" << s_rule.Width << ", budget=" << s_rule.CpuBudget);
+   }
+   m_sRule = s_rule;
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::SetTrialBudget(const STrialBudget& s_budget) {
+   if(s_budget.WallTime < 0.0) {
+      THROW_ARGOSEXCEPTION("Trial budget needs a wall time >= 0, got " << s_budget.WallTime);
+   }
+   m_sBudget = s_budget;
+}
+
+/****************************************/
+/****************************************/
+
+UInt32 CTrialRunner::DeriveSeed(UInt32 un_base_seed, UInt32 un_trial) {
+   /* SplitMix64 finalizer, so that neighbouring trials get unrelated seeds */
+   UInt64 unZ = (static_cast<UInt64>(un_base_seed) << 32) | un_trial;
+   unZ += 0x9E3779B97F4A7C15ULL;
+   unZ = (unZ ^ (unZ >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   unZ = (unZ ^ (unZ >> 27)) * 0x94D049BB133111EBULL;
+   unZ ^= unZ >> 31;
+   UInt32 unSeed = static_cast<UInt32>(unZ);
+   /* ARGoS interprets a seed of 0 as 'seed from the clock' */
+   return (unSeed == 0) ? 1 : unSeed;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Inserts _<seed> before the extension of the file name in an attribute
+ * of the loop functions, if the name is not empty
+ */
+static void AddSeedSuffix(TConfigurationNode& t_loop_functions,
+                          const std::string& str_attribute,
+                          const std::string& str_default,
+                          UInt32 un_seed) {
+   std::string strFile = str_default;
+   GetNodeAttributeOrDefault(t_loop_functions, str_attribute, strFile, strFile);
+   if(strFile.empty()) return;
+   std::ostringstream cSuffix;
+   cSuffix << "_" << un_seed;
+   size_t unDot = strFile.find_last_of('.');
+   size_t unSlash = strFile.find_last_of('/');
+   if(unDot == std::string::npos || (unSlash != std::string::npos && unDot < unSlash)) {
+      unDot = strFile.size();
+   }
+   strFile.insert(unDot, cSuffix.str());
+   SetNodeAttribute(t_loop_functions, str_attribute, strFile);
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::LoadExperiment(TConfigurationNode& t_root,
+                                  UInt32 un_seed,
+                                  const STrialBudget& s_budget) {
+   /* Override the seed hard-coded in the experiment file */
+   TConfigurationNode tFramework = GetNode(t_root, "framework");
+   TConfigurationNode tExperiment = GetNode(tFramework, "experiment");
+   SetNodeAttribute(tExperiment, "random_seed", un_seed);
+   /* Results are collected by the runner, not appended to the summary file */
+   if(NodeExists(t_root, "loop_functions")) {
+      TConfigurationNode tLoopFunctions = GetNode(t_root, "loop_functions");
+      SetNodeAttribute(tLoopFunctions, "output", std::string());
+      SetNodeAttribute(tLoopFunctions, "profile", std::string());
+      /* Every trial records its traffic, propagation, navigators, trajectory and trace to its own files, named after its seed */
+      AddSeedSuffix(tLoopFunctions, "traffic", "", un_seed);
+      AddSeedSuffix(tLoopFunctions, "trajectory", "", un_seed);
+      AddSeedSuffix(tLoopFunctions, "propagation", "", un_seed);
+      AddSeedSuffix(tLoopFunctions, "navigators", "", un_seed);
+      AddSeedSuffix(tLoopFunctions, "trace", "nav_trace.bin", un_seed);
+      if(s_budget.Ticks > 0) {
+         SetNodeAttribute(tLoopFunctions, "max_ticks", s_budget.Ticks);
+      }
+      if(s_budget.WallTime > 0.0) {
+         SetNodeAttribute(tLoopFunctions, "max_wall_time", s_budget.WallTime);
+      }
+   }
+   /* Trials always run headless */
+   if(NodeExists(t_root, "visualization")) {
+      TConfigurationNode tVisualization = GetNode(t_root, "visualization");
+      tVisualization.Clear();
+   }
+   /* Initialize the simulator from the modified tree */
+   CSimulator& cSimulator = CSimulator::GetInstance();
+   cSimulator.GetConfigurationRoot() = t_root;
+   cSimulator.Init();
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::LoadTrial(SExperiment& s_experiment,
+                             UInt32 un_seed,
+                             const STrialBudget& s_budget,
+                             ticpp::Document& c_document) {
+   TConfigurationNode tRoot;
+   if(s_experiment.Sweep != NULL) {
+      /* This process has its own copy of the parsed sweep, expand the point in place */
+      tRoot = s_experiment.Sweep->Expand(s_experiment.Point);
+   }
+   else {
+      c_document.LoadFile(s_experiment.Path);
+      tRoot = *c_document.FirstChildElement();
+   }
+   LoadExperiment(tRoot, un_seed, s_budget);
+}
+
+/****************************************/
+/****************************************/
+
+CTrialRunner::SResult CTrialRunner::RunTrial(const STrial& s_trial,
+                                             UInt32 un_trial,
+                                             SExperiment& s_experiment,
+                                             const STrialBudget& s_budget) {
+   SResult sResult;
+   sResult.Trial = un_trial;
+   sResult.Ticks = 0;
+   sResult.Found = false;
+   sResult.Censored = false;
+   sResult.PathLength = 0.0;
+   sResult.Messages = 0;
+   sResult.Hops = 0;
+   sResult.WallTime = 0.0;
+   sResult.CpuTime = 0.0;
+   sResult.Ok = false;
+   std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+   try {
+      /* The document must outlive the simulation, as ARGoS keeps references into it */
+      ticpp::Document cDocument;
+      LoadTrial(s_experiment, s_trial.Seed, s_budget, cDocument);
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      CNavLoopFunctions* pcLoopFunctions =
+         dynamic_cast<CNavLoopFunctions*>(&cSimulator.GetLoopFunctions());
+      if(!s_experiment.Snapshot.Empty()) {
+         /* Branch from the end of the warm-up; the RNGs keep the trial seed */
+         if(pcLoopFunctions == NULL) {
+            THROW_ARGOSEXCEPTION("Warm-up snapshots must use the nav_loop_functions");
+         }
+         CByteArray cSnapshot(s_experiment.Snapshot);
+         pcLoopFunctions->Restore(cSnapshot);
+      }
+      cSimulator.Execute();
+      sResult.Ticks = cSimulator.GetSpace().GetSimulationClock();
+      if(pcLoopFunctions != NULL) {
+         const CNavLoopFunctions::SSummary& sSummary = pcLoopFunctions->GetSummary();
+         sResult.Found = sSummary.Found;
+         sResult.Censored = sSummary.Censored;
+         sResult.PathLength = sSummary.PathLength;
+         sResult.Messages = sSummary.Messages;
+         sResult.Hops = sSummary.Hops;
+      }
+      cSimulator.Destroy();
+      sResult.Ok = true;
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << "[trial " << s_trial.Index << ", seed " << s_trial.Seed << "] "
+             << ex.what() << std::endl;
+   }
+   catch(std::exception& ex) {
+      LOGERR << "[trial " << s_trial.Index << ", seed " << s_trial.Seed << "] "
+             << ex.what() << std::endl;
+   }
+   LOGERR.Flush();
+   sResult.WallTime = std::chrono::duration<Real>(std::chrono::steady_clock::now() - tStart).count();
+   return sResult;
+}
+
+/****************************************/
+/****************************************/
+
+bool CTrialRunner::RunWarmUp(SExperiment& s_experiment,
+                             UInt32 un_ticks,
+                             const STrialBudget& s_budget,
+                             int n_file) {
+   UInt32 unSeed = DeriveSeed(s_experiment.BaseSeed, WARMUP_TRIAL);
+   try {
+      ticpp::Document cDocument;
+      LoadTrial(s_experiment, unSeed, s_budget, cDocument);
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      CNavLoopFunctions* pcLoopFunctions =
+         dynamic_cast<CNavLoopFunctions*>(&cSimulator.GetLoopFunctions());
+      if(pcLoopFunctions == NULL) {
+         THROW_ARGOSEXCEPTION("Warm-up snapshots need the nav_loop_functions");
+      }
+      while(cSimulator.GetSpace().GetSimulationClock() < un_ticks &&
+            !cSimulator.IsExperimentFinished()) {
+         cSimulator.UpdateSpace();
+      }
+      if(cSimulator.IsExperimentFinished()) {
+         THROW_ARGOSEXCEPTION("The experiment finished within the " << un_ticks << " warm-up ticks");
+      }
+      CByteArray cSnapshot;
+      pcLoopFunctions->Snapshot(cSnapshot);
+      const UInt8* punData = cSnapshot.ToCArray();
+      size_t unLeft = cSnapshot.Size();
+      while(unLeft > 0) {
+         ssize_t nWritten = ::write(n_file, punData, unLeft);
+         if(nWritten < 0) {
+            if(errno == EINTR) continue;
+            THROW_ARGOSEXCEPTION("Cannot write the warm-up snapshot: " << ::strerror(errno));
+         }
+         punData += nWritten;
+         unLeft -= nWritten;
+      }
+      cSimulator.Destroy();
+      return true;
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << "[warm-up of " << s_experiment.Path << ", seed " << unSeed << "] "
+             << ex.what() << std::endl;
+   }
+   catch(std::exception& ex) {
+      LOGERR << "[warm-up of " << s_experiment.Path << ", seed " << unSeed << "] "
+             << ex.what() << std::endl;
+   }
+   LOGERR.Flush();
+   return false;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Creates the file a warm-up worker writes its snapshot to. The file is
+ * unlinked right away, it lives as long as the descriptor.
+ */
+static int CreateSnapshotFile() {
+   const char* pchDir = ::getenv("TMPDIR");
+   std::string strPath = std::string((pchDir != NULL && *pchDir != 0) ? pchDir : "/tmp") + "/trial_runner_XXXXXX";
+   std::vector<char> vecPath(strPath.begin(), strPath.end());
+   vecPath.push_back(0);
+   int nFile = ::mkstemp(&vecPath[0]);
+   if(nFile < 0) {
+      THROW_ARGOSEXCEPTION("Cannot create a snapshot file in \"" << strPath << "\": " << ::strerror(errno));
+   }
+   ::unlink(&vecPath[0]);
+   return nFile;
+}
+
+/****************************************/
+/****************************************/
+
+/* Reads back the snapshot a warm-up worker wrote to n_file */
+static bool ReadSnapshotFile(int n_file,
+                             CByteArray& c_snapshot) {
+   off_t nSize = ::lseek(n_file, 0, SEEK_END);
+   if(nSize <= 0 || ::lseek(n_file, 0, SEEK_SET) != 0) return false;
+   std::vector<UInt8> vecData(nSize);
+   size_t unRead = 0;
+   while(unRead < vecData.size()) {
+      ssize_t nRead = ::read(n_file, &vecData[unRead], vecData.size() - unRead);
+      if(nRead < 0 && errno == EINTR) continue;
+      if(nRead <= 0) return false;
+      unRead += nRead;
+   }
+   c_snapshot = CByteArray(&vecData[0], vecData.size());
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::Run(std::ostream& c_out) {
+   /*
+    * A running worker: the trial it executes, or WARMUP_TRIAL, and the
+    * pipe it reports on, or the file it writes the snapshot to
+    */
+   struct SWorker {
+      UInt32 Trial;
+      UInt32 Experiment;
+      int Pipe;
+   };
+   std::map<pid_t, SWorker> mapWorkers;
+   for(size_t i = 0; i < m_vecExperiments.size(); ++i) {
+      m_vecExperiments[i].WarmUp = (m_unWarmUpTicks > 0) ? WARMUP_PENDING : WARMUP_NONE;
+      m_vecExperiments[i].Snapshot.Clear();
+   }
+   c_out << "experiment,trial,seed,ticks,found,censored,path_length,messages,hops,wall_time,cpu_time,status" << std::endl;
+   UInt32 unExperiment;
+   while(true) {
+      /* Fill the free worker slots */
+      while(mapWorkers.size() < m_unWorkers && NextExperiment(unExperiment)) {
+         SExperiment& sExperiment = m_vecExperiments[unExperiment];
+         if(sExperiment.WarmUp == WARMUP_PENDING) {
+            /* The trials of the experiment wait for its snapshot */
+            int nFile = CreateSnapshotFile();
+            c_out.flush();
+            pid_t tPid = ::fork();
+            if(tPid < 0) {
+               THROW_ARGOSEXCEPTION("Cannot fork warm-up worker: " << ::strerror(errno));
+            }
+            if(tPid == 0) {
+               int nNull = ::open("/dev/null", O_WRONLY);
+               if(nNull >= 0) {
+                  ::dup2(nNull, STDOUT_FILENO);
+                  ::close(nNull);
+               }
+               bool bOk = RunWarmUp(sExperiment, m_unWarmUpTicks, m_sBudget, nFile);
+               ::close(nFile);
+               ::_exit(bOk ? 0 : 1);
+            }
+            sExperiment.WarmUp = WARMUP_RUNNING;
+            SWorker sWorker = { WARMUP_TRIAL, unExperiment, nFile };
+            mapWorkers[tPid] = sWorker;
+            continue;
+         }
+         STrial sTrial;
+         sTrial.Experiment = sExperiment.Path;
+         sTrial.Index = sExperiment.Launched;
+         sTrial.Seed = DeriveSeed(sExperiment.BaseSeed, sTrial.Index);
+         m_vecTrials.push_back(sTrial);
+         ++sExperiment.Launched;
+         ++sExperiment.Running;
+         UInt32 unNext = m_vecTrials.size() - 1;
+         int pnPipe[2];
+         if(::pipe(pnPipe) != 0) {
+            THROW_ARGOSEXCEPTION("Cannot create result pipe: " << ::strerror(errno));
+         }
+         /* Don't let the worker inherit pending output */
+         c_out.flush();
+         pid_t tPid = ::fork();
+         if(tPid < 0) {
+            THROW_ARGOSEXCEPTION("Cannot fork trial worker: " << ::strerror(errno));
+         }
+         if(tPid == 0) {
+            /* Worker process: silence LOG, run the trial, report and quit */
+            ::close(pnPipe[0]);
+            int nNull = ::open("/dev/null", O_WRONLY);
+            if(nNull >= 0) {
+               ::dup2(nNull, STDOUT_FILENO);
+               ::close(nNull);
+            }
+            SResult sResult = RunTrial(m_vecTrials[unNext], unNext, sExperiment, m_sBudget);
+            ssize_t nWritten = ::write(pnPipe[1], &sResult, sizeof(sResult));
+            ::close(pnPipe[1]);
+            ::_exit((sResult.Ok && nWritten == sizeof(sResult)) ? 0 : 1);
+         }
+         ::close(pnPipe[1]);
+         SWorker sWorker = { unNext, unExperiment, pnPipe[0] };
+         mapWorkers[tPid] = sWorker;
+      }
+      if(mapWorkers.empty()) break;
+      /* Wait for any worker to finish */
+      int nStatus;
+      struct rusage sUsage;
+      pid_t tPid = ::wait4(-1, &nStatus, 0, &sUsage);
+      if(tPid < 0) {
+         if(errno == EINTR) continue;
+         THROW_ARGOSEXCEPTION("Error waiting for trial workers: " << ::strerror(errno));
+      }
+      std::map<pid_t, SWorker>::iterator itWorker = mapWorkers.find(tPid);
+      if(itWorker == mapWorkers.end()) continue;
+      Real fCpuTime =
+         sUsage.ru_utime.tv_sec + sUsage.ru_utime.tv_usec * 1e-6 +
+         sUsage.ru_stime.tv_sec + sUsage.ru_stime.tv_usec * 1e-6;
+      m_fCpuTime += fCpuTime;
+      if(itWorker->second.Trial == WARMUP_TRIAL) {
+         /* Collect the snapshot; the warm-up has no row of its own */
+         SExperiment& sExperiment = m_vecExperiments[itWorker->second.Experiment];
+         if(WIFEXITED(nStatus) && WEXITSTATUS(nStatus) == 0 &&
+            ReadSnapshotFile(itWorker->second.Pipe, sExperiment.Snapshot)) {
+            sExperiment.WarmUp = WARMUP_DONE;
+         }
+         else {
+            sExperiment.WarmUp = WARMUP_FAILED;
+            std::cerr << "Warm-up of " << sExperiment.Path << " failed, skipping its trials" << std::endl;
+         }
+         ::close(itWorker->second.Pipe);
+         mapWorkers.erase(itWorker);
+         continue;
+      }
+      /* Collect the result; a crashed worker leaves the pipe empty */
+      SResult sResult;
+      if(::read(itWorker->second.Pipe, &sResult, sizeof(sResult)) != sizeof(sResult)) {
+         sResult.Trial = itWorker->second.Trial;
+         sResult.Ticks = 0;
+         sResult.Found = false;
+         sResult.Censored = false;
+         sResult.PathLength = 0.0;
+         sResult.Messages = 0;
+         sResult.Hops = 0;
+         sResult.WallTime = 0.0;
+         sResult.Ok = false;
+      }
+      ::close(itWorker->second.Pipe);
+      sResult.CpuTime = fCpuTime;
+      SExperiment& sExperiment = m_vecExperiments[itWorker->second.Experiment];
+      --sExperiment.Running;
+      if(sResult.Ok) {
+         sExperiment.Ticks.push_back(sResult.Ticks);
+         sExperiment.Censored.push_back(sResult.Censored);
+      }
+      const STrial& sTrial = m_vecTrials[itWorker->second.Trial];
+      c_out << sTrial.Experiment << ","
+            << sTrial.Index << ","
+            << sTrial.Seed << ","
+            << sResult.Ticks << ","
+            << sResult.Found << ","
+            << sResult.Censored << ","
+            << sResult.PathLength << ","
+            << sResult.Messages << ","
+            << sResult.Hops << ","
+            << sResult.WallTime << ","
+            << sResult.CpuTime << ","
+            << (sResult.Ok ? "ok" : "error")
+            << std::endl;
+      mapWorkers.erase(itWorker);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::WriteReport(std::ostream& c_out) const {
+   const char* pchStatistic = (m_sRule.Statistic == CTrialStatistics::STAT_MEDIAN) ? "median" : "mean";
+   bool bBudgetSpent = m_sRule.CpuBudget > 0.0 && m_fCpuTime >= m_sRule.CpuBudget;
+   for(size_t i = 0; i < m_vecExperiments.size(); ++i) {
+      const SExperiment& sExperiment = m_vecExperiments[i];
+      c_out << sExperiment.Path << ": "
+            << sExperiment.Ticks.size() << "/" << sExperiment.Launched << " trials ok";
+      if(sExperiment.WarmUp == WARMUP_FAILED) {
+         c_out << ", warm-up failed" << std::endl;
+         continue;
+      }
+      UInt32 unCensored = std::count(sExperiment.Censored.begin(), sExperiment.Censored.end(), true);
+      CTrialStatistics::SInterval sInterval;
+      if(CTrialStatistics::Compute(m_sRule.Statistic, GetSamples(sExperiment), sInterval)) {
+         c_out << ", " << pchStatistic << " " << sInterval.Estimate
+               << " ticks, 95% CI [" << sInterval.Lower << ", " << sInterval.Upper
+               << "], relative width " << CTrialStatistics::RelativeWidth(sInterval);
+      }
+      else if(unCensored > 0 && m_sRule.Statistic == CTrialStatistics::STAT_MEAN) {
+         c_out << ", mean undefined with censored trials";
+      }
+      if(unCensored > 0) {
+         std::vector<CTrialStatistics::SSurvivalStep> vecCurve;
+         CTrialStatistics::KaplanMeier(sExperiment.Ticks, sExperiment.Censored, vecCurve);
+         c_out << ", " << unCensored << " censored, restricted mean "
+               << CTrialStatistics::RestrictedMean(vecCurve) << " ticks";
+         Real fMedian = CTrialStatistics::SurvivalMedian(vecCurve);
+         if(fMedian < std::numeric_limits<Real>::max()) {
+            c_out << ", Kaplan-Meier median " << fMedian << " ticks";
+         }
+         else {
+            c_out << ", Kaplan-Meier median beyond the budget";
+         }
+      }
+      if(m_sRule.Width > 0.0) {
+         if(GetWidth(sExperiment) <= m_sRule.Width) {
+            c_out << ", converged";
+         }
+         else if(sExperiment.Launched >= m_sRule.MaxTrials) {
+            c_out << ", stopped at the maximum number of trials";
+         }
+         else if(bBudgetSpent) {
+            c_out << ", stopped by the CPU budget";
+         }
+      }
+      else if(sExperiment.Launched < sExperiment.Trials && bBudgetSpent) {
+         c_out << ", stopped by the CPU budget";
+      }
+      c_out << std::endl;
+   }
+   c_out << "CPU time used: " << m_fCpuTime << " s" << std::endl;
+}
+
+/****************************************/
+/****************************************/
+
+bool CTrialRunner::NextExperiment(UInt32& un_experiment) const {
+   if(m_sRule.CpuBudget > 0.0 && m_fCpuTime >= m_sRule.CpuBudget) {
+      return false;
+   }
+   /* The queued trials go first, in order, as soon as their warm-up is done */
+   for(size_t i = 0; i < m_vecExperiments.size(); ++i) {
+      if(m_vecExperiments[i].WarmUp == WARMUP_RUNNING ||
+         m_vecExperiments[i].WarmUp == WARMUP_FAILED) continue;
+      if(m_vecExperiments[i].Launched < m_vecExperiments[i].Trials) {
+         un_experiment = i;
+         return true;
+      }
+   }
+   if(m_sRule.Width <= 0.0) {
+      return false;
+   }
+   /* Then the experiment whose interval is expected to be the widest */
+   bool bFound = false;
+   Real fWidest = 0.0;
+   for(size_t i = 0; i < m_vecExperiments.size(); ++i) {
+      const SExperiment& sExperiment = m_vecExperiments[i];
+      if(sExperiment.Launched >= m_sRule.MaxTrials) continue;
+      size_t unDone = sExperiment.Ticks.size();
+      /* Wait for results before piling more trials on an experiment */
+      if(unDone == 0) continue;
+      /* The running trials will narrow the interval, roughly as 1/sqrt(n) */
+      Real fWidth = GetWidth(sExperiment);
+      if(fWidth == std::numeric_limits<Real>::max()) {
+         if(sExperiment.Running > 0) continue;
+      }
+      else {
+         fWidth *= std::sqrt(static_cast<Real>(unDone) / (unDone + sExperiment.Running));
+      }
+      if(fWidth <= m_sRule.Width) continue;
+      if(!bFound || fWidth > fWidest) {
+         bFound = true;
+         fWidest = fWidth;
+         un_experiment = i;
+      }
+   }
+   return bFound;
+}
+
+/****************************************/
+/****************************************/
+
+Real CTrialRunner::GetWidth(const SExperiment& s_experiment) const {
+   CTrialStatistics::SInterval sInterval;
+   if(!CTrialStatistics::Compute(m_sRule.Statistic, GetSamples(s_experiment), sInterval)) {
+      return std::numeric_limits<Real>::max();
+   }
+   return CTrialStatistics::RelativeWidth(sInterval);
+}
+
+/****************************************/
+/****************************************/
+
+std::vector<Real> CTrialRunner::GetSamples(const SExperiment& s_experiment) {
+   std::vector<Real> vecSamples(s_experiment.Ticks);
+   for(size_t i = 0; i < vecSamples.size(); ++i) {
+      if(s_experiment.Censored[i]) {
+         vecSamples[i] = std::numeric_limits<Real>::infinity();
+      }
+   }
+   return vecSamples;
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialRunner::WriteSurvival(std::ostream& c_out) const {
+   c_out << "experiment,ticks,at_risk,events,censored,survival" << std::endl;
+   for(size_t i = 0; i < m_vecExperiments.size(); ++i) {
+      const SExperiment& sExperiment = m_vecExperiments[i];
+      std::vector<CTrialStatistics::SSurvivalStep> vecCurve;
+      CTrialStatistics::KaplanMeier(sExperiment.Ticks, sExperiment.Censored, vecCurve);
+      for(size_t j = 0; j < vecCurve.size(); ++j) {
+         c_out << sExperiment.Path << ","
+               << vecCurve[j].Time << ","
+               << vecCurve[j].AtRisk << ","
+               << vecCurve[j].Events << ","
+               << vecCurve[j].Censored << ","
+               << vecCurve[j].Survival << std::endl;
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
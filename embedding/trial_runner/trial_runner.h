@@ -0,0 +1,300 @@
+/*
+ * Parallel trial runner.
+ *
+ * Runs many independent trials of an ARGoS experiment and writes one
+ * result row per trial. The simulator is a process-wide singleton, so
+ * the runner parallelises by forking: the parent process never touches
+ * CSimulator, it only schedules trials and collects results, while
+ * every trial runs in its own short-lived child process that embeds the
+ * simulator. At most one child per worker slot is alive at any time.
+ *
+ * Every trial gets its own random seed, derived from a base seed and the
+ * trial index, so sweeps are reproducible and trials are independent
+ * (the .argos files hard-code random_seed, which would otherwise make all
+ * trials identical).
+ *
+ * The per-trial results are read from the nav_loop_functions summary.
+ * If the experiment records its radio traffic, every trial writes it to
+ * its own file, with the trial seed appended to the name
+ * (nav_traffic.csv becomes nav_traffic_<seed>.csv).
+ * With a tick or wall-clock budget, trials that run out of it are
+ * stopped by the loop functions and kept as right-censored results, so
+ * a bad seed cannot stall a sweep and the slow configurations are not
+ * favoured by dropping their worst trials. Kaplan-Meier survival curves
+ * and restricted means summarize the censored experiments.
+ *
+ * By default every experiment runs a fixed number of trials. With a
+ * stopping rule the runner works sequentially instead: it keeps
+ * launching seeds for an experiment until the 95% confidence interval on
+ * the mean or median time to target is narrow enough, or until the CPU
+ * budget is spent. Free workers always go to the experiment whose
+ * interval is currently the widest, so experiments that converge fast
+ * (e.g. dense swarms in an empty arena) stop taking compute early and
+ * the long-tailed ones get the rest.
+ *
+ * With a warm-up, the first ticks of an experiment are simulated once:
+ * a worker runs them, snapshots the robots (see nav_loop_functions.h)
+ * and hands the snapshot back to the runner. Every trial then restores
+ * the snapshot and only simulates from there, with its own seed, so
+ * the trials branch from a common state instead of each paying for the
+ * deployment phase again.
+ */
+
+#ifndef TRIAL_RUNNER_H
+#define TRIAL_RUNNER_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
+
+#include "sweep.h"
+#include "trial_statistics.h"
+
+#include <list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CTrialRunner {
+
+public:
+
+   /* Description of a single trial */
+   struct STrial {
+      /* Path to the .argos experiment file */
+      std::string Experiment;
+      /* Index of the trial within its experiment */
+      UInt32 Index;
+      /* Random seed of the trial (never 0, which ARGoS treats as 'use the clock') */
+      UInt32 Seed;
+   };
+
+   /* When to stop launching trials for an experiment */
+   struct SStoppingRule {
+      /*
+       * Width of the 95% confidence interval, relative to the estimate,
+       * below which an experiment has converged (0 runs a fixed number of
+       * trials)
+       */
+      Real Width;
+      /* Statistic the interval is computed for */
+      CTrialStatistics::EStatistic Statistic;
+      /* Maximum number of trials per experiment */
+      UInt32 MaxTrials;
+      /* CPU time all the trials may use together, in seconds (0 for no limit) */
+      Real CpuBudget;
+   };
+
+   /* Limits after which a trial is stopped and its result censored */
+   struct STrialBudget {
+      /* Simulation ticks (0 for no limit) */
+      UInt32 Ticks;
+      /* Wall-clock time, in seconds (0 for no limit) */
+      Real WallTime;
+   };
+
+   /* Outcome of a single trial, as sent back from the worker process */
+   struct SResult {
+      /* Index in the trial list */
+      UInt32 Trial;
+      /* Simulation clock when the experiment finished */
+      UInt32 Ticks;
+      /* Whether every navigator reached its target */
+      bool Found;
+      /* Whether the trial was stopped by its budget */
+      bool Censored;
+      /* Distance covered by the navigators, in cm */
+      Real PathLength;
+      /* Messages sent by all the robots */
+      UInt32 Messages;
+      /* Nav points the navigators went through */
+      UInt32 Hops;
+      /* Wall-clock duration of the trial, in seconds */
+      Real WallTime;
+      /* CPU time used by the worker process, in seconds */
+      Real CpuTime;
+      /* Whether the worker completed the trial without errors */
+      bool Ok;
+   };
+
+public:
+
+   /*
+    * Creates a runner with the given number of worker slots.
+    * Passing 0 sizes the pool to the number of hardware threads.
+    */
+   CTrialRunner(UInt32 un_workers = 0);
+
+   /*
+    * Queues un_count trials of the given experiment; with a stopping rule,
+    * un_count is the number of trials to run before checking convergence.
+    * The seed of each trial is derived from un_base_seed and the trial index.
+    */
+   void AddTrials(const std::string& str_experiment,
+                  UInt32 un_count,
+                  UInt32 un_base_seed);
+
+   /*
+    * Queues un_count trials of every point of a sweep specification (see
+    * sweep.h). The points are named after their values in the results.
+    */
+   void AddSweep(const std::string& str_spec,
+                 UInt32 un_count,
+                 UInt32 un_base_seed);
+
+   /* Sets the stopping rule; must be called before Run() */
+   void SetStoppingRule(const SStoppingRule& s_rule);
+
+   /*
+    * Sets the budget of every trial, overriding the max_ticks and
+    * max_wall_time of the nav_loop_functions; must be called before Run()
+    */
+   void SetTrialBudget(const STrialBudget& s_budget);
+
+   /*
+    * Makes every trial start from a snapshot taken after un_ticks ticks
+    * of its experiment (0 disables the warm-up); must be called before
+    * Run(). The ticks reported for the trials include the warm-up.
+    */
+   inline void SetWarmUp(UInt32 un_ticks) {
+      m_unWarmUpTicks = un_ticks;
+   }
+
+   /*
+    * Runs the trials and writes one CSV row per trial to c_out, preceded
+    * by a header row. Rows are written as trials complete.
+    */
+   void Run(std::ostream& c_out);
+
+   /*
+    * Writes one line per experiment with the trials run, the confidence
+    * interval reached and why the runner stopped.
+    */
+   void WriteReport(std::ostream& c_out) const;
+
+   /*
+    * Writes the Kaplan-Meier curve of the time to target of every
+    * experiment as CSV, one row per distinct time.
+    */
+   void WriteSurvival(std::ostream& c_out) const;
+
+   inline UInt32 GetNumWorkers() const {
+      return m_unWorkers;
+   }
+
+   inline size_t GetNumExperiments() const {
+      return m_vecExperiments.size();
+   }
+
+   /* Trials launched so far, in launch order */
+   inline const std::vector<STrial>& GetTrials() const {
+      return m_vecTrials;
+   }
+
+   /*
+    * Derives the seed for a trial. Exposed so that results can be
+    * reproduced by running a single trial with the same seed.
+    */
+   static UInt32 DeriveSeed(UInt32 un_base_seed, UInt32 un_trial);
+
+   /*
+    * Initializes the simulator of the calling process from an already
+    * parsed experiment tree, overriding the random seed and disabling
+    * any visualization and summary file output. The limits of s_budget
+    * that are set override those of the loop functions. The document
+    * owning t_root must outlive the simulation.
+    */
+   static void LoadExperiment(TConfigurationNode& t_root,
+                              UInt32 un_seed,
+                              const STrialBudget& s_budget);
+
+private:
+
+   /* State of the warm-up of an experiment */
+   enum EWarmUp {
+      WARMUP_NONE,
+      WARMUP_PENDING,
+      WARMUP_RUNNING,
+      WARMUP_DONE,
+      WARMUP_FAILED
+   };
+
+   /* An experiment and the trials run so far */
+   struct SExperiment {
+      /* Path of the .argos file, or name of the sweep point */
+      std::string Path;
+      /* Sweep the experiment is a point of, or NULL */
+      CSweep* Sweep;
+      size_t Point;
+      UInt32 BaseSeed;
+      /* Trials to run, or to run before checking convergence */
+      UInt32 Trials;
+      /* Trials started, and those still running */
+      UInt32 Launched;
+      UInt32 Running;
+      /* Time to target of the completed trials, in ticks */
+      std::vector<Real> Ticks;
+      /* Whether each of Ticks is censored */
+      std::vector<bool> Censored;
+      EWarmUp WarmUp;
+      /* State of the robots at the end of the warm-up */
+      CByteArray Snapshot;
+   };
+
+   /*
+    * Picks the experiment the next trial goes to.
+    * Returns false if no experiment needs more trials.
+    */
+   bool NextExperiment(UInt32& un_experiment) const;
+
+   /*
+    * Relative width of the confidence interval of an experiment, or a
+    * very large value if there are not enough results for one.
+    */
+   Real GetWidth(const SExperiment& s_experiment) const;
+
+   /* Time to target of the completed trials, infinite for the censored ones */
+   static std::vector<Real> GetSamples(const SExperiment& s_experiment);
+
+private:
+
+   /* Executes a trial in the current (worker) process */
+   static SResult RunTrial(const STrial& s_trial,
+                           UInt32 un_trial,
+                           SExperiment& s_experiment,
+                           const STrialBudget& s_budget);
+
+   /*
+    * Executes the warm-up of an experiment in the current (worker)
+    * process and writes the snapshot to n_file
+    */
+   static bool RunWarmUp(SExperiment& s_experiment,
+                         UInt32 un_ticks,
+                         const STrialBudget& s_budget,
+                         int n_file);
+
+   /* Parses the experiment, or expands its sweep point, and loads it */
+   static void LoadTrial(SExperiment& s_experiment,
+                         UInt32 un_seed,
+                         const STrialBudget& s_budget,
+                         ticpp::Document& c_document);
+
+private:
+
+   UInt32 m_unWorkers;
+   std::vector<STrial> m_vecTrials;
+   std::vector<SExperiment> m_vecExperiments;
+   /* Loaded sweeps; a list keeps them in place */
+   std::list<CSweep> m_lstSweeps;
+   SStoppingRule m_sRule;
+   STrialBudget m_sBudget;
+   /* Ticks of warm-up shared by the trials of an experiment */
+   UInt32 m_unWarmUpTicks;
+   /* CPU time used by the finished trials and warm-ups, in seconds */
+   Real m_fCpuTime;
+
+};
+
+#endif
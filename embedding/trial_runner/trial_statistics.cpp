@@ -0,0 +1,158 @@
+#include "trial_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+/* 97.5% quantile of the standard normal distribution */
+static const Real NORMAL_QUANTILE = 1.959963984540054;
+
+/****************************************/
+/****************************************/
+
+bool CTrialStatistics::Compute(EStatistic e_statistic,
+                               const std::vector<Real>& vec_samples,
+                               SInterval& s_interval) {
+   switch(e_statistic) {
+      case STAT_MEAN:   return MeanInterval(vec_samples, s_interval);
+      case STAT_MEDIAN: return MedianInterval(vec_samples, s_interval);
+   }
+   return false;
+}
+
+/****************************************/
+/****************************************/
+
+Real CTrialStatistics::RelativeWidth(const SInterval& s_interval) {
+   if(s_interval.Estimate == 0.0 ||
+      !std::isfinite(s_interval.Lower) ||
+      !std::isfinite(s_interval.Upper)) {
+      return std::numeric_limits<Real>::max();
+   }
+   return (s_interval.Upper - s_interval.Lower) / std::fabs(s_interval.Estimate);
+}
+
+/****************************************/
+/****************************************/
+
+Real CTrialStatistics::StudentQuantile(UInt32 un_dof) {
+   /* Cornish-Fisher expansion around the normal quantile, within 0.2% from 5 dof up */
+   static const Real pfExact[] = { 0.0, 12.706, 4.303, 3.182, 2.776 };
+   if(un_dof < 5) return pfExact[un_dof];
+   Real fZ = NORMAL_QUANTILE;
+   Real fZ2 = fZ * fZ;
+   Real fNu = un_dof;
+   return fZ +
+      fZ * (fZ2 + 1.0) / (4.0 * fNu) +
+      fZ * ((5.0 * fZ2 + 16.0) * fZ2 + 3.0) / (96.0 * fNu * fNu) +
+      fZ * (((3.0 * fZ2 + 19.0) * fZ2 + 17.0) * fZ2 - 15.0) / (384.0 * fNu * fNu * fNu);
+}
+
+/****************************************/
+/****************************************/
+
+bool CTrialStatistics::MeanInterval(const std::vector<Real>& vec_samples,
+                                    SInterval& s_interval) {
+   size_t unN = vec_samples.size();
+   if(unN < 2) return false;
+   Real fMean = 0.0;
+   for(size_t i = 0; i < unN; ++i) {
+      /* A censored sample leaves the mean undefined */
+      if(!std::isfinite(vec_samples[i])) return false;
+      fMean += vec_samples[i];
+   }
+   fMean /= unN;
+   Real fVariance = 0.0;
+   for(size_t i = 0; i < unN; ++i) {
+      fVariance += (vec_samples[i] - fMean) * (vec_samples[i] - fMean);
+   }
+   fVariance /= unN - 1;
+   Real fHalfWidth = StudentQuantile(unN - 1) * std::sqrt(fVariance / unN);
+   s_interval.Estimate = fMean;
+   s_interval.Lower = fMean - fHalfWidth;
+   s_interval.Upper = fMean + fHalfWidth;
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+bool CTrialStatistics::MedianInterval(const std::vector<Real>& vec_samples,
+                                      SInterval& s_interval) {
+   size_t unN = vec_samples.size();
+   if(unN == 0) return false;
+   /* 1-based ranks of the order statistics bounding the median */
+   Real fSpread = NORMAL_QUANTILE * std::sqrt(static_cast<Real>(unN)) / 2.0;
+   Real fLower = std::floor(unN / 2.0 - fSpread);
+   Real fUpper = std::ceil(1.0 + unN / 2.0 + fSpread);
+   if(fLower < 1.0 || fUpper > unN) return false;
+   std::vector<Real> vecSorted(vec_samples);
+   std::sort(vecSorted.begin(), vecSorted.end());
+   s_interval.Estimate = (unN & 1) ?
+      vecSorted[unN / 2] :
+      (vecSorted[unN / 2 - 1] + vecSorted[unN / 2]) / 2.0;
+   s_interval.Lower = vecSorted[static_cast<size_t>(fLower) - 1];
+   s_interval.Upper = vecSorted[static_cast<size_t>(fUpper) - 1];
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+void CTrialStatistics::KaplanMeier(const std::vector<Real>& vec_times,
+                                   const std::vector<bool>& vec_censored,
+                                   std::vector<SSurvivalStep>& vec_curve) {
+   vec_curve.clear();
+   /* Sort by time, events before censoring at equal times */
+   std::vector<std::pair<Real, bool> > vecTrials;
+   for(size_t i = 0; i < vec_times.size(); ++i) {
+      vecTrials.push_back(std::make_pair(vec_times[i], vec_censored[i]));
+   }
+   std::sort(vecTrials.begin(), vecTrials.end());
+   UInt32 unAtRisk = vecTrials.size();
+   Real fSurvival = 1.0;
+   size_t i = 0;
+   while(i < vecTrials.size()) {
+      SSurvivalStep sStep;
+      sStep.Time = vecTrials[i].first;
+      sStep.AtRisk = unAtRisk;
+      sStep.Events = 0;
+      sStep.Censored = 0;
+      for(; i < vecTrials.size() && vecTrials[i].first == sStep.Time; ++i) {
+         if(vecTrials[i].second) ++sStep.Censored;
+         else ++sStep.Events;
+      }
+      fSurvival *= 1.0 - static_cast<Real>(sStep.Events) / sStep.AtRisk;
+      sStep.Survival = fSurvival;
+      unAtRisk -= sStep.Events + sStep.Censored;
+      vec_curve.push_back(sStep);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+Real CTrialStatistics::SurvivalMedian(const std::vector<SSurvivalStep>& vec_curve) {
+   for(size_t i = 0; i < vec_curve.size(); ++i) {
+      if(vec_curve[i].Survival <= 0.5) {
+         return vec_curve[i].Time;
+      }
+   }
+   return std::numeric_limits<Real>::max();
+}
+
+/****************************************/
+/****************************************/
+
+Real CTrialStatistics::RestrictedMean(const std::vector<SSurvivalStep>& vec_curve) {
+   Real fArea = 0.0;
+   Real fTime = 0.0;
+   Real fSurvival = 1.0;
+   for(size_t i = 0; i < vec_curve.size(); ++i) {
+      fArea += fSurvival * (vec_curve[i].Time - fTime);
+      fTime = vec_curve[i].Time;
+      fSurvival = vec_curve[i].Survival;
+   }
+   return fArea;
+}
@@ -0,0 +1,111 @@
+/*
+ * Confidence intervals used by the trial runner to decide when an
+ * experiment has had enough trials.
+ *
+ * Both intervals are at the 95% level:
+ * - the mean uses the Student t interval, which is optimistic for
+ *   skewed data: with long-tailed times it covers less than 95%;
+ * - the median uses the distribution-free interval between two order
+ *   statistics, which holds for the long-tailed navigation times
+ *   without assuming anything about their distribution.
+ *
+ * Trials stopped by their tick budget are right-censored: their time to
+ * target is only known to exceed the ticks they ran for. The intervals
+ * take censored times as infinite, which keeps the median interval
+ * valid as long as the median itself is within the budget, and leaves
+ * the mean undefined. The Kaplan-Meier curve and the restricted mean
+ * (area under the curve up to the longest trial) use the censored
+ * trials for what they tell.
+ */
+
+#ifndef TRIAL_STATISTICS_H
+#define TRIAL_STATISTICS_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <vector>
+
+using namespace argos;
+
+class CTrialStatistics {
+
+public:
+
+   /* Statistic an interval is computed for */
+   enum EStatistic {
+      STAT_MEAN,
+      STAT_MEDIAN
+   };
+
+   struct SInterval {
+      Real Estimate;
+      Real Lower;
+      Real Upper;
+   };
+
+   /* A step of a Kaplan-Meier survival curve */
+   struct SSurvivalStep {
+      /* Time of the step, in ticks */
+      Real Time;
+      /* Trials that had not reached the target before Time */
+      UInt32 AtRisk;
+      /* Trials that reached the target at Time */
+      UInt32 Events;
+      /* Trials censored at Time */
+      UInt32 Censored;
+      /* Fraction of the trials that had not reached the target by Time */
+      Real Survival;
+   };
+
+public:
+
+   /*
+    * Computes the 95% confidence interval of a statistic of the samples.
+    * Returns false if there are too few samples for one.
+    */
+   static bool Compute(EStatistic e_statistic,
+                       const std::vector<Real>& vec_samples,
+                       SInterval& s_interval);
+
+   /*
+    * Width of an interval relative to its estimate, or a very large value
+    * if the estimate is 0.
+    */
+   static Real RelativeWidth(const SInterval& s_interval);
+
+   /* 97.5% quantile of the Student t distribution with un_dof degrees of freedom */
+   static Real StudentQuantile(UInt32 un_dof);
+
+   /*
+    * Computes the Kaplan-Meier estimate of the probability of not having
+    * reached the target, one step per distinct time. At equal times,
+    * events are taken to come before censoring.
+    */
+   static void KaplanMeier(const std::vector<Real>& vec_times,
+                           const std::vector<bool>& vec_censored,
+                           std::vector<SSurvivalStep>& vec_curve);
+
+   /*
+    * Time at which a survival curve drops to 0.5 or below, or a very
+    * large value if it never does.
+    */
+   static Real SurvivalMedian(const std::vector<SSurvivalStep>& vec_curve);
+
+   /*
+    * Area under a survival curve up to its last step: the mean time to
+    * target restricted to the longest trial. Without censoring, this is
+    * the mean.
+    */
+   static Real RestrictedMean(const std::vector<SSurvivalStep>& vec_curve);
+
+private:
+
+   static bool MeanInterval(const std::vector<Real>& vec_samples,
+                            SInterval& s_interval);
+
+   static bool MedianInterval(const std::vector<Real>& vec_samples,
+                              SInterval& s_interval);
+
+};
+
+#endif
@@ -1,15 +1,83 @@
 #include "id_qtuser_functions.h"
 
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+/* Height of the overlay, above the foot-bots, in m */
+static const Real OVERLAY_Z = 0.25;
+/* Farthest a robot may be from the nav point to be taken as the one there, in m */
+static const Real NAV_POINT_TOLERANCE = 0.2;
+/* Size of the heatmap points, in pixels */
+static const Real HEATMAP_POINT_SIZE = 10.0;
+/* Most hops drawn from a nav point towards the target */
+static const size_t MAX_CHAIN_HOPS = 256;
+/* Most grid cells per robot; the cells grow past comm_range beyond that */
+static const size_t MAX_CELLS_PER_ROBOT = 4;
+
 /****************************************/
 /****************************************/
 
-CIDQTUserFunctions::CIDQTUserFunctions() {
+CIDQTUserFunctions::CIDQTUserFunctions() :
+   m_unRefreshClock(0),
+   m_bStale(true),
+   m_fCellSize(1.0),
+   m_unGridWidth(0),
+   m_unGridHeight(0),
+   m_bHeatmap(false),
+   m_unHeatmapTarget(0),
+   m_fHeatmapScale(0.0),
+   m_fHeatmapMax(0.0) {
    RegisterUserFunction<CIDQTUserFunctions,CFootBotEntity>(&CIDQTUserFunctions::Draw);
 }
 
 /****************************************/
 /****************************************/
 
+void CIDQTUserFunctions::Init(TConfigurationNode& t_tree) {
+   GetNodeAttributeOrDefault(t_tree, "heatmap", m_bHeatmap, m_bHeatmap);
+   UInt32 unHeatmapTarget = m_unHeatmapTarget;
+   GetNodeAttributeOrDefault(t_tree, "heatmap_target", unHeatmapTarget, unHeatmapTarget);
+   if(unHeatmapTarget > 255) {
+      THROW_ARGOSEXCEPTION("[id_qtuser_functions] heatmap_target must be in [0,255], got " << unHeatmapTarget);
+   }
+   m_unHeatmapTarget = unHeatmapTarget;
+   GetNodeAttributeOrDefault(t_tree, "heatmap_scale", m_fHeatmapScale, m_fHeatmapScale);
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::Reset() {
+   m_vecRobots.clear();
+   m_mapRobots.clear();
+   m_vecNavRays.clear();
+   m_vecNavPointRobots.clear();
+   m_vecHopRays.clear();
+   m_vecHeatmapPoints.clear();
+   m_vecHeatmapColors.clear();
+   m_fHeatmapMax = 0.0;
+   m_bStale = true;
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::Destroy() {
+   Reset();
+}
+
+/****************************************/
+/****************************************/
+
 void CIDQTUserFunctions::Draw(CFootBotEntity& c_entity) {
    /* The position of the text is expressed wrt the reference point of the footbot
     * For a foot-bot, the reference point is the center of its base.
@@ -17,15 +85,302 @@ void CIDQTUserFunctions::Draw(CFootBotEntity& c_entity) {
     * $ argos3 -q foot-bot
     */
 
-   std::string id = c_entity.GetId();
-   if (id == "fb_nav") {
+   std::unordered_map<const CFootBotEntity*, size_t>::const_iterator it = m_mapRobots.find(&c_entity);
+   if (it == m_mapRobots.end()) {
+      CollectRobots();
+      it = m_mapRobots.find(&c_entity);
+      if (it == m_mapRobots.end()) return;
+   }
+   int role = m_vecRobots[it->second].Role;
+   if (role == CNavController::ROLE_NAVIGATOR) {
       DrawText(CVector3(0.15, 0.0, 0.3),   // position
             "Nav"); // text
-   } else if (id == "fb_target") {
+   } else if (role == CNavController::ROLE_TARGET) {
       DrawText(CVector3(0.0, 0.0, 0.3),   // position
             "Target"); // text
    }
-   
+
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::DrawInWorld() {
+   if(!CheckRobots()) {
+      CollectRobots();
+   }
+   UInt32 unClock = CSimulator::GetInstance().GetSpace().GetSimulationClock();
+   if(m_bStale || unClock != m_unRefreshClock) {
+      Refresh();
+      m_unRefreshClock = unClock;
+      m_bStale = false;
+   }
+   if(!m_vecHeatmapPoints.empty()) {
+      /* All the points in one batch, rather than a DrawPoint() per robot */
+      glPushAttrib(GL_CURRENT_BIT | GL_LIGHTING_BIT | GL_POINT_BIT);
+      glDisable(GL_LIGHTING);
+      glPointSize(HEATMAP_POINT_SIZE);
+      glBegin(GL_POINTS);
+      for(size_t i = 0; i < m_vecHeatmapPoints.size(); ++i) {
+         glColor3ub(m_vecHeatmapColors[i].GetRed(),
+                    m_vecHeatmapColors[i].GetGreen(),
+                    m_vecHeatmapColors[i].GetBlue());
+         glVertex3f(m_vecHeatmapPoints[i].GetX(),
+                    m_vecHeatmapPoints[i].GetY(),
+                    m_vecHeatmapPoints[i].GetZ());
+      }
+      glEnd();
+      glPopAttrib();
+   }
+   for(size_t i = 0; i < m_vecNavRays.size(); ++i) {
+      DrawRay(m_vecNavRays[i], CColor::YELLOW, 3.0);
+   }
+   for(size_t i = 0; i < m_vecNavPointRobots.size(); ++i) {
+      DrawPoint(m_vecNavPointRobots[i], CColor::MAGENTA, HEATMAP_POINT_SIZE * 1.5);
+   }
+   for(size_t i = 0; i < m_vecHopRays.size(); ++i) {
+      DrawRay(m_vecHopRays[i], CColor::GREEN, 2.0);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::CollectRobots() {
+   m_vecRobots.clear();
+   m_mapRobots.clear();
+   CSpace::TMapPerType& tFootBots = CSimulator::GetInstance().GetSpace().GetEntitiesByType("foot-bot");
+   for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+       it != tFootBots.end();
+       ++it) {
+      SRobot sRobot;
+      sRobot.Entity = any_cast<CFootBotEntity*>(it->second);
+      sRobot.Controller =
+         dynamic_cast<CNavController*>(&sRobot.Entity->GetControllableEntity().GetController());
+      if(sRobot.Controller != NULL) {
+         sRobot.Role = sRobot.Controller->GetRole();
+      }
+      /* Robots running another controller keep the roles of the original experiments */
+      else if(sRobot.Entity->GetId() == "fb_nav") {
+         sRobot.Role = CNavController::ROLE_NAVIGATOR;
+      }
+      else if(sRobot.Entity->GetId() == "fb_target") {
+         sRobot.Role = CNavController::ROLE_TARGET;
+      }
+      else {
+         sRobot.Role = CNavController::ROLE_ASSISTANT;
+      }
+      m_mapRobots[sRobot.Entity] = m_vecRobots.size();
+      m_vecRobots.push_back(sRobot);
+   }
+   m_bStale = true;
+}
+
+/****************************************/
+/****************************************/
+
+bool CIDQTUserFunctions::CheckRobots() {
+   /*
+    * The space keeps the foot-bots sorted by id, and the cache in the same
+    * order, so any foot-bot added or removed shows as a different entity
+    * at some index, even when the count stays the same.
+    */
+   CSpace::TMapPerType& tFootBots = CSimulator::GetInstance().GetSpace().GetEntitiesByType("foot-bot");
+   if(tFootBots.size() != m_vecRobots.size()) return false;
+   size_t unIndex = 0;
+   for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+       it != tFootBots.end();
+       ++it, ++unIndex) {
+      if(any_cast<CFootBotEntity*>(it->second) != m_vecRobots[unIndex].Entity) return false;
+   }
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::Refresh() {
+   /* Refresh the positions and colour the heatmap in one pass */
+   Real fScale = (m_fHeatmapScale > 0.0) ? m_fHeatmapScale : m_fHeatmapMax;
+   Real fMax = 0.0;
+   m_vecHeatmapPoints.clear();
+   m_vecHeatmapColors.clear();
+   CRadians cYaw, cPitch, cRoll;
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      SRobot& sRobot = m_vecRobots[i];
+      const SAnchor& sAnchor = sRobot.Entity->GetEmbodiedEntity().GetOriginAnchor();
+      sRobot.Position = CVector2(sAnchor.Position.GetX(), sAnchor.Position.GetY());
+      sAnchor.Orientation.ToEulerAngles(cYaw, cPitch, cRoll);
+      sRobot.Yaw = cYaw;
+      Real fDistance;
+      if(!m_bHeatmap || !GetDistance(sRobot, m_unHeatmapTarget, fDistance)) continue;
+      if(fDistance > fMax) fMax = fDistance;
+      /* Red next to the target, blue at fScale and beyond */
+      Real fRatio = (fScale > 0.0) ? std::min<Real>(fDistance / fScale, 1.0) : 0.0;
+      m_vecHeatmapPoints.push_back(CVector3(sRobot.Position.GetX(), sRobot.Position.GetY(), OVERLAY_Z));
+      m_vecHeatmapColors.push_back(CColor(static_cast<UInt8>(255.0 * (1.0 - fRatio)),
+                                          0,
+                                          static_cast<UInt8>(255.0 * fRatio)));
+   }
+   m_fHeatmapMax = fMax;
+   BuildGrid();
+   m_vecNavRays.clear();
+   m_vecNavPointRobots.clear();
+   m_vecHopRays.clear();
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      if(m_vecRobots[i].Role == CNavController::ROLE_NAVIGATOR &&
+         m_vecRobots[i].Controller != NULL) {
+         BuildNavChain(m_vecRobots[i]);
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::BuildGrid() {
+   m_vecCellStart.clear();
+   m_vecCellRobots.clear();
+   m_unGridWidth = 0;
+   m_unGridHeight = 0;
+   if(m_vecRobots.empty()) return;
+   Real fMinX = m_vecRobots[0].Position.GetX(), fMaxX = fMinX;
+   Real fMinY = m_vecRobots[0].Position.GetY(), fMaxY = fMinY;
+   m_fCellSize = NAV_POINT_TOLERANCE;
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      fMinX = std::min(fMinX, m_vecRobots[i].Position.GetX());
+      fMaxX = std::max(fMaxX, m_vecRobots[i].Position.GetX());
+      fMinY = std::min(fMinY, m_vecRobots[i].Position.GetY());
+      fMaxY = std::max(fMaxY, m_vecRobots[i].Position.GetY());
+      if(m_vecRobots[i].Controller != NULL) {
+         /* comm_range is in cm */
+         m_fCellSize = std::max(m_fCellSize, m_vecRobots[i].Controller->GetCommRange() / 100.0);
+      }
+   }
+   while(true) {
+      m_unGridWidth = static_cast<size_t>((fMaxX - fMinX) / m_fCellSize) + 1;
+      m_unGridHeight = static_cast<size_t>((fMaxY - fMinY) / m_fCellSize) + 1;
+      if(m_unGridWidth * m_unGridHeight <= MAX_CELLS_PER_ROBOT * m_vecRobots.size()) break;
+      m_fCellSize *= 2.0;
+   }
+   m_cGridOrigin = CVector2(fMinX, fMinY);
+   /* Counting sort of the robots by cell */
+   std::vector<size_t> vecCells(m_vecRobots.size());
+   m_vecCellStart.assign(m_unGridWidth * m_unGridHeight + 1, 0);
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      size_t unX = std::min(static_cast<size_t>((m_vecRobots[i].Position.GetX() - fMinX) / m_fCellSize), m_unGridWidth - 1);
+      size_t unY = std::min(static_cast<size_t>((m_vecRobots[i].Position.GetY() - fMinY) / m_fCellSize), m_unGridHeight - 1);
+      vecCells[i] = unY * m_unGridWidth + unX;
+      ++m_vecCellStart[vecCells[i] + 1];
+   }
+   for(size_t c = 1; c < m_vecCellStart.size(); ++c) {
+      m_vecCellStart[c] += m_vecCellStart[c - 1];
+   }
+   std::vector<size_t> vecCursor(m_vecCellStart.begin(), m_vecCellStart.end() - 1);
+   m_vecCellRobots.resize(m_vecRobots.size());
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      m_vecCellRobots[vecCursor[vecCells[i]]++] = i;
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::GetNeighbours(const CVector2& c_center,
+                                       Real f_radius,
+                                       std::vector<size_t>& vec_robots) const {
+   vec_robots.clear();
+   if(m_unGridWidth == 0) return;
+   /* Cells covering the square around the circle, clamped to the grid */
+   SInt64 nMinX = static_cast<SInt64>(std::floor((c_center.GetX() - f_radius - m_cGridOrigin.GetX()) / m_fCellSize));
+   SInt64 nMaxX = static_cast<SInt64>(std::floor((c_center.GetX() + f_radius - m_cGridOrigin.GetX()) / m_fCellSize));
+   SInt64 nMinY = static_cast<SInt64>(std::floor((c_center.GetY() - f_radius - m_cGridOrigin.GetY()) / m_fCellSize));
+   SInt64 nMaxY = static_cast<SInt64>(std::floor((c_center.GetY() + f_radius - m_cGridOrigin.GetY()) / m_fCellSize));
+   nMinX = std::max<SInt64>(nMinX, 0);
+   nMinY = std::max<SInt64>(nMinY, 0);
+   nMaxX = std::min<SInt64>(nMaxX, m_unGridWidth - 1);
+   nMaxY = std::min<SInt64>(nMaxY, m_unGridHeight - 1);
+   for(SInt64 y = nMinY; y <= nMaxY; ++y) {
+      for(SInt64 x = nMinX; x <= nMaxX; ++x) {
+         size_t unCell = y * m_unGridWidth + x;
+         vec_robots.insert(vec_robots.end(),
+                           m_vecCellRobots.begin() + m_vecCellStart[unCell],
+                           m_vecCellRobots.begin() + m_vecCellStart[unCell + 1]);
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+bool CIDQTUserFunctions::GetDistance(const SRobot& s_robot,
+                                     UInt8 un_target,
+                                     Real& f_distance) const {
+   if(s_robot.Controller == NULL) return false;
+   if(s_robot.Role == CNavController::ROLE_TARGET &&
+      s_robot.Controller->GetTargetId() == un_target) {
+      f_distance = 0.0;
+      return true;
+   }
+   return s_robot.Controller->GetTableDistance(un_target, f_distance);
+}
+
+/****************************************/
+/****************************************/
+
+void CIDQTUserFunctions::BuildNavChain(const SRobot& s_navigator) {
+   CNavController::SNavState sState = s_navigator.Controller->GetNavState();
+   if(s_navigator.Controller->HasArrived() || sState.DistanceStar < 0.0) return;
+   UInt8 unTarget = s_navigator.Controller->GetTargetId();
+   /* The nav point is kept relative to the navigator, in cm */
+   CVector2 cNavPoint = s_navigator.Position;
+   cNavPoint += CVector2(sState.BestNavDist / 100.0,
+                         s_navigator.Yaw + CRadians(sState.BestNavHeading));
+   m_vecNavRays.push_back(CRay3(CVector3(s_navigator.Position.GetX(), s_navigator.Position.GetY(), OVERLAY_Z),
+                                CVector3(cNavPoint.GetX(), cNavPoint.GetY(), OVERLAY_Z)));
+   /* The robot at the nav point, which gives the navigator its next heading */
+   const SRobot* psCurrent = NULL;
+   Real fCurrent = 0.0;
+   Real fClosest = NAV_POINT_TOLERANCE * NAV_POINT_TOLERANCE;
+   GetNeighbours(cNavPoint, NAV_POINT_TOLERANCE, m_vecNeighbours);
+   for(size_t n = 0; n < m_vecNeighbours.size(); ++n) {
+      const SRobot& sRobot = m_vecRobots[m_vecNeighbours[n]];
+      Real fDistance;
+      if(sRobot.Role == CNavController::ROLE_NAVIGATOR) continue;
+      Real fSquare = (sRobot.Position - cNavPoint).SquareLength();
+      if(fSquare > fClosest || !GetDistance(sRobot, unTarget, fDistance)) continue;
+      psCurrent = &sRobot;
+      fCurrent = fDistance;
+      fClosest = fSquare;
+   }
+   if(psCurrent == NULL) return;
+   m_vecNavPointRobots.push_back(CVector3(psCurrent->Position.GetX(), psCurrent->Position.GetY(), OVERLAY_Z));
+   /*
+    * Follow the nav tables down to the target: each hop goes to the robot
+    * in range that advertises the shortest distance. The distance strictly
+    * decreases, so the walk ends, at the latest on the target itself;
+    * MAX_CHAIN_HOPS bounds it on a chain of many small improvements.
+    */
+   for(size_t h = 0; h < MAX_CHAIN_HOPS; ++h) {
+      const SRobot* psNext = NULL;
+      Real fNext = fCurrent;
+      Real fRange = psCurrent->Controller->GetCommRange() / 100.0;
+      GetNeighbours(psCurrent->Position, fRange, m_vecNeighbours);
+      for(size_t n = 0; n < m_vecNeighbours.size(); ++n) {
+         const SRobot& sRobot = m_vecRobots[m_vecNeighbours[n]];
+         Real fDistance;
+         if((sRobot.Position - psCurrent->Position).SquareLength() > fRange * fRange ||
+            !GetDistance(sRobot, unTarget, fDistance) ||
+            fDistance >= fNext) continue;
+         psNext = &sRobot;
+         fNext = fDistance;
+      }
+      if(psNext == NULL) break;
+      m_vecHopRays.push_back(CRay3(CVector3(psCurrent->Position.GetX(), psCurrent->Position.GetY(), OVERLAY_Z),
+                                   CVector3(psNext->Position.GetX(), psNext->Position.GetY(), OVERLAY_Z)));
+      psCurrent = psNext;
+      fCurrent = fNext;
+   }
 }
 
 /****************************************/
@@ -1,8 +1,35 @@
+/*
+ * Qt overlay of the navigation experiments.
+ *
+ * Labels the navigators and the targets, and draws the active navigation
+ * chain of every navigator: the nav point it heads to, the robot at that
+ * nav point (the one whose direction reply gives the next heading), and
+ * the path down the nav tables from that robot to the target. Optionally,
+ * it colours every robot by the distance to a target in its nav table.
+ *
+ * The role and the controller of each foot-bot are looked up once and
+ * cached; the cache is rebuilt when a foot-bot is added or removed. The
+ * chains and the heatmap colours are computed once per simulation tick,
+ * the chain walk looking up the robots in range in a grid of the
+ * positions, and every frame only redraws them, the heatmap as a single
+ * batch of points, so the overlay stays cheap with thousands of robots.
+ * Attributes of <user_functions>:
+ *
+ *    heatmap="true"       colours the robots by their nav table distance
+ *    heatmap_target="0"   target whose distance is shown
+ *    heatmap_scale="0"    distance, in cm, shown in blue; 0 scales to the
+ *                         largest distance of the previous tick
+ */
+
 #ifndef ID_QTUSER_FUNCTIONS_H
 #define ID_QTUSER_FUNCTIONS_H
 
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_user_functions.h>
 #include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <controllers/nav_common/nav_controller.h>
+
+#include <unordered_map>
+#include <vector>
 
 using namespace argos;
 
@@ -14,8 +41,88 @@ public:
 
    virtual ~CIDQTUserFunctions() {}
 
+   virtual void Init(TConfigurationNode& t_tree);
+
+   virtual void Reset();
+
+   virtual void Destroy();
+
+   virtual void DrawInWorld();
+
    void Draw(CFootBotEntity& c_entity);
-   
+
+private:
+
+   /* A foot-bot, as cached on the first frame */
+   struct SRobot {
+      CFootBotEntity* Entity;
+      /* NULL if the robot does not run a navigation controller */
+      CNavController* Controller;
+      /* See CNavController::ERole */
+      int Role;
+      /* Position and yaw, refreshed every tick */
+      CVector2 Position;
+      CRadians Yaw;
+   };
+
+   /* Fills the cache from the foot-bots of the space */
+   void CollectRobots();
+
+   /* Returns false if foot-bots were added to or removed from the space since the cache was filled */
+   bool CheckRobots();
+
+   /* Refreshes the positions, the heatmap colours and the chains */
+   void Refresh();
+
+   /* Sorts the robots into square cells as wide as the largest comm_range */
+   void BuildGrid();
+
+   /* Sets vec_robots to the robots of the cells within f_radius of c_center */
+   void GetNeighbours(const CVector2& c_center,
+                      Real f_radius,
+                      std::vector<size_t>& vec_robots) const;
+
+   /* Sets f_distance to the distance from a robot to a target; returns false if unknown */
+   bool GetDistance(const SRobot& s_robot,
+                    UInt8 un_target,
+                    Real& f_distance) const;
+
+   /* Computes the nav point of a navigator and the path from it to the target */
+   void BuildNavChain(const SRobot& s_navigator);
+
+private:
+
+   std::vector<SRobot> m_vecRobots;
+   /* Index of each foot-bot in m_vecRobots */
+   std::unordered_map<const CFootBotEntity*, size_t> m_mapRobots;
+
+   /* Tick the positions and chains were computed at, and whether they must be recomputed anyway */
+   UInt32 m_unRefreshClock;
+   bool m_bStale;
+
+   /* Robots by cell: those of cell c are m_vecCellRobots[m_vecCellStart[c]...m_vecCellStart[c+1]) */
+   CVector2 m_cGridOrigin;
+   Real m_fCellSize;
+   size_t m_unGridWidth;
+   size_t m_unGridHeight;
+   std::vector<size_t> m_vecCellStart;
+   std::vector<size_t> m_vecCellRobots;
+   std::vector<size_t> m_vecNeighbours;
+
+   /* What the chains draw: navigator to nav point, robots at the nav points, hops to the targets */
+   std::vector<CRay3> m_vecNavRays;
+   std::vector<CVector3> m_vecNavPointRobots;
+   std::vector<CRay3> m_vecHopRays;
+
+   bool m_bHeatmap;
+   UInt8 m_unHeatmapTarget;
+   Real m_fHeatmapScale;
+   /* Largest distance of the previous tick, for automatic scaling */
+   Real m_fHeatmapMax;
+   /* Heatmap points and their colours */
+   std::vector<CVector3> m_vecHeatmapPoints;
+   std::vector<CColor> m_vecHeatmapColors;
+
 };
 
 #endif
@@ -0,0 +1,681 @@
+#include "nav_loop_functions.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
+#include <argos3/plugins/simulator/entities/wheeled_entity.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <set>
+
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+/* Magic string at the start of trace files */
+static const char TRACE_MAGIC[] = "NAVTRAC1";
+
+/* Appends a 32 bit integer, in the byte order of the machine */
+static void AppendUInt32(std::vector<char>& vec_buffer,
+                         UInt32 un_value) {
+   const char* pchValue = reinterpret_cast<const char*>(&un_value);
+   vec_buffer.insert(vec_buffer.end(), pchValue, pchValue + sizeof(un_value));
+}
+#endif
+
+/****************************************/
+/****************************************/
+
+CNavLoopFunctions::CNavLoopFunctions() :
+   m_strOutput("nav_summary.csv"),
+   m_strProfile("nav_profile.csv"),
+   m_strTrace("nav_trace.bin"),
+   m_unTraceCapacity(CNavTrace::DEFAULT_CAPACITY),
+   m_pcTraceFile(NULL),
+   m_eTrafficFormat(CTrafficRecorder::FORMAT_CSV),
+   m_bTrafficPerRobot(false),
+   m_bMediumRange(true),
+   m_unTrajectoryKeyframe(CTrajectoryRecorder::DEFAULT_KEYFRAME_INTERVAL),
+   m_unTrajectoryTarget(0),
+   m_bPropagated(false),
+   m_unMaxTicks(0),
+   m_fMaxWallTime(0.0),
+   m_bCensored(false) {
+   m_sSummary.Seed = 0;
+   m_sSummary.Ticks = 0;
+   m_sSummary.Found = false;
+   m_sSummary.Censored = false;
+   m_sSummary.PathLength = 0.0;
+   m_sSummary.Messages = 0;
+   m_sSummary.MessagesPerTick = 0.0;
+   m_sSummary.Hops = 0;
+   m_sSummary.Robots = 0;
+   m_sSummary.Navigators = 0;
+   m_sSummary.Arrived = 0;
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::Init(TConfigurationNode& t_tree) {
+   GetNodeAttributeOrDefault(t_tree, "output", m_strOutput, m_strOutput);
+   GetNodeAttributeOrDefault(t_tree, "profile", m_strProfile, m_strProfile);
+   GetNodeAttributeOrDefault(t_tree, "trace", m_strTrace, m_strTrace);
+   GetNodeAttributeOrDefault(t_tree, "trace_capacity", m_unTraceCapacity, m_unTraceCapacity);
+   GetNodeAttributeOrDefault(t_tree, "traffic", m_strTraffic, m_strTraffic);
+   std::string strTrafficFormat = "csv";
+   GetNodeAttributeOrDefault(t_tree, "traffic_format", strTrafficFormat, strTrafficFormat);
+   m_eTrafficFormat = CTrafficRecorder::ParseFormat(strTrafficFormat);
+   GetNodeAttributeOrDefault(t_tree, "traffic_per_robot", m_bTrafficPerRobot, m_bTrafficPerRobot);
+   GetNodeAttributeOrDefault(t_tree, "trajectory", m_strTrajectory, m_strTrajectory);
+   GetNodeAttributeOrDefault(t_tree, "trajectory_keyframe", m_unTrajectoryKeyframe, m_unTrajectoryKeyframe);
+   if(m_unTrajectoryKeyframe == 0) {
+      THROW_ARGOSEXCEPTION("[nav_loop_functions] trajectory_keyframe must be >= 1");
+   }
+   /* Parsed as a number, not as a character */
+   UInt32 unTrajectoryTarget = m_unTrajectoryTarget;
+   GetNodeAttributeOrDefault(t_tree, "trajectory_target", unTrajectoryTarget, unTrajectoryTarget);
+   if(unTrajectoryTarget > 255) {
+      THROW_ARGOSEXCEPTION("[nav_loop_functions] trajectory_target must be in [0,255], got " << unTrajectoryTarget);
+   }
+   m_unTrajectoryTarget = unTrajectoryTarget;
+   GetNodeAttributeOrDefault(t_tree, "propagation", m_strPropagation, m_strPropagation);
+   GetNodeAttributeOrDefault(t_tree, "navigators", m_strNavigators, m_strNavigators);
+   GetNodeAttributeOrDefault(t_tree, "medium_range", m_bMediumRange, m_bMediumRange);
+   GetNodeAttributeOrDefault(t_tree, "max_ticks", m_unMaxTicks, m_unMaxTicks);
+   GetNodeAttributeOrDefault(t_tree, "max_wall_time", m_fMaxWallTime, m_fMaxWallTime);
+   if(m_fMaxWallTime < 0.0) {
+      THROW_ARGOSEXCEPTION("[nav_loop_functions] max_wall_time must be >= 0, got " << m_fMaxWallTime);
+   }
+   m_tStart = std::chrono::steady_clock::now();
+   m_bCensored = false;
+   CollectControllers();
+   if(m_bMediumRange) {
+      ApplyCommRanges();
+   }
+   StartNavigators();
+   UpdateSummary();
+   OpenTraffic();
+   OpenTrace();
+   StartPropagation();
+   OpenTrajectory();
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::Reset() {
+   m_tStart = std::chrono::steady_clock::now();
+   m_bCensored = false;
+   StartNavigators();
+   UpdateSummary();
+   /* Start the traffic and trace files over */
+   OpenTraffic();
+   OpenTrace();
+   StartPropagation();
+   OpenTrajectory();
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::Destroy() {
+   m_cTraffic.Close();
+   m_cTrajectory.Close();
+   CloseTrace();
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::PostStep() {
+   UpdateNavigators();
+   /* Rings half full go to the file before they overwrite anything */
+   DrainTraces(false);
+   if(!m_bPropagated) {
+      m_bPropagated = UpdatePropagation();
+   }
+   if(m_cTrajectory.IsOpen()) {
+      RecordTrajectory();
+   }
+   if(!m_cTraffic.IsOpen()) return;
+   UInt32 unTick = GetSpace().GetSimulationClock();
+   if(m_bTrafficPerRobot) {
+      for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+         m_cTraffic.Write(unTick, i, m_vecControllers[i]->GetTraffic());
+      }
+   }
+   else {
+      CNavController::STraffic sTotal = {};
+      for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+         const CNavController::STraffic& sTraffic = m_vecControllers[i]->GetTraffic();
+         for(size_t j = 0; j < CNavController::MESSAGE_COUNT; ++j) {
+            sTotal.Sent[j] += sTraffic.Sent[j];
+            sTotal.Records[j] += sTraffic.Records[j];
+         }
+         sTotal.BytesOnAir += sTraffic.BytesOnAir;
+         sTotal.Received += sTraffic.Received;
+         sTotal.OutOfRange += sTraffic.OutOfRange;
+         sTotal.Dropped += sTraffic.Dropped;
+      }
+      m_cTraffic.Write(unTick, 0, sTotal);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+bool CNavLoopFunctions::IsExperimentFinished() {
+   if(HaveAllArrived()) {
+      return true;
+   }
+   /* Without navigators, the run is over once the targets are known everywhere */
+   if(m_vecNavigators.empty() && !m_vecPropagation.empty() && m_bPropagated) {
+      return true;
+   }
+   /* Out of budget: stop here, the time to target is censored at this tick */
+   if(m_unMaxTicks > 0 && GetSpace().GetSimulationClock() >= m_unMaxTicks) {
+      m_bCensored = true;
+   }
+   else if(m_fMaxWallTime > 0.0 &&
+           std::chrono::duration<Real>(std::chrono::steady_clock::now() - m_tStart).count() >= m_fMaxWallTime) {
+      m_bCensored = true;
+   }
+   return m_bCensored;
+}
+
+/****************************************/
+/****************************************/
+
+bool CNavLoopFunctions::HaveAllArrived() const {
+   for(size_t i = 0; i < m_vecNavigatorResults.size(); ++i) {
+      if(!m_vecNavigatorResults[i].Arrived) {
+         return false;
+      }
+   }
+   return !m_vecNavigatorResults.empty();
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::StartNavigators() {
+   m_vecNavigatorResults.clear();
+   for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+      if(m_vecControllers[i]->GetRole() != CNavController::ROLE_NAVIGATOR) continue;
+      SNavigatorResult sResult;
+      sResult.Id = m_vecFootBots[i]->GetId();
+      sResult.Target = m_vecControllers[i]->GetTargetId();
+      sResult.Arrived = false;
+      sResult.Ticks = 0;
+      sResult.PathLength = 0.0;
+      sResult.Hops = 0;
+      m_vecNavigatorResults.push_back(sResult);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::UpdateNavigators() {
+   UInt32 unTick = GetSpace().GetSimulationClock();
+   for(size_t i = 0; i < m_vecNavigators.size(); ++i) {
+      SNavigatorResult& sResult = m_vecNavigatorResults[i];
+      if(sResult.Arrived) continue;
+      /* Still on the way: how far it got, until it arrives */
+      sResult.Arrived = m_vecNavigators[i]->HasArrived();
+      sResult.Ticks = unTick;
+      sResult.PathLength = m_vecNavigators[i]->GetStats().PathLength;
+      sResult.Hops = m_vecNavigators[i]->GetStats().Hops;
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::WriteNavigators() const {
+   bool bNewFile;
+   {
+      std::ifstream cExisting(m_strNavigators.c_str());
+      bNewFile = !cExisting.good() || cExisting.peek() == std::ifstream::traits_type::eof();
+   }
+   std::ofstream cOutput(m_strNavigators.c_str(), std::ios::app);
+   if(!cOutput) {
+      LOGERR << "[nav_loop_functions] Cannot write navigators to \"" << m_strNavigators << "\"" << std::endl;
+      return;
+   }
+   if(bNewFile) {
+      cOutput << "seed,navigator,target,arrived,ticks,path_length,hops" << std::endl;
+   }
+   for(size_t i = 0; i < m_vecNavigatorResults.size(); ++i) {
+      const SNavigatorResult& sResult = m_vecNavigatorResults[i];
+      cOutput << m_sSummary.Seed << ","
+              << sResult.Id << ","
+              << static_cast<UInt32>(sResult.Target) << ","
+              << sResult.Arrived << ","
+              << sResult.Ticks << ","
+              << sResult.PathLength << ","
+              << sResult.Hops << std::endl;
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::StartPropagation() {
+   m_vecPropagation.clear();
+   m_bPropagated = true;
+   if(m_strPropagation.empty()) return;
+   std::set<UInt8> setTargets;
+   for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+      if(m_vecControllers[i]->GetRole() == CNavController::ROLE_TARGET) {
+         setTargets.insert(m_vecControllers[i]->GetTargetId());
+      }
+   }
+   for(std::set<UInt8>::iterator it = setTargets.begin(); it != setTargets.end(); ++it) {
+      SPropagation sPropagation = { *it, -1, -1, -1 };
+      m_vecPropagation.push_back(sPropagation);
+   }
+   m_bPropagated = m_vecPropagation.empty();
+}
+
+/****************************************/
+/****************************************/
+
+bool CNavLoopFunctions::UpdatePropagation() {
+   SInt32 nTick = GetSpace().GetSimulationClock();
+   size_t unRobots = m_vecControllers.size();
+   bool bAll = true;
+   for(size_t i = 0; i < m_vecPropagation.size(); ++i) {
+      SPropagation& sPropagation = m_vecPropagation[i];
+      if(sPropagation.KnownByAll >= 0) continue;
+      size_t unKnown = 0;
+      for(size_t j = 0; j < unRobots; ++j) {
+         unKnown += m_vecControllers[j]->KnowsTarget(sPropagation.Target);
+      }
+      if(sPropagation.KnownByHalf < 0 && 2 * unKnown >= unRobots) {
+         sPropagation.KnownByHalf = nTick;
+      }
+      if(sPropagation.KnownByMost < 0 && 10 * unKnown >= 9 * unRobots) {
+         sPropagation.KnownByMost = nTick;
+      }
+      if(unKnown == unRobots) {
+         sPropagation.KnownByAll = nTick;
+      }
+      else {
+         bAll = false;
+      }
+   }
+   return bAll;
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::WritePropagation() const {
+   bool bNewFile;
+   {
+      std::ifstream cExisting(m_strPropagation.c_str());
+      bNewFile = !cExisting.good() || cExisting.peek() == std::ifstream::traits_type::eof();
+   }
+   std::ofstream cOutput(m_strPropagation.c_str(), std::ios::app);
+   if(!cOutput) {
+      LOGERR << "[nav_loop_functions] Cannot write propagation to \"" << m_strPropagation << "\"" << std::endl;
+      return;
+   }
+   if(bNewFile) {
+      cOutput << "seed,target,robots,known_by_half,known_by_most,known_by_all" << std::endl;
+   }
+   for(size_t i = 0; i < m_vecPropagation.size(); ++i) {
+      const SPropagation& sPropagation = m_vecPropagation[i];
+      cOutput << m_sSummary.Seed << ","
+              << static_cast<UInt32>(sPropagation.Target) << ","
+              << m_vecControllers.size() << ","
+              << sPropagation.KnownByHalf << ","
+              << sPropagation.KnownByMost << ","
+              << sPropagation.KnownByAll << std::endl;
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::PostExperiment() {
+   UpdateNavigators();
+   UpdateSummary();
+   if(!m_strOutput.empty()) {
+      WriteSummary();
+   }
+   if(!m_strNavigators.empty()) {
+      WriteNavigators();
+   }
+   if(!m_vecPropagation.empty()) {
+      WritePropagation();
+   }
+#ifdef NAV_PROFILING
+   if(!m_strProfile.empty()) {
+      WriteProfile();
+   }
+#endif
+   m_cTraffic.Close();
+   m_cTrajectory.Close();
+   CloseTrace();
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::OpenTraffic() {
+   m_cTraffic.Close();
+   if(!m_strTraffic.empty()) {
+      m_cTraffic.Open(m_strTraffic, m_eTrafficFormat, m_bTrafficPerRobot);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::OpenTrajectory() {
+   m_cTrajectory.Close();
+   if(m_strTrajectory.empty()) return;
+   std::vector<std::string> vecIds(m_vecFootBots.size());
+   std::vector<UInt32> vecRoles(m_vecFootBots.size());
+   for(size_t i = 0; i < m_vecFootBots.size(); ++i) {
+      vecIds[i] = m_vecFootBots[i]->GetId();
+      vecRoles[i] = m_vecControllers[i]->GetRole();
+   }
+   m_cTrajectory.Open(m_strTrajectory, vecIds, vecRoles, m_unTrajectoryTarget, m_unTrajectoryKeyframe);
+   m_vecTrajectory.resize(static_cast<size_t>(TRAJECTORY_COLUMNS) * m_vecFootBots.size());
+   RecordTrajectory();
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::RecordTrajectory() {
+   size_t unRobots = m_vecFootBots.size();
+   /* Column c of robot i is at c * unRobots + i */
+   Real* pfValues = m_vecTrajectory.empty() ? NULL : &m_vecTrajectory[0];
+   for(size_t i = 0; i < unRobots; ++i) {
+      const SAnchor& sAnchor = m_vecFootBots[i]->GetEmbodiedEntity().GetOriginAnchor();
+      CRadians cYaw, cPitch, cRoll;
+      sAnchor.Orientation.ToEulerAngles(cYaw, cPitch, cRoll);
+      const CWheeledEntity& cWheels = m_vecFootBots[i]->GetWheeledEntity();
+      CNavController::SNavState sState = m_vecControllers[i]->GetNavState();
+      Real fTargetDistance;
+      if(!m_vecControllers[i]->GetTableDistance(m_unTrajectoryTarget, fTargetDistance)) {
+         fTargetDistance = std::numeric_limits<Real>::quiet_NaN();
+      }
+      pfValues[TRAJECTORY_X * unRobots + i] = sAnchor.Position.GetX();
+      pfValues[TRAJECTORY_Y * unRobots + i] = sAnchor.Position.GetY();
+      pfValues[TRAJECTORY_YAW * unRobots + i] = cYaw.GetValue();
+      /* The wheeled entity holds m/s, the controllers set cm/s */
+      pfValues[TRAJECTORY_LEFT_WHEEL * unRobots + i] = cWheels.GetWheelVelocity(0) * 100.0;
+      pfValues[TRAJECTORY_RIGHT_WHEEL * unRobots + i] = cWheels.GetWheelVelocity(1) * 100.0;
+      pfValues[TRAJECTORY_BEST_NAV_DIST * unRobots + i] = sState.BestNavDist;
+      pfValues[TRAJECTORY_BEST_NAV_HEADING * unRobots + i] = sState.BestNavHeading;
+      pfValues[TRAJECTORY_DISTANCE_STAR * unRobots + i] = sState.DistanceStar;
+      pfValues[TRAJECTORY_TARGET_DISTANCE * unRobots + i] = fTargetDistance;
+   }
+   m_cTrajectory.Write(GetSpace().GetSimulationClock(), pfValues);
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::OpenTrace() {
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+   CloseTrace();
+   for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+      m_vecControllers[i]->GetTrace().SetCapacity(m_unTraceCapacity);
+   }
+   if(m_strTrace.empty()) return;
+   m_pcTraceFile = std::fopen(m_strTrace.c_str(), "wb");
+   if(m_pcTraceFile == NULL) {
+      THROW_ARGOSEXCEPTION("[nav_loop_functions] Cannot open trace file \"" << m_strTrace << "\": " << ::strerror(errno));
+   }
+   /* Header: magic, number of robots, then their ids */
+   std::vector<char> vecHeader(TRACE_MAGIC, TRACE_MAGIC + 8);
+   AppendUInt32(vecHeader, m_vecFootBots.size());
+   for(size_t i = 0; i < m_vecFootBots.size(); ++i) {
+      const std::string& strId = m_vecFootBots[i]->GetId();
+      AppendUInt32(vecHeader, strId.size());
+      vecHeader.insert(vecHeader.end(), strId.begin(), strId.end());
+   }
+   WriteTrace(&vecHeader[0], vecHeader.size());
+#endif
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::DrainTraces(bool b_all) {
+#if NAV_TRACE_LEVEL > NAV_TRACE_LEVEL_OFF
+   if(m_pcTraceFile == NULL) return;
+   for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+      CNavTrace& cTrace = m_vecControllers[i]->GetTrace();
+      UInt64 unPending = cTrace.GetPending();
+      if(unPending == 0 || (!b_all && unPending < cTrace.GetCapacity() / 2)) continue;
+      /* Chunk: robot index, events lost, event count, events */
+      m_vecTraceChunk.clear();
+      UInt64 unLost = cTrace.Drain([this](const SNavTraceEvent* ps_events, size_t un_count) {
+         m_vecTraceChunk.insert(m_vecTraceChunk.end(), ps_events, ps_events + un_count);
+      });
+      UInt32 punHeader[3] = {
+         static_cast<UInt32>(i),
+         static_cast<UInt32>(unLost),
+         static_cast<UInt32>(m_vecTraceChunk.size())
+      };
+      WriteTrace(punHeader, sizeof(punHeader));
+      WriteTrace(&m_vecTraceChunk[0], m_vecTraceChunk.size() * sizeof(SNavTraceEvent));
+   }
+#endif
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::CloseTrace() {
+   if(m_pcTraceFile == NULL) return;
+   DrainTraces(true);
+   bool bOk = (std::fclose(m_pcTraceFile) == 0);
+   m_pcTraceFile = NULL;
+   if(!bOk) {
+      THROW_ARGOSEXCEPTION("[nav_loop_functions] Cannot write trace file \"" << m_strTrace << "\": " << ::strerror(errno));
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::WriteTrace(const void* pv_data,
+                                   size_t un_size) {
+   if(std::fwrite(pv_data, 1, un_size, m_pcTraceFile) != un_size) {
+      THROW_ARGOSEXCEPTION("[nav_loop_functions] Cannot write trace file \"" << m_strTrace << "\": " << ::strerror(errno));
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::CollectControllers() {
+   m_vecFootBots.clear();
+   m_vecControllers.clear();
+   m_vecNavigators.clear();
+   CSpace::TMapPerType& tFootBots = GetSpace().GetEntitiesByType("foot-bot");
+   for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+       it != tFootBots.end();
+       ++it) {
+      CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+      CNavController* pcController =
+         dynamic_cast<CNavController*>(&cFootBot.GetControllableEntity().GetController());
+      if(pcController == NULL) continue;
+      m_vecFootBots.push_back(&cFootBot);
+      m_vecControllers.push_back(pcController);
+      if(pcController->GetRole() == CNavController::ROLE_NAVIGATOR) {
+         m_vecNavigators.push_back(pcController);
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::ApplyCommRanges() {
+   for(size_t i = 0; i < m_vecFootBots.size(); ++i) {
+      CRABEquippedEntity& cRAB = m_vecFootBots[i]->GetRABEquippedEntity();
+      /* comm_range is in cm, the RAB range in m; never extend the physical range */
+      Real fRange = m_vecControllers[i]->GetCommRange() / 100.0;
+      if(fRange < cRAB.GetRange()) {
+         cRAB.SetRange(fRange);
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::Snapshot(CByteArray& c_snapshot) {
+   c_snapshot << GetSpace().GetSimulationClock()
+              << static_cast<UInt32>(m_vecFootBots.size());
+   for(size_t i = 0; i < m_vecFootBots.size(); ++i) {
+      const SAnchor& sAnchor = m_vecFootBots[i]->GetEmbodiedEntity().GetOriginAnchor();
+      c_snapshot << m_vecFootBots[i]->GetId()
+                 << sAnchor.Position.GetX()
+                 << sAnchor.Position.GetY()
+                 << sAnchor.Position.GetZ()
+                 << sAnchor.Orientation.GetW()
+                 << sAnchor.Orientation.GetX()
+                 << sAnchor.Orientation.GetY()
+                 << sAnchor.Orientation.GetZ();
+      m_vecControllers[i]->SaveState(c_snapshot);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::Restore(CByteArray& c_snapshot) {
+   UInt32 unClock, unRobots;
+   c_snapshot >> unClock >> unRobots;
+   if(unRobots != m_vecFootBots.size()) {
+      THROW_ARGOSEXCEPTION("The snapshot has " << unRobots << " robots, the experiment " << m_vecFootBots.size());
+   }
+   /* Robots come in the same order, as they are listed by id */
+   for(size_t i = 0; i < m_vecFootBots.size(); ++i) {
+      std::string strId;
+      Real fX, fY, fZ, fQW, fQX, fQY, fQZ;
+      c_snapshot >> strId >> fX >> fY >> fZ >> fQW >> fQX >> fQY >> fQZ;
+      if(strId != m_vecFootBots[i]->GetId()) {
+         THROW_ARGOSEXCEPTION("The snapshot has robot \"" << strId << "\" where the experiment has \"" << m_vecFootBots[i]->GetId() << "\"");
+      }
+      /* The other robots are still where the new run put them, ignore collisions */
+      m_vecFootBots[i]->GetEmbodiedEntity().MoveTo(CVector3(fX, fY, fZ),
+                                                   CQuaternion(fQW, fQX, fQY, fQZ),
+                                                   false,
+                                                   true);
+      m_vecControllers[i]->LoadState(c_snapshot);
+   }
+   GetSpace().SetSimulationClock(unClock);
+   /* Navigators that arrived before the snapshot count as arrived at its tick */
+   StartNavigators();
+   UpdateNavigators();
+   UpdateSummary();
+   /* The trajectory starts at the snapshot */
+   OpenTrajectory();
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::UpdateSummary() {
+   m_sSummary.Seed = CSimulator::GetInstance().GetRandomSeed();
+   m_sSummary.Ticks = GetSpace().GetSimulationClock();
+   m_sSummary.Found = HaveAllArrived();
+   m_sSummary.Censored = !m_sSummary.Found && m_bCensored;
+   m_sSummary.PathLength = 0.0;
+   m_sSummary.Messages = 0;
+   m_sSummary.Hops = 0;
+   m_sSummary.Robots = m_vecControllers.size();
+   for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+      m_sSummary.Messages += m_vecControllers[i]->GetStats().MessagesSent;
+   }
+   m_sSummary.MessagesPerTick = (m_sSummary.Ticks > 0) ?
+      static_cast<Real>(m_sSummary.Messages) / m_sSummary.Ticks : 0.0;
+   m_sSummary.Navigators = m_vecNavigators.size();
+   m_sSummary.Arrived = 0;
+   for(size_t i = 0; i < m_vecNavigators.size(); ++i) {
+      m_sSummary.PathLength += m_vecNavigators[i]->GetStats().PathLength;
+      m_sSummary.Hops += m_vecNavigators[i]->GetStats().Hops;
+      m_sSummary.Arrived += m_vecNavigatorResults[i].Arrived;
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::WriteSummary() const {
+   /* Write the header only when starting a new file */
+   bool bNewFile;
+   {
+      std::ifstream cExisting(m_strOutput.c_str());
+      bNewFile = !cExisting.good() || cExisting.peek() == std::ifstream::traits_type::eof();
+   }
+   std::ofstream cOutput(m_strOutput.c_str(), std::ios::app);
+   if(!cOutput) {
+      LOGERR << "[nav_loop_functions] Cannot write summary to \"" << m_strOutput << "\"" << std::endl;
+      return;
+   }
+   if(bNewFile) {
+      cOutput << "seed,ticks,found,censored,path_length,messages,messages_per_tick,hops,robots,navigators,arrived" << std::endl;
+   }
+   cOutput << m_sSummary.Seed << ","
+           << m_sSummary.Ticks << ","
+           << m_sSummary.Found << ","
+           << m_sSummary.Censored << ","
+           << m_sSummary.PathLength << ","
+           << m_sSummary.Messages << ","
+           << m_sSummary.MessagesPerTick << ","
+           << m_sSummary.Hops << ","
+           << m_sSummary.Robots << ","
+           << m_sSummary.Navigators << ","
+           << m_sSummary.Arrived << std::endl;
+}
+
+/****************************************/
+/****************************************/
+
+void CNavLoopFunctions::WriteProfile() const {
+#ifdef NAV_PROFILING
+   CNavProfile cProfile;
+   for(size_t i = 0; i < m_vecControllers.size(); ++i) {
+      cProfile.Merge(m_vecControllers[i]->GetProfile());
+   }
+   UInt64 unTotal = 0;
+   for(UInt32 i = 0; i < NAV_PHASE_COUNT; ++i) {
+      unTotal += cProfile.GetPhase(i).Cycles;
+   }
+   LOG << "[nav_loop_functions] Control step profile of " << m_vecControllers.size() << " robots:" << std::endl;
+   for(UInt32 i = 0; i < NAV_PHASE_COUNT; ++i) {
+      const CNavProfile::SPhase& sPhase = cProfile.GetPhase(i);
+      if(sPhase.Calls == 0) continue;
+      LOG << "   " << CNavProfile::GetPhaseName(i)
+          << ": " << sPhase.Calls << " calls, "
+          << static_cast<Real>(sPhase.Cycles) / sPhase.Calls << " cycles per call ["
+          << sPhase.Min << ", " << sPhase.Max << "], "
+          << 100.0 * sPhase.Cycles / unTotal << "% of the control step" << std::endl;
+   }
+   std::ofstream cOutput(m_strProfile.c_str());
+   if(!cOutput) {
+      LOGERR << "[nav_loop_functions] Cannot write profile to \"" << m_strProfile << "\"" << std::endl;
+      return;
+   }
+   cProfile.WriteHistograms(cOutput);
+#endif
+}
+
+/****************************************/
+/****************************************/
+
+REGISTER_LOOP_FUNCTIONS(CNavLoopFunctions, "nav_loop_functions")
@@ -0,0 +1,342 @@
+/*
+ * Headless loop functions for the navigation experiments.
+ *
+ * These loop functions decide when a run is over: the experiment ends as
+ * soon as every navigator reports that it reached its target, or when the
+ * run exceeds its tick or wall-clock budget. A run stopped by a budget
+ * is right-censored: its time to target is only known to be longer
+ * than the ticks it ran for, and it is flagged as such in the summary
+ * instead of being dropped. At the end of
+ * the run a one-line summary (ticks, navigator path length, messages,
+ * messages per tick and hops) is appended to a CSV file, so results no longer have to be
+ * scraped from the LOG output.
+ *
+ * A run may have many navigators, each heading to its own target: those
+ * that arrive park and the others go on. The tick each of them arrived
+ * at, with its path length and hops at that tick, can be appended to a
+ * CSV file of its own, one row per navigator, so that one simulated swarm
+ * gives many samples; the navigators still on their way when the run
+ * ends are censored at its last tick.
+ *
+ * They do not draw anything, so they can be used together with the
+ * id_qtuser_functions of the <visualization> section.
+ *
+ * The range-and-bearing medium delivers every packet within the
+ * physical range of the sender's RAB device, and the controllers used to
+ * throw away the ones from beyond their comm_range after copying them.
+ * The loop functions instead shrink the RAB range of every foot-bot to
+ * the comm_range of its controller, so that the medium, which looks up
+ * the receivers in its positional index (index and grid_size attributes
+ * of <range_and_bearing> in <media>), does not deliver them at all. The
+ * medium uses the range of the sender, the controller filter that of
+ * the receiver: they only differ if robots have different comm_range,
+ * in which case the controller filter still applies.
+ *
+ * When the controllers are built with a NAV_TRACE_LEVEL (see
+ * nav_trace.h), the loop functions drain the trace rings of the robots
+ * into a binary file between steps, as soon as a ring is half full and
+ * at the end of the run. The file starts with the 8 bytes "NAVTRAC1",
+ * the number of robots and, for each robot in id order, the length of
+ * its id and the id; then come chunks of the events of one robot: its
+ * index, the number of events lost since the last chunk because its
+ * ring was full, the number of events and the events, 16 bytes each
+ * (SNavTraceEvent). All integers are 32 bits in the byte order of the
+ * machine. nav_trace_decode turns the file into CSV.
+ *
+ * With several targets, the loop functions can record how fast the nav
+ * protocol spreads each of them: for every target id advertised by a
+ * target robot, the first tick at which half, 90% and all of the robots
+ * have it in their nav table, -1 if the run ended before. A run without
+ * navigators that records this ends as soon as every target is known to
+ * every robot.
+ *
+ * The loop functions can also record the trajectory of every robot: its
+ * pose, wheel speeds and nav state (see CNavController::SNavState, and
+ * the distance to one target in its nav table) on every tick, in the
+ * compact binary format of trajectory_format.h. tools/trajectory_reader.h
+ * maps such a file for random access and scans, and nav_trajectory_decode
+ * turns it into CSV, so archived runs can be analysed without simulating
+ * them again.
+ *
+ * A running experiment can be snapshotted (clock, foot-bot poses and
+ * navigation state of every controller) and restored into a fresh
+ * simulation of the same experiment, so that many trials can branch
+ * from one warmed-up swarm (see the -W option of the trial runner).
+ *
+ * Configuration:
+ *
+ *    <loop_functions library="build/loop_functions/nav_loop_functions/libnav_loop_functions"
+ *                    label="nav_loop_functions"
+ *                    output="nav_summary.csv"
+ *                    max_ticks="20000"
+ *                    max_wall_time="600"
+ *                    profile="nav_profile.csv"
+ *                    trace="nav_trace.bin"
+ *                    trace_capacity="1024"
+ *                    traffic="nav_traffic.csv"
+ *                    traffic_format="csv"
+ *                    traffic_per_robot="false"
+ *                    propagation="nav_propagation.csv"
+ *                    navigators="nav_navigators.csv"
+ *                    trajectory="nav_trajectory.bin"
+ *                    trajectory_keyframe="64"
+ *                    trajectory_target="0"
+ *                    medium_range="true" />
+ *
+ *    output         file the run summary is appended to (empty to disable)
+ *    max_ticks      ticks after which the run is stopped and censored
+ *                   (default 0, no limit)
+ *    max_wall_time  seconds of wall-clock time after which the run is
+ *                   stopped and censored (default 0, no limit); it
+ *                   depends on the machine and its load, so it is a
+ *                   safety net on top of max_ticks, not a replacement
+ *    profile        file the control step profile of all the robots is
+ *                   written to, when the controllers are built with
+ *                   NAV_PROFILING (default nav_profile.csv, empty to
+ *                   disable; see nav_profiler.h)
+ *    trace          file the trace of all the robots is written to,
+ *                   when the controllers are built with a NAV_TRACE_LEVEL
+ *                   (default nav_trace.bin, empty to disable)
+ *    trace_capacity events the ring of every robot holds (default 1024)
+ *    traffic        file the radio traffic of every tick is written to
+ *                   (default empty, disabled; see traffic_recorder.h)
+ *    traffic_format      csv or binary (default csv)
+ *    traffic_per_robot   one row per robot and tick instead of the
+ *                        totals of every tick (default false)
+ *    propagation    file the propagation delay of every target is
+ *                   appended to at the end of the run (default empty,
+ *                   disabled)
+ *    navigators     file the outcome of every navigator is appended to
+ *                   at the end of the run (default empty, disabled)
+ *    trajectory     file the trajectory of the robots is written to
+ *                   (default empty, disabled)
+ *    trajectory_keyframe  frames between two keyframes of the trajectory
+ *                         (default 64); fewer make random access faster
+ *                         and the file bigger
+ *    trajectory_target    target whose distance in the nav tables is
+ *                         recorded (default 0)
+ *    medium_range   whether the RAB range of the foot-bots is cut to
+ *                   the comm_range of their controllers (default true)
+ */
+
+#ifndef NAV_LOOP_FUNCTIONS_H
+#define NAV_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
+#include <controllers/nav_common/nav_controller.h>
+#include "traffic_recorder.h"
+#include "trajectory_recorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace argos {
+   class CFootBotEntity;
+}
+
+using namespace argos;
+
+class CNavLoopFunctions : public CLoopFunctions {
+
+public:
+
+   /* Summary of a run */
+   struct SSummary {
+      /* Random seed of the run */
+      UInt32 Seed;
+      /* Simulation clock at the end of the run */
+      UInt32 Ticks;
+      /* Whether every navigator reached its target */
+      bool Found;
+      /* Whether the run was stopped by its tick or wall-clock budget */
+      bool Censored;
+      /* Distance covered by the navigators, in cm */
+      Real PathLength;
+      /* Messages sent by all the robots */
+      UInt32 Messages;
+      /* Messages sent by all the robots, per tick */
+      Real MessagesPerTick;
+      /* Nav points the navigators went through */
+      UInt32 Hops;
+      /* Number of robots running a navigation controller */
+      UInt32 Robots;
+      /* Number of navigators, and of those that reached their target */
+      UInt32 Navigators;
+      UInt32 Arrived;
+   };
+
+   /* Outcome of a navigator */
+   struct SNavigatorResult {
+      /* Id of the robot */
+      std::string Id;
+      /* Target it heads to */
+      UInt8 Target;
+      /* Whether it reached its target */
+      bool Arrived;
+      /* Simulation clock when it arrived, or when the run ended */
+      UInt32 Ticks;
+      /* Distance it covered, in cm, and nav points it went through, until then */
+      Real PathLength;
+      UInt32 Hops;
+   };
+
+   /* How far the nav info of a target has spread */
+   struct SPropagation {
+      UInt8 Target;
+      /* First tick at which half, 90% and all of the robots knew the target, -1 if not yet */
+      SInt32 KnownByHalf;
+      SInt32 KnownByMost;
+      SInt32 KnownByAll;
+   };
+
+public:
+
+   CNavLoopFunctions();
+
+   virtual ~CNavLoopFunctions() {}
+
+   virtual void Init(TConfigurationNode& t_tree);
+
+   virtual void Reset();
+
+   virtual void Destroy();
+
+   virtual void PostStep();
+
+   virtual bool IsExperimentFinished();
+
+   virtual void PostExperiment();
+
+   /* Returns the summary of the last finished run */
+   inline const SSummary& GetSummary() const {
+      return m_sSummary;
+   }
+
+   /* Returns the outcome of every navigator, in id order */
+   inline const std::vector<SNavigatorResult>& GetNavigatorResults() const {
+      return m_vecNavigatorResults;
+   }
+
+   /* Returns the navigation controllers of all the foot-bots, in id order */
+   inline const std::vector<CNavController*>& GetControllers() const {
+      return m_vecControllers;
+   }
+
+   /* Appends the state of the run to c_snapshot */
+   void Snapshot(CByteArray& c_snapshot);
+
+   /*
+    * Restores a snapshot of the same experiment, robots matched by id.
+    * The random number generators are left alone, so a run restored
+    * with another seed branches from the snapshot.
+    */
+   void Restore(CByteArray& c_snapshot);
+
+   /* Sets the file the summary is appended to (empty to disable) */
+   inline void SetOutput(const std::string& str_output) {
+      m_strOutput = str_output;
+   }
+
+private:
+
+   /* Whether there are navigators and all of them reached their target */
+   bool HaveAllArrived() const;
+
+   /* Starts the outcome of the navigators over */
+   void StartNavigators();
+
+   /* Records the navigators that arrived on this tick, and how far the others got */
+   void UpdateNavigators();
+
+   /* Appends the outcome of the navigators to their file */
+   void WriteNavigators() const;
+
+   /* Opens the trajectory file, if any, and records the current tick */
+   void OpenTrajectory();
+
+   /* Records the current tick in the trajectory file */
+   void RecordTrajectory();
+
+   /* Lists the targets to follow the propagation of, if any */
+   void StartPropagation();
+
+   /* Records the targets that reached more robots on this tick; returns true once all reached all */
+   bool UpdatePropagation();
+
+   /* Appends the propagation delays to their file */
+   void WritePropagation() const;
+
+   /* Finds the navigation controllers of all the foot-bots */
+   void CollectControllers();
+
+   /* Cuts the RAB range of the foot-bots to the comm_range of their controllers */
+   void ApplyCommRanges();
+
+   /* Fills m_sSummary from the current state of the robots */
+   void UpdateSummary();
+
+   /* Appends m_sSummary to the output file */
+   void WriteSummary() const;
+
+   /* Opens the traffic file, if any */
+   void OpenTraffic();
+
+   /* Logs and writes the control step profile of all the robots */
+   void WriteProfile() const;
+
+   /* Opens the trace file, if any, and writes its header */
+   void OpenTrace();
+
+   /* Writes the trace rings to the file, only those half full unless b_all */
+   void DrainTraces(bool b_all);
+
+   /* Drains all the rings and closes the trace file */
+   void CloseTrace();
+
+   void WriteTrace(const void* pv_data,
+                   size_t un_size);
+
+private:
+
+   std::vector<CFootBotEntity*> m_vecFootBots;
+   /* Controller of each entry of m_vecFootBots */
+   std::vector<CNavController*> m_vecControllers;
+   std::vector<CNavController*> m_vecNavigators;
+   /* Outcome of each entry of m_vecNavigators */
+   std::vector<SNavigatorResult> m_vecNavigatorResults;
+   std::string m_strNavigators;
+   std::string m_strOutput;
+   std::string m_strProfile;
+   std::string m_strTrace;
+   UInt32 m_unTraceCapacity;
+   std::FILE* m_pcTraceFile;
+   /* Events of the chunk being written */
+   std::vector<SNavTraceEvent> m_vecTraceChunk;
+   std::string m_strTraffic;
+   CTrafficRecorder::EFormat m_eTrafficFormat;
+   bool m_bTrafficPerRobot;
+   bool m_bMediumRange;
+   CTrafficRecorder m_cTraffic;
+   std::string m_strTrajectory;
+   UInt32 m_unTrajectoryKeyframe;
+   UInt8 m_unTrajectoryTarget;
+   CTrajectoryRecorder m_cTrajectory;
+   /* Values of the tick being recorded, column by column */
+   std::vector<Real> m_vecTrajectory;
+   std::string m_strPropagation;
+   std::vector<SPropagation> m_vecPropagation;
+   /* Whether every target is known to every robot */
+   bool m_bPropagated;
+   UInt32 m_unMaxTicks;
+   Real m_fMaxWallTime;
+   /* Wall-clock time the run started at */
+   std::chrono::steady_clock::time_point m_tStart;
+   bool m_bCensored;
+   SSummary m_sSummary;
+
+};
+
+#endif
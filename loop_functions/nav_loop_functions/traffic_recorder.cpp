@@ -0,0 +1,143 @@
+#include "traffic_recorder.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+/* Size of the write buffer */
+static const size_t BUFFER_SIZE = 1 << 20;
+
+/* Longest row: 12 fields of up to 10 digits and a separator */
+static const size_t MAX_ROW_SIZE = 12 * 11;
+
+/* Magic string at the start of binary files */
+static const char BINARY_MAGIC[] = "NAVTRAF1";
+
+/****************************************/
+/****************************************/
+
+CTrafficRecorder::CTrafficRecorder() :
+   m_pcFile(NULL),
+   m_eFormat(FORMAT_CSV),
+   m_bPerRobot(false),
+   m_unUsed(0) {}
+
+/****************************************/
+/****************************************/
+
+CTrafficRecorder::~CTrafficRecorder() {
+   if(m_pcFile != NULL) {
+      /* Don't throw from a destructor, whatever is buffered is lost on error */
+      std::fwrite(&m_vecBuffer[0], 1, m_unUsed, m_pcFile);
+      std::fclose(m_pcFile);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrafficRecorder::Open(const std::string& str_path,
+                            EFormat e_format,
+                            bool b_per_robot) {
+   Close();
+   m_pcFile = std::fopen(str_path.c_str(), "wb");
+   if(m_pcFile == NULL) {
+      THROW_ARGOSEXCEPTION("Cannot open traffic file \"" << str_path << "\": " << ::strerror(errno));
+   }
+   m_strPath = str_path;
+   m_eFormat = e_format;
+   m_bPerRobot = b_per_robot;
+   m_vecBuffer.resize(BUFFER_SIZE);
+   m_unUsed = 0;
+   if(m_eFormat == FORMAT_CSV) {
+      std::string strHeader = m_bPerRobot ? "tick,robot," : "tick,";
+      strHeader += "sent_nav_info,sent_request,sent_reply,bytes_on_air,"
+                   "received,out_of_range,dropped,"
+                   "records_nav_info,records_request,records_reply\n";
+      std::memcpy(&m_vecBuffer[0], strHeader.data(), strHeader.size());
+      m_unUsed = strHeader.size();
+   }
+   else {
+      UInt32 unFields = m_bPerRobot ? 12 : 11;
+      std::memcpy(&m_vecBuffer[0], BINARY_MAGIC, 8);
+      std::memcpy(&m_vecBuffer[8], &unFields, sizeof(unFields));
+      m_unUsed = 8 + sizeof(unFields);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrafficRecorder::Close() {
+   if(m_pcFile == NULL) return;
+   Flush();
+   bool bOk = (std::fclose(m_pcFile) == 0);
+   m_pcFile = NULL;
+   if(!bOk) {
+      THROW_ARGOSEXCEPTION("Cannot write traffic file \"" << m_strPath << "\": " << ::strerror(errno));
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrafficRecorder::Write(UInt32 un_tick,
+                             UInt32 un_robot,
+                             const CNavController::STraffic& s_traffic) {
+   if(m_vecBuffer.size() - m_unUsed < MAX_ROW_SIZE) {
+      Flush();
+   }
+   Append(un_tick, false);
+   if(m_bPerRobot) {
+      Append(un_robot, false);
+   }
+   for(size_t i = 0; i < CNavController::MESSAGE_COUNT; ++i) {
+      Append(s_traffic.Sent[i], false);
+   }
+   Append(s_traffic.BytesOnAir, false);
+   Append(s_traffic.Received, false);
+   Append(s_traffic.OutOfRange, false);
+   Append(s_traffic.Dropped, false);
+   for(size_t i = 0; i < CNavController::MESSAGE_COUNT; ++i) {
+      Append(s_traffic.Records[i], i + 1 == CNavController::MESSAGE_COUNT);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+CTrafficRecorder::EFormat CTrafficRecorder::ParseFormat(const std::string& str_format) {
+   if(str_format == "csv") return FORMAT_CSV;
+   if(str_format == "binary") return FORMAT_BINARY;
+   THROW_ARGOSEXCEPTION("Unknown traffic format \"" << str_format << "\", use \"csv\" or \"binary\"");
+}
+
+/****************************************/
+/****************************************/
+
+void CTrafficRecorder::Flush() {
+   if(m_unUsed == 0) return;
+   size_t unSize = m_unUsed;
+   m_unUsed = 0;
+   if(std::fwrite(&m_vecBuffer[0], 1, unSize, m_pcFile) != unSize) {
+      THROW_ARGOSEXCEPTION("Cannot write traffic file \"" << m_strPath << "\": " << ::strerror(errno));
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrafficRecorder::Append(UInt32 un_value,
+                              bool b_last) {
+   if(m_eFormat == FORMAT_CSV) {
+      char* pchEnd = std::to_chars(&m_vecBuffer[m_unUsed], &m_vecBuffer[0] + m_vecBuffer.size(), un_value).ptr;
+      *pchEnd = b_last ? '\n' : ',';
+      m_unUsed = pchEnd + 1 - &m_vecBuffer[0];
+   }
+   else {
+      std::memcpy(&m_vecBuffer[m_unUsed], &un_value, sizeof(un_value));
+      m_unUsed += sizeof(un_value);
+   }
+}
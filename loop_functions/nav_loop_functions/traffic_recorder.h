@@ -0,0 +1,99 @@
+/*
+ * Buffered writer of the radio traffic of the navigation controllers.
+ *
+ * One row is written per tick, or per robot and tick, with the traffic
+ * counters of the controllers (see CNavController::STraffic):
+ *
+ *    tick, [robot,] sent_nav_info, sent_request, sent_reply, bytes_on_air,
+ *    received, out_of_range, dropped, records_nav_info, records_request,
+ *    records_reply
+ *
+ * robot is the index of the robot in id order. Rows are formatted into
+ * a large buffer that goes to the file in one write when full, so that
+ * recording every robot on every tick costs little more than the
+ * counting itself.
+ *
+ * Two formats are available:
+ *
+ *    csv     a header line with the field names, then one line per row
+ *    binary  the 8 bytes "NAVTRAF1", the number of fields per row as a
+ *            32 bit integer, then the rows as 32 bit unsigned integers,
+ *            all in the byte order of the machine (little endian on x86
+ *            and ARM); e.g. with numpy:
+ *            numpy.fromfile(f, dtype="<u4", offset=12).reshape(-1, fields)
+ *
+ * Binary rows are fixed width: they are cheaper to write and load
+ * without parsing, but per-robot counts are small numbers, so the CSV
+ * file is usually the smaller one (see traffic_recorder_benchmark).
+ */
+
+#ifndef TRAFFIC_RECORDER_H
+#define TRAFFIC_RECORDER_H
+
+#include <controllers/nav_common/nav_controller.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CTrafficRecorder {
+
+public:
+
+   enum EFormat {
+      FORMAT_CSV,
+      FORMAT_BINARY
+   };
+
+public:
+
+   CTrafficRecorder();
+
+   ~CTrafficRecorder();
+
+   /*
+    * Creates the file and writes its header. With b_per_robot, rows carry
+    * a robot index.
+    */
+   void Open(const std::string& str_path,
+             EFormat e_format,
+             bool b_per_robot);
+
+   /* Writes the buffered rows and closes the file */
+   void Close();
+
+   inline bool IsOpen() const {
+      return m_pcFile != NULL;
+   }
+
+   /* Appends a row; un_robot is ignored unless the rows are per robot */
+   void Write(UInt32 un_tick,
+              UInt32 un_robot,
+              const CNavController::STraffic& s_traffic);
+
+   /* Parses the name of a format, "csv" or "binary" */
+   static EFormat ParseFormat(const std::string& str_format);
+
+private:
+
+   /* Writes the buffer to the file */
+   void Flush();
+
+   /* Appends a field to the buffer, as text or binary */
+   void Append(UInt32 un_value,
+               bool b_last);
+
+private:
+
+   std::FILE* m_pcFile;
+   std::string m_strPath;
+   EFormat m_eFormat;
+   bool m_bPerRobot;
+   std::vector<char> m_vecBuffer;
+   size_t m_unUsed;
+
+};
+
+#endif
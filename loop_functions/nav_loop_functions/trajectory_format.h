@@ -0,0 +1,194 @@
+/*
+ * File format of the trajectories written by CTrajectoryRecorder and
+ * read by CTrajectoryReader (tools/trajectory_reader.h).
+ *
+ * A trajectory holds, for every recorded tick and every robot, the
+ * columns of ETrajectoryColumn. Every value is quantised to an integer
+ * (see GetTrajectoryScale()) and stored as the difference with the value
+ * of the same robot in the previous frame, zigzag-encoded as a varint:
+ * robots move a few mm per tick, so most values take one byte. Every
+ * keyframe_interval-th frame is a keyframe, whose differences are taken
+ * with 0, so that any frame can be decoded from the keyframe before it.
+ *
+ *    header    the 8 bytes "NAVTRAJ1", then the number of columns, of
+ *              robots, the keyframe interval and the target whose table
+ *              distance is recorded; then, for each robot in id order,
+ *              its role, the length of its id and the id
+ *    frames    the tick, the size of the values, and for each column the
+ *              offset its values end at, relative to the start of the
+ *              values; then the values, column by column, robot by robot
+ *    index     for each frame, its tick and the offset of the frame in
+ *              the file (64 bits)
+ *    footer    the offset of the index and the number of frames (64 bits
+ *              each), then the 8 bytes "NAVTRAJX"
+ *
+ * Integers are 32 bits unless stated, in the byte order of the machine.
+ * The index and footer are written when the recorder is closed; a file
+ * without them (a run that crashed) is still read, by walking the frames
+ * up to the first incomplete one.
+ */
+
+#ifndef TRAJECTORY_FORMAT_H
+#define TRAJECTORY_FORMAT_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace argos;
+
+/* Recorded values of a robot */
+enum ETrajectoryColumn {
+   /* Position of the robot, in m */
+   TRAJECTORY_X = 0,
+   TRAJECTORY_Y,
+   /* Rotation of the robot around Z, in rad, in [-pi,pi) */
+   TRAJECTORY_YAW,
+   /* Speed of the wheels, in cm/s */
+   TRAJECTORY_LEFT_WHEEL,
+   TRAJECTORY_RIGHT_WHEEL,
+   /* Nav state of the controller (see CNavController::SNavState) */
+   TRAJECTORY_BEST_NAV_DIST,
+   TRAJECTORY_BEST_NAV_HEADING,
+   TRAJECTORY_DISTANCE_STAR,
+   /* Distance to the recorded target in the nav table, in cm, NaN if the robot has no entry */
+   TRAJECTORY_TARGET_DISTANCE,
+   TRAJECTORY_COLUMNS
+};
+
+/* Magic strings at the start and at the end of the file */
+static const char TRAJECTORY_MAGIC[] = "NAVTRAJ1";
+static const char TRAJECTORY_END_MAGIC[] = "NAVTRAJX";
+
+/* Size of the footer */
+static const size_t TRAJECTORY_FOOTER_SIZE = 24;
+
+/* Quantised value of a missing or non-finite value */
+static const SInt64 TRAJECTORY_NONE = -(static_cast<SInt64>(1) << 40);
+
+/* Steps of the yaw in a turn; the yaw wraps around */
+static const SInt64 TRAJECTORY_YAW_STEPS = 65536;
+
+/****************************************/
+/****************************************/
+
+inline const char* GetTrajectoryColumnName(UInt32 un_column) {
+   static const char* ppchNames[TRAJECTORY_COLUMNS] = {
+      "x", "y", "yaw", "left_wheel", "right_wheel",
+      "best_nav_dist", "best_nav_heading", "distance_star", "target_distance"
+   };
+   return (un_column < TRAJECTORY_COLUMNS) ? ppchNames[un_column] : "unknown";
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Returns the steps per unit of a column: 0.1 mm for the position,
+ * 1/65536 of a turn for the yaw, 0.01 cm/s for the wheels, 0.1 cm for
+ * the distances and 0.1 mrad for the heading.
+ */
+inline Real GetTrajectoryScale(UInt32 un_column) {
+   static const Real pfScales[TRAJECTORY_COLUMNS] = {
+      1e4, 1e4, TRAJECTORY_YAW_STEPS / 6.283185307179586, 100.0, 100.0,
+      10.0, 1e4, 10.0, 10.0
+   };
+   return pfScales[un_column];
+}
+
+/****************************************/
+/****************************************/
+
+inline SInt64 QuantiseTrajectory(UInt32 un_column,
+                                 Real f_value) {
+   /* Beyond the limit, the value could not be told from TRAJECTORY_NONE */
+   static const Real fLimit = static_cast<Real>(-TRAJECTORY_NONE - 1);
+   /* The yaw wraps around, it has no room for TRAJECTORY_NONE */
+   if(!std::isfinite(f_value)) return (un_column == TRAJECTORY_YAW) ? 0 : TRAJECTORY_NONE;
+   Real fSteps = std::round(f_value * GetTrajectoryScale(un_column));
+   if(un_column == TRAJECTORY_YAW) {
+      SInt64 nSteps = static_cast<SInt64>(std::fmod(fSteps, static_cast<Real>(TRAJECTORY_YAW_STEPS)));
+      return (nSteps < 0) ? nSteps + TRAJECTORY_YAW_STEPS : nSteps;
+   }
+   if(fSteps > fLimit) fSteps = fLimit;
+   if(fSteps < -fLimit) fSteps = -fLimit;
+   return static_cast<SInt64>(fSteps);
+}
+
+/****************************************/
+/****************************************/
+
+inline Real DequantiseTrajectory(UInt32 un_column,
+                                 SInt64 n_steps) {
+   if(n_steps == TRAJECTORY_NONE) return std::numeric_limits<Real>::quiet_NaN();
+   if(un_column == TRAJECTORY_YAW && n_steps >= TRAJECTORY_YAW_STEPS / 2) {
+      n_steps -= TRAJECTORY_YAW_STEPS;
+   }
+   return n_steps / GetTrajectoryScale(un_column);
+}
+
+/****************************************/
+/****************************************/
+
+/* Difference stored for a value, the yaw taking the short way around */
+inline SInt64 GetTrajectoryDelta(UInt32 un_column,
+                                 SInt64 n_value,
+                                 SInt64 n_previous) {
+   SInt64 nDelta = n_value - n_previous;
+   if(un_column == TRAJECTORY_YAW) {
+      nDelta &= TRAJECTORY_YAW_STEPS - 1;
+      if(nDelta >= TRAJECTORY_YAW_STEPS / 2) nDelta -= TRAJECTORY_YAW_STEPS;
+   }
+   return nDelta;
+}
+
+/****************************************/
+/****************************************/
+
+/* Value from its difference with the previous one */
+inline SInt64 ApplyTrajectoryDelta(UInt32 un_column,
+                                   SInt64 n_delta,
+                                   SInt64 n_previous) {
+   SInt64 nValue = n_previous + n_delta;
+   if(un_column == TRAJECTORY_YAW) {
+      nValue &= TRAJECTORY_YAW_STEPS - 1;
+   }
+   return nValue;
+}
+
+/****************************************/
+/****************************************/
+
+/* Appends a signed value as a zigzag varint, returns the new end */
+inline UInt8* PutTrajectoryVarint(UInt8* pun_out,
+                                  SInt64 n_value) {
+   UInt64 unValue = (static_cast<UInt64>(n_value) << 1) ^ static_cast<UInt64>(n_value >> 63);
+   while(unValue >= 0x80) {
+      *pun_out++ = static_cast<UInt8>(unValue) | 0x80;
+      unValue >>= 7;
+   }
+   *pun_out++ = static_cast<UInt8>(unValue);
+   return pun_out;
+}
+
+/****************************************/
+/****************************************/
+
+/* Reads a zigzag varint, returns the new start or NULL past pun_end */
+inline const UInt8* GetTrajectoryVarint(const UInt8* pun_in,
+                                        const UInt8* pun_end,
+                                        SInt64& n_value) {
+   UInt64 unValue = 0;
+   for(UInt32 unShift = 0; pun_in < pun_end && unShift < 64; unShift += 7) {
+      UInt8 unByte = *pun_in++;
+      unValue |= static_cast<UInt64>(unByte & 0x7F) << unShift;
+      if((unByte & 0x80) == 0) {
+         n_value = static_cast<SInt64>(unValue >> 1) ^ -static_cast<SInt64>(unValue & 1);
+         return pun_in;
+      }
+   }
+   return NULL;
+}
+
+#endif
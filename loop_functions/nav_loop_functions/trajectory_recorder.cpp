@@ -0,0 +1,167 @@
+#include "trajectory_recorder.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+/* Size of the write buffer */
+static const size_t BUFFER_SIZE = 1 << 20;
+
+/* Longest varint */
+static const size_t MAX_VARINT_SIZE = 10;
+
+/****************************************/
+/****************************************/
+
+CTrajectoryRecorder::CTrajectoryRecorder() :
+   m_pcFile(NULL),
+   m_unRobots(0),
+   m_unKeyframeInterval(DEFAULT_KEYFRAME_INTERVAL),
+   m_unUsed(0),
+   m_unWritten(0) {}
+
+/****************************************/
+/****************************************/
+
+CTrajectoryRecorder::~CTrajectoryRecorder() {
+   if(m_pcFile != NULL) {
+      /* Don't throw from a destructor; without its index, the file is read by walking the frames */
+      std::fwrite(&m_vecBuffer[0], 1, m_unUsed, m_pcFile);
+      std::fclose(m_pcFile);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryRecorder::Open(const std::string& str_path,
+                               const std::vector<std::string>& vec_ids,
+                               const std::vector<UInt32>& vec_roles,
+                               UInt8 un_target,
+                               UInt32 un_keyframe_interval) {
+   Close();
+   if(vec_ids.size() != vec_roles.size()) {
+      THROW_ARGOSEXCEPTION("Trajectory of " << vec_ids.size() << " robots given " << vec_roles.size() << " roles");
+   }
+   if(un_keyframe_interval == 0) {
+      THROW_ARGOSEXCEPTION("The keyframe interval of a trajectory must be at least 1");
+   }
+   m_pcFile = std::fopen(str_path.c_str(), "wb");
+   if(m_pcFile == NULL) {
+      THROW_ARGOSEXCEPTION("Cannot open trajectory file \"" << str_path << "\": " << ::strerror(errno));
+   }
+   m_strPath = str_path;
+   m_unRobots = vec_ids.size();
+   m_unKeyframeInterval = un_keyframe_interval;
+   m_vecPrevious.assign(static_cast<size_t>(TRAJECTORY_COLUMNS) * m_unRobots, 0);
+   m_vecIndex.clear();
+   /* Room for the largest frame, so that a frame never straddles two writes */
+   size_t unMaxFrame = (2 + TRAJECTORY_COLUMNS) * sizeof(UInt32) + m_vecPrevious.size() * MAX_VARINT_SIZE;
+   m_vecBuffer.resize(std::max(BUFFER_SIZE, 2 * unMaxFrame));
+   m_unUsed = 0;
+   m_unWritten = 0;
+   /* Header */
+   UInt32 punHeader[] = {
+      TRAJECTORY_COLUMNS,
+      m_unRobots,
+      m_unKeyframeInterval,
+      un_target
+   };
+   Append(TRAJECTORY_MAGIC, 8);
+   Append(punHeader, sizeof(punHeader));
+   for(size_t i = 0; i < vec_ids.size(); ++i) {
+      if(m_vecBuffer.size() - m_unUsed < 2 * sizeof(UInt32) + vec_ids[i].size()) {
+         Flush();
+      }
+      UInt32 punRobot[] = { vec_roles[i], static_cast<UInt32>(vec_ids[i].size()) };
+      Append(punRobot, sizeof(punRobot));
+      Append(vec_ids[i].data(), vec_ids[i].size());
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryRecorder::Close() {
+   if(m_pcFile == NULL) return;
+   Flush();
+   /* Index and footer */
+   UInt64 punFooter[] = { m_unWritten, m_vecIndex.size() };
+   for(size_t i = 0; i < m_vecIndex.size(); ++i) {
+      if(m_vecBuffer.size() - m_unUsed < sizeof(UInt32) + sizeof(UInt64)) {
+         Flush();
+      }
+      Append(&m_vecIndex[i].Tick, sizeof(UInt32));
+      Append(&m_vecIndex[i].Offset, sizeof(UInt64));
+   }
+   Flush();
+   Append(punFooter, sizeof(punFooter));
+   Append(TRAJECTORY_END_MAGIC, 8);
+   Flush();
+   bool bOk = (std::fclose(m_pcFile) == 0);
+   m_pcFile = NULL;
+   if(!bOk) {
+      THROW_ARGOSEXCEPTION("Cannot write trajectory file \"" << m_strPath << "\": " << ::strerror(errno));
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryRecorder::Write(UInt32 un_tick,
+                                const Real* pf_values) {
+   size_t unMaxFrame = (2 + TRAJECTORY_COLUMNS) * sizeof(UInt32) + m_vecPrevious.size() * MAX_VARINT_SIZE;
+   if(m_vecBuffer.size() - m_unUsed < unMaxFrame) {
+      Flush();
+   }
+   SIndexEntry sEntry;
+   sEntry.Tick = un_tick;
+   sEntry.Offset = m_unWritten + m_unUsed;
+   /* Keyframes are taken against 0 */
+   bool bKeyframe = (m_vecIndex.size() % m_unKeyframeInterval) == 0;
+   m_vecIndex.push_back(sEntry);
+   UInt8* punFrame = &m_vecBuffer[m_unUsed];
+   UInt8* punValues = punFrame + (2 + TRAJECTORY_COLUMNS) * sizeof(UInt32);
+   UInt8* punOut = punValues;
+   UInt32 punEnds[TRAJECTORY_COLUMNS];
+   for(UInt32 c = 0; c < TRAJECTORY_COLUMNS; ++c) {
+      SInt64* pnPrevious = &m_vecPrevious[static_cast<size_t>(c) * m_unRobots];
+      const Real* pfColumn = pf_values + static_cast<size_t>(c) * m_unRobots;
+      for(UInt32 r = 0; r < m_unRobots; ++r) {
+         SInt64 nValue = QuantiseTrajectory(c, pfColumn[r]);
+         punOut = PutTrajectoryVarint(punOut,
+                                      GetTrajectoryDelta(c, nValue, bKeyframe ? 0 : pnPrevious[r]));
+         pnPrevious[r] = nValue;
+      }
+      punEnds[c] = punOut - punValues;
+   }
+   UInt32 punFrameHeader[2] = { un_tick, static_cast<UInt32>(punOut - punValues) };
+   /* The buffer has no alignment guarantee */
+   std::memcpy(punFrame, punFrameHeader, sizeof(punFrameHeader));
+   std::memcpy(punFrame + sizeof(punFrameHeader), punEnds, sizeof(punEnds));
+   m_unUsed = punOut - &m_vecBuffer[0];
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryRecorder::Flush() {
+   if(m_unUsed == 0) return;
+   size_t unSize = m_unUsed;
+   m_unUsed = 0;
+   m_unWritten += unSize;
+   if(std::fwrite(&m_vecBuffer[0], 1, unSize, m_pcFile) != unSize) {
+      THROW_ARGOSEXCEPTION("Cannot write trajectory file \"" << m_strPath << "\": " << ::strerror(errno));
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryRecorder::Append(const void* pv_data,
+                                 size_t un_size) {
+   std::memcpy(&m_vecBuffer[m_unUsed], pv_data, un_size);
+   m_unUsed += un_size;
+}
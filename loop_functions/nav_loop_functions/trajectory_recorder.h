@@ -0,0 +1,99 @@
+/*
+ * Writer of the trajectories of the robots: pose, wheel speeds and nav
+ * state of every robot on every tick, in the compact format described in
+ * trajectory_format.h.
+ *
+ * The values of a tick are quantised and delta-encoded against the
+ * previous tick into a large buffer that goes to the file in one write
+ * when full. The index of the frames is kept in memory and written when
+ * the recorder is closed, so that CTrajectoryReader can map the file and
+ * jump to any tick without decoding the others.
+ */
+
+#ifndef TRAJECTORY_RECORDER_H
+#define TRAJECTORY_RECORDER_H
+
+#include "trajectory_format.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CTrajectoryRecorder {
+
+public:
+
+   /* Frames between two keyframes, by default */
+   static const UInt32 DEFAULT_KEYFRAME_INTERVAL = 64;
+
+public:
+
+   CTrajectoryRecorder();
+
+   ~CTrajectoryRecorder();
+
+   /*
+    * Creates the file and writes its header: the robots, in the order
+    * their values are given to Write(), with their role, the target whose
+    * table distance is recorded, and the frames between two keyframes.
+    */
+   void Open(const std::string& str_path,
+             const std::vector<std::string>& vec_ids,
+             const std::vector<UInt32>& vec_roles,
+             UInt8 un_target,
+             UInt32 un_keyframe_interval = DEFAULT_KEYFRAME_INTERVAL);
+
+   /* Writes the buffered frames, the index and the footer, and closes the file */
+   void Close();
+
+   inline bool IsOpen() const {
+      return m_pcFile != NULL;
+   }
+
+   /*
+    * Appends the frame of a tick. pf_values holds the values column by
+    * column (see ETrajectoryColumn): value r of column c is at
+    * c * robots + r.
+    */
+   void Write(UInt32 un_tick,
+              const Real* pf_values);
+
+   /* Returns the number of frames written so far */
+   inline UInt64 GetFrames() const {
+      return m_vecIndex.size();
+   }
+
+private:
+
+   /* Writes the buffer to the file */
+   void Flush();
+
+   /* Appends raw bytes to the buffer */
+   void Append(const void* pv_data,
+               size_t un_size);
+
+private:
+
+   /* Start of a frame, for the index */
+   struct SIndexEntry {
+      UInt32 Tick;
+      UInt64 Offset;
+   };
+
+   std::FILE* m_pcFile;
+   std::string m_strPath;
+   UInt32 m_unRobots;
+   UInt32 m_unKeyframeInterval;
+   /* Quantised values of the last frame */
+   std::vector<SInt64> m_vecPrevious;
+   std::vector<SIndexEntry> m_vecIndex;
+   std::vector<UInt8> m_vecBuffer;
+   size_t m_unUsed;
+   /* Bytes written to the file, i.e. offset of the buffer in the file */
+   UInt64 m_unWritten;
+
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Decodes a trace file written by the nav_loop_functions (see
+ * loop_functions/nav_loop_functions/nav_loop_functions.h) into CSV:
+ *
+ *    robot,tick,event,target,value0,value1
+ *
+ * The events of a robot come in order, but those of different robots
+ * are interleaved by chunk; sort by tick if needed, e.g. with
+ * sort -t, -k2,2n -s. Events lost because a ring was full are reported
+ * on the standard error.
+ * Usage: nav_trace_decode trace.bin [robot id]
+ */
+
+#include <controllers/nav_common/nav_trace.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/****************************************/
+/****************************************/
+
+static bool ReadUInt32(std::FILE* pc_file,
+                       UInt32& un_value) {
+   return std::fread(&un_value, sizeof(un_value), 1, pc_file) == 1;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   if(argc < 2) {
+      std::fprintf(stderr, "Usage: %s trace.bin [robot id]\n", argv[0]);
+      return 1;
+   }
+   std::FILE* pcFile = std::fopen(argv[1], "rb");
+   if(pcFile == NULL) {
+      std::fprintf(stderr, "Cannot open \"%s\": %s\n", argv[1], std::strerror(errno));
+      return 1;
+   }
+   /* Header: magic, robots and their ids */
+   char pchMagic[8];
+   UInt32 unRobots = 0;
+   if(std::fread(pchMagic, 8, 1, pcFile) != 1 ||
+      std::memcmp(pchMagic, "NAVTRAC1", 8) != 0 ||
+      !ReadUInt32(pcFile, unRobots)) {
+      std::fprintf(stderr, "\"%s\" is not a trace file\n", argv[1]);
+      return 1;
+   }
+   std::vector<std::string> vecIds(unRobots);
+   for(UInt32 i = 0; i < unRobots; ++i) {
+      UInt32 unLength = 0;
+      if(!ReadUInt32(pcFile, unLength) || unLength > 4096) {
+         std::fprintf(stderr, "Truncated header in \"%s\"\n", argv[1]);
+         return 1;
+      }
+      vecIds[i].resize(unLength);
+      if(unLength > 0 && std::fread(&vecIds[i][0], unLength, 1, pcFile) != 1) {
+         std::fprintf(stderr, "Truncated header in \"%s\"\n", argv[1]);
+         return 1;
+      }
+   }
+   std::string strFilter = (argc > 2) ? argv[2] : "";
+   /* Chunks: robot, events lost, event count, events */
+   std::printf("robot,tick,event,target,value0,value1\n");
+   std::vector<SNavTraceEvent> vecEvents;
+   UInt32 punChunk[3];
+   while(std::fread(punChunk, sizeof(punChunk), 1, pcFile) == 1) {
+      if(punChunk[0] >= unRobots) {
+         std::fprintf(stderr, "Chunk of unknown robot %u, giving up\n", punChunk[0]);
+         return 1;
+      }
+      vecEvents.resize(punChunk[2]);
+      if(punChunk[2] > 0 &&
+         std::fread(&vecEvents[0], sizeof(SNavTraceEvent), punChunk[2], pcFile) != punChunk[2]) {
+         std::fprintf(stderr, "Truncated chunk of robot %s\n", vecIds[punChunk[0]].c_str());
+         return 1;
+      }
+      const std::string& strId = vecIds[punChunk[0]];
+      if(!strFilter.empty() && strId != strFilter) continue;
+      if(punChunk[1] > 0) {
+         std::fprintf(stderr, "Robot %s: %u events lost before tick %u, increase trace_capacity\n",
+                      strId.c_str(), punChunk[1], vecEvents.empty() ? 0 : vecEvents[0].Tick);
+      }
+      for(size_t i = 0; i < vecEvents.size(); ++i) {
+         const SNavTraceEvent& sEvent = vecEvents[i];
+         std::printf("%s,%u,%s,%u,%g,%g\n",
+                     strId.c_str(),
+                     sEvent.Tick,
+                     CNavTrace::GetEventName(sEvent.Type),
+                     sEvent.Target,
+                     sEvent.Values[0],
+                     sEvent.Values[1]);
+      }
+   }
+   std::fclose(pcFile);
+   return 0;
+}
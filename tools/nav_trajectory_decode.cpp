@@ -0,0 +1,89 @@
+/*
+ * Decodes a trajectory file written by the nav_loop_functions (see
+ * loop_functions/nav_loop_functions/trajectory_format.h) into CSV:
+ *
+ *    robot,role,tick,x,y,yaw,left_wheel,right_wheel,best_nav_dist,
+ *    best_nav_heading,distance_star,target_distance
+ *
+ * one row per robot and recorded tick, in tick order. Only the frames
+ * between the first and last tick are decoded, starting from the
+ * keyframe before the first one, so looking at the end of a long run
+ * costs no more than looking at its start. target_distance is empty when
+ * the robot has no entry for the target (given in a comment line at the
+ * top). Give an empty robot id to print all the robots of a range of
+ * ticks.
+ * Usage: nav_trajectory_decode trajectory.bin [robot id] [first tick] [last tick]
+ */
+
+#include "trajectory_reader.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   if(argc < 2) {
+      std::fprintf(stderr, "Usage: %s trajectory.bin [robot id] [first tick] [last tick]\n", argv[0]);
+      return 1;
+   }
+   try {
+      CTrajectoryReader cReader;
+      cReader.Open(argv[1]);
+      if(cReader.IsTruncated()) {
+         std::fprintf(stderr, "\"%s\" has no index, the run did not end cleanly; read %zu frames\n",
+                      argv[1], cReader.GetFrames());
+      }
+      /* Robots to print, all by default */
+      UInt32 unFirstRobot = 0, unLastRobot = cReader.GetRobots();
+      if(argc > 2 && argv[2][0] != '\0') {
+         unFirstRobot = cReader.FindRobot(argv[2]);
+         if(unFirstRobot == cReader.GetRobots()) {
+            std::fprintf(stderr, "No robot \"%s\" in \"%s\"\n", argv[2], argv[1]);
+            return 1;
+         }
+         unLastRobot = unFirstRobot + 1;
+      }
+      UInt32 unFirstTick = (argc > 3) ? std::strtoul(argv[3], NULL, 10) : 0;
+      UInt32 unLastTick = (argc > 4) ? std::strtoul(argv[4], NULL, 10) : 0xFFFFFFFF;
+      std::printf("# target %u\n", cReader.GetTarget());
+      std::printf("robot,role,tick");
+      for(UInt32 c = 0; c < TRAJECTORY_COLUMNS; ++c) {
+         std::printf(",%s", GetTrajectoryColumnName(c));
+      }
+      std::printf("\n");
+      UInt32 unRobots = cReader.GetRobots();
+      std::vector<Real> vecValues(static_cast<size_t>(TRAJECTORY_COLUMNS) * unRobots);
+      for(size_t i = cReader.FindFrame(unFirstTick);
+          i < cReader.GetFrames() && cReader.GetTick(i) <= unLastTick;
+          ++i) {
+         cReader.ReadFrame(i, &vecValues[0]);
+         for(UInt32 r = unFirstRobot; r < unLastRobot; ++r) {
+            std::printf("%s,%u,%u",
+                        cReader.GetRobotId(r).c_str(),
+                        cReader.GetRobotRole(r),
+                        cReader.GetTick(i));
+            for(UInt32 c = 0; c < TRAJECTORY_COLUMNS; ++c) {
+               Real fValue = vecValues[static_cast<size_t>(c) * unRobots + r];
+               if(std::isnan(fValue)) {
+                  std::printf(",");
+               }
+               else {
+                  std::printf(",%g", fValue);
+               }
+            }
+            std::printf("\n");
+         }
+      }
+   }
+   catch(CARGoSException& ex) {
+      std::fprintf(stderr, "%s\n", ex.what());
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,287 @@
+#include "trajectory_reader.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Size of the header of a frame: tick, size and column ends */
+static const UInt64 FRAME_HEADER_SIZE = (2 + TRAJECTORY_COLUMNS) * sizeof(UInt32);
+
+/* Size of an entry of the index: tick and offset */
+static const UInt64 INDEX_ENTRY_SIZE = sizeof(UInt32) + sizeof(UInt64);
+
+/* Longest robot id accepted, to catch files that are not trajectories */
+static const UInt32 MAX_ID_LENGTH = 4096;
+
+/****************************************/
+/****************************************/
+
+CTrajectoryReader::CTrajectoryReader() :
+   m_punData(NULL),
+   m_unSize(0),
+   m_unKeyframeInterval(1),
+   m_unTarget(0),
+   m_bTruncated(false) {}
+
+/****************************************/
+/****************************************/
+
+CTrajectoryReader::~CTrajectoryReader() {
+   Close();
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryReader::Open(const std::string& str_path) {
+   Close();
+   m_strPath = str_path;
+   int nFile = ::open(str_path.c_str(), O_RDONLY);
+   if(nFile < 0) {
+      THROW_ARGOSEXCEPTION("Cannot open trajectory file \"" << str_path << "\": " << ::strerror(errno));
+   }
+   struct stat sStat;
+   if(::fstat(nFile, &sStat) != 0) {
+      int nError = errno;
+      ::close(nFile);
+      THROW_ARGOSEXCEPTION("Cannot read trajectory file \"" << str_path << "\": " << ::strerror(nError));
+   }
+   m_unSize = sStat.st_size;
+   if(m_unSize < 8 + 4 * sizeof(UInt32)) {
+      ::close(nFile);
+      THROW_ARGOSEXCEPTION("\"" << str_path << "\" is not a trajectory file");
+   }
+   /* The mapping outlives the descriptor */
+   void* pvData = ::mmap(NULL, m_unSize, PROT_READ, MAP_PRIVATE, nFile, 0);
+   ::close(nFile);
+   if(pvData == MAP_FAILED) {
+      m_unSize = 0;
+      THROW_ARGOSEXCEPTION("Cannot map trajectory file \"" << str_path << "\": " << ::strerror(errno));
+   }
+   m_punData = static_cast<const UInt8*>(pvData);
+   /* Header */
+   if(std::memcmp(m_punData, TRAJECTORY_MAGIC, 8) != 0) {
+      Close();
+      THROW_ARGOSEXCEPTION("\"" << str_path << "\" is not a trajectory file");
+   }
+   UInt32 unColumns = ReadUInt32(8);
+   UInt32 unRobots = ReadUInt32(12);
+   m_unKeyframeInterval = ReadUInt32(16);
+   m_unTarget = ReadUInt32(20);
+   if(unColumns != TRAJECTORY_COLUMNS || m_unKeyframeInterval == 0) {
+      Close();
+      THROW_ARGOSEXCEPTION("Trajectory file \"" << str_path << "\" has " << unColumns
+                           << " columns and keyframes every " << m_unKeyframeInterval
+                           << " frames, expected " << static_cast<UInt32>(TRAJECTORY_COLUMNS) << " columns");
+   }
+   UInt64 unOffset = 24;
+   m_vecIds.resize(unRobots);
+   m_vecRoles.resize(unRobots);
+   for(UInt32 i = 0; i < unRobots; ++i) {
+      m_vecRoles[i] = ReadUInt32(unOffset);
+      UInt32 unLength = ReadUInt32(unOffset + 4);
+      unOffset += 8;
+      if(unLength > MAX_ID_LENGTH || unOffset + unLength > m_unSize) {
+         Close();
+         THROW_ARGOSEXCEPTION("Truncated header in trajectory file \"" << str_path << "\"");
+      }
+      m_vecIds[i].assign(reinterpret_cast<const char*>(m_punData + unOffset), unLength);
+      unOffset += unLength;
+   }
+   /* Index, if the recorder was closed */
+   m_vecFrames.clear();
+   m_bTruncated = true;
+   if(m_unSize >= unOffset + TRAJECTORY_FOOTER_SIZE &&
+      std::memcmp(m_punData + m_unSize - 8, TRAJECTORY_END_MAGIC, 8) == 0) {
+      UInt64 unIndex = ReadUInt64(m_unSize - TRAJECTORY_FOOTER_SIZE);
+      UInt64 unFrames = ReadUInt64(m_unSize - TRAJECTORY_FOOTER_SIZE + 8);
+      if(unIndex >= unOffset &&
+         unFrames <= m_unSize / INDEX_ENTRY_SIZE &&
+         unIndex + unFrames * INDEX_ENTRY_SIZE + TRAJECTORY_FOOTER_SIZE == m_unSize) {
+         m_vecFrames.resize(unFrames);
+         for(UInt64 i = 0; i < unFrames; ++i) {
+            m_vecFrames[i].Tick = ReadUInt32(unIndex + i * INDEX_ENTRY_SIZE);
+            m_vecFrames[i].Offset = ReadUInt64(unIndex + i * INDEX_ENTRY_SIZE + sizeof(UInt32));
+            if(m_vecFrames[i].Offset < unOffset ||
+               m_vecFrames[i].Offset + FRAME_HEADER_SIZE > unIndex) {
+               Close();
+               THROW_ARGOSEXCEPTION("Corrupted index in trajectory file \"" << str_path << "\"");
+            }
+         }
+         m_bTruncated = false;
+      }
+   }
+   if(m_bTruncated) {
+      ScanFrames(unOffset);
+   }
+   for(UInt32 i = 0; i < TRAJECTORY_COLUMNS; ++i) {
+      m_psCache[i].Frame = m_vecFrames.size();
+      m_psCache[i].Values.assign(unRobots, 0);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryReader::Close() {
+   if(m_punData != NULL) {
+      ::munmap(const_cast<UInt8*>(m_punData), m_unSize);
+   }
+   m_punData = NULL;
+   m_unSize = 0;
+   m_vecIds.clear();
+   m_vecRoles.clear();
+   m_vecFrames.clear();
+}
+
+/****************************************/
+/****************************************/
+
+UInt32 CTrajectoryReader::FindRobot(const std::string& str_id) const {
+   for(UInt32 i = 0; i < m_vecIds.size(); ++i) {
+      if(m_vecIds[i] == str_id) return i;
+   }
+   return m_vecIds.size();
+}
+
+/****************************************/
+/****************************************/
+
+size_t CTrajectoryReader::FindFrame(UInt32 un_tick) const {
+   size_t unLow = 0, unHigh = m_vecFrames.size();
+   while(unLow < unHigh) {
+      size_t unMiddle = unLow + (unHigh - unLow) / 2;
+      if(m_vecFrames[unMiddle].Tick < un_tick) {
+         unLow = unMiddle + 1;
+      }
+      else {
+         unHigh = unMiddle;
+      }
+   }
+   return unLow;
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryReader::ReadColumn(size_t un_frame,
+                                   UInt32 un_column,
+                                   Real* pf_values) {
+   if(un_frame >= m_vecFrames.size() || un_column >= TRAJECTORY_COLUMNS) {
+      THROW_ARGOSEXCEPTION("Trajectory file \"" << m_strPath << "\" has no column " << un_column
+                           << " in frame " << un_frame << " of " << m_vecFrames.size());
+   }
+   if(m_vecIds.empty()) return;
+   SColumnCache& sCache = m_psCache[un_column];
+   size_t unKeyframe = un_frame - un_frame % m_unKeyframeInterval;
+   /* Go on from the last frame decoded if it is on the way, from the keyframe otherwise */
+   size_t unFirst = unKeyframe;
+   if(sCache.Frame < m_vecFrames.size() &&
+      sCache.Frame >= unKeyframe &&
+      sCache.Frame <= un_frame) {
+      unFirst = sCache.Frame + 1;
+   }
+   for(size_t i = unFirst; i <= un_frame; ++i) {
+      /* Mark the cache stale first, in case the frame is corrupted */
+      sCache.Frame = m_vecFrames.size();
+      DecodeColumn(i, un_column, &sCache.Values[0]);
+      sCache.Frame = i;
+   }
+   for(UInt32 r = 0; r < m_vecIds.size(); ++r) {
+      pf_values[r] = DequantiseTrajectory(un_column, sCache.Values[r]);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryReader::ReadFrame(size_t un_frame,
+                                  Real* pf_values) {
+   for(UInt32 c = 0; c < TRAJECTORY_COLUMNS; ++c) {
+      ReadColumn(un_frame, c, pf_values + static_cast<size_t>(c) * m_vecIds.size());
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryReader::ScanFrames(UInt64 un_offset) {
+   while(un_offset + FRAME_HEADER_SIZE <= m_unSize) {
+      UInt32 unSize = ReadUInt32(un_offset + 4);
+      if(un_offset + FRAME_HEADER_SIZE + unSize > m_unSize) break;
+      /* The column ends go up to the size of the values, or this is not a frame */
+      UInt32 unLast = 0;
+      bool bFrame = true;
+      for(UInt32 c = 0; c < TRAJECTORY_COLUMNS && bFrame; ++c) {
+         UInt32 unEnd = ReadUInt32(un_offset + 8 + c * sizeof(UInt32));
+         bFrame = (unEnd >= unLast && unEnd <= unSize);
+         unLast = unEnd;
+      }
+      if(!bFrame || unLast != unSize) break;
+      SFrame sFrame;
+      sFrame.Tick = ReadUInt32(un_offset);
+      sFrame.Offset = un_offset;
+      m_vecFrames.push_back(sFrame);
+      un_offset += FRAME_HEADER_SIZE + unSize;
+   }
+}
+
+/****************************************/
+/****************************************/
+
+void CTrajectoryReader::DecodeColumn(size_t un_frame,
+                                     UInt32 un_column,
+                                     SInt64* pn_values) const {
+   UInt64 unOffset = m_vecFrames[un_frame].Offset;
+   UInt32 unSize = ReadUInt32(unOffset + 4);
+   UInt32 unBegin = (un_column == 0) ? 0 : ReadUInt32(unOffset + 8 + (un_column - 1) * sizeof(UInt32));
+   UInt32 unEnd = ReadUInt32(unOffset + 8 + un_column * sizeof(UInt32));
+   if(unBegin > unEnd || unEnd > unSize ||
+      unOffset + FRAME_HEADER_SIZE + unSize > m_unSize) {
+      THROW_ARGOSEXCEPTION("Corrupted frame " << un_frame << " in trajectory file \"" << m_strPath << "\"");
+   }
+   const UInt8* punIn = m_punData + unOffset + FRAME_HEADER_SIZE + unBegin;
+   const UInt8* punEnd = m_punData + unOffset + FRAME_HEADER_SIZE + unEnd;
+   bool bKeyframe = (un_frame % m_unKeyframeInterval) == 0;
+   for(UInt32 r = 0; r < m_vecIds.size(); ++r) {
+      SInt64 nDelta;
+      punIn = GetTrajectoryVarint(punIn, punEnd, nDelta);
+      if(punIn == NULL) {
+         THROW_ARGOSEXCEPTION("Corrupted frame " << un_frame << " in trajectory file \"" << m_strPath << "\"");
+      }
+      pn_values[r] = ApplyTrajectoryDelta(un_column, nDelta, bKeyframe ? 0 : pn_values[r]);
+   }
+   if(punIn != punEnd) {
+      THROW_ARGOSEXCEPTION("Corrupted frame " << un_frame << " in trajectory file \"" << m_strPath << "\"");
+   }
+}
+
+/****************************************/
+/****************************************/
+
+UInt32 CTrajectoryReader::ReadUInt32(UInt64 un_offset) const {
+   if(un_offset + sizeof(UInt32) > m_unSize) {
+      THROW_ARGOSEXCEPTION("Truncated trajectory file \"" << m_strPath << "\"");
+   }
+   UInt32 unValue;
+   std::memcpy(&unValue, m_punData + un_offset, sizeof(unValue));
+   return unValue;
+}
+
+/****************************************/
+/****************************************/
+
+UInt64 CTrajectoryReader::ReadUInt64(UInt64 un_offset) const {
+   if(un_offset + sizeof(UInt64) > m_unSize) {
+      THROW_ARGOSEXCEPTION("Truncated trajectory file \"" << m_strPath << "\"");
+   }
+   UInt64 unValue;
+   std::memcpy(&unValue, m_punData + un_offset, sizeof(unValue));
+   return unValue;
+}
@@ -0,0 +1,139 @@
+/*
+ * Reader of the trajectory files written by the nav_loop_functions (see
+ * loop_functions/nav_loop_functions/trajectory_format.h).
+ *
+ * The file is mapped in memory rather than read, so that opening it costs
+ * the header and the index only, whatever the length of the run, and the
+ * pages of the frames that are never looked at are never loaded. Any
+ * frame can be read: it is decoded from the keyframe before it, one
+ * column at a time. The last frame decoded of every column is kept, so
+ * reading the frames in order decodes each of them once.
+ *
+ *    CTrajectoryReader cReader;
+ *    cReader.Open("nav_trajectory.bin");
+ *    std::vector<Real> vecX(cReader.GetRobots());
+ *    for(size_t i = 0; i < cReader.GetFrames(); ++i) {
+ *       cReader.ReadColumn(i, TRAJECTORY_X, &vecX[0]);
+ *       ...
+ *    }
+ *
+ * Errors in the file throw a CARGoSException.
+ */
+
+#ifndef TRAJECTORY_READER_H
+#define TRAJECTORY_READER_H
+
+#include <loop_functions/nav_loop_functions/trajectory_format.h>
+
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CTrajectoryReader {
+
+public:
+
+   CTrajectoryReader();
+
+   ~CTrajectoryReader();
+
+   /* Maps a file and reads its header and index */
+   void Open(const std::string& str_path);
+
+   /* Unmaps the file */
+   void Close();
+
+   inline UInt32 GetRobots() const {
+      return m_vecIds.size();
+   }
+
+   inline const std::string& GetRobotId(UInt32 un_robot) const {
+      return m_vecIds[un_robot];
+   }
+
+   /* Returns the role of a robot (see CNavController::ERole) */
+   inline UInt32 GetRobotRole(UInt32 un_robot) const {
+      return m_vecRoles[un_robot];
+   }
+
+   /* Returns the index of the robot with the given id, or GetRobots() if there is none */
+   UInt32 FindRobot(const std::string& str_id) const;
+
+   /* Returns the target whose table distance is recorded */
+   inline UInt32 GetTarget() const {
+      return m_unTarget;
+   }
+
+   inline size_t GetFrames() const {
+      return m_vecFrames.size();
+   }
+
+   inline UInt32 GetTick(size_t un_frame) const {
+      return m_vecFrames[un_frame].Tick;
+   }
+
+   /* Returns the first frame at or after a tick, or GetFrames() if there is none */
+   size_t FindFrame(UInt32 un_tick) const;
+
+   /* Returns true if the file had no index, e.g. because the run crashed */
+   inline bool IsTruncated() const {
+      return m_bTruncated;
+   }
+
+   /* Decodes a column of a frame into pf_values, one value per robot */
+   void ReadColumn(size_t un_frame,
+                   UInt32 un_column,
+                   Real* pf_values);
+
+   /*
+    * Decodes all the columns of a frame into pf_values, column by column:
+    * value r of column c is at c * GetRobots() + r.
+    */
+   void ReadFrame(size_t un_frame,
+                  Real* pf_values);
+
+private:
+
+   struct SFrame {
+      UInt32 Tick;
+      /* Offset of the frame in the file */
+      UInt64 Offset;
+   };
+
+   /* Last frame decoded of a column */
+   struct SColumnCache {
+      /* Frame, or GetFrames() if none */
+      size_t Frame;
+      std::vector<SInt64> Values;
+   };
+
+   /* Finds the frames by walking them, for files without an index */
+   void ScanFrames(UInt64 un_offset);
+
+   /* Decodes a column of a frame on top of the values of the previous frame */
+   void DecodeColumn(size_t un_frame,
+                     UInt32 un_column,
+                     SInt64* pn_values) const;
+
+   /* Reads a 32 bit integer at an offset, checking the bounds */
+   UInt32 ReadUInt32(UInt64 un_offset) const;
+
+   UInt64 ReadUInt64(UInt64 un_offset) const;
+
+private:
+
+   std::string m_strPath;
+   const UInt8* m_punData;
+   UInt64 m_unSize;
+   UInt32 m_unKeyframeInterval;
+   UInt32 m_unTarget;
+   std::vector<std::string> m_vecIds;
+   std::vector<UInt32> m_vecRoles;
+   std::vector<SFrame> m_vecFrames;
+   bool m_bTruncated;
+   SColumnCache m_psCache[TRAJECTORY_COLUMNS];
+
+};
+
+#endif